@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project. For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+
+#include <Source/Components/BoneIndexCache.h>
+#include <AzCore/Console/IConsole.h>
+#include <AzCore/Console/ILogger.h>
+#include <AzCore/Interface/Interface.h>
+#include <Integration/ActorComponentBus.h>
+
+namespace MultiplayerSample
+{
+    BoneIndexCache::BoneIndexCache()
+    {
+        AZ::Interface<BoneIndexCache>::Register(this);
+    }
+
+    BoneIndexCache::~BoneIndexCache()
+    {
+        AZ::Interface<BoneIndexCache>::Unregister(this);
+    }
+
+    void BoneIndexCache::AddActorReference(const EMotionFX::Actor* actor)
+    {
+        if (ActorBones* actorBones = FindActorBones(actor))
+        {
+            ++actorBones->m_referenceCount;
+            return;
+        }
+
+        ActorBones& actorBones = m_actorBones.emplace_back();
+        actorBones.m_actor = actor;
+        actorBones.m_referenceCount = 1;
+    }
+
+    void BoneIndexCache::RemoveActorReference(const EMotionFX::Actor* actor)
+    {
+        for (size_t actorIndex = 0; actorIndex < m_actorBones.size(); ++actorIndex)
+        {
+            if (m_actorBones[actorIndex].m_actor == actor)
+            {
+                if (--m_actorBones[actorIndex].m_referenceCount == 0)
+                {
+                    // The actor may be freed or reloaded once its last instance is gone, so the pointer can no longer be trusted
+                    m_actorBones[actorIndex] = AZStd::move(m_actorBones.back());
+                    m_actorBones.pop_back();
+                }
+                return;
+            }
+        }
+
+        AZ_Assert(false, "Removing a reference to an actor that was never added to the bone index cache");
+    }
+
+    int32_t BoneIndexCache::GetJointIndex(const EMotionFX::Actor* actor, AZStd::string_view boneName, EMotionFX::Integration::ActorComponentRequests& actorRequests)
+    {
+        ActorBones* actorBones = FindActorBones(actor);
+        AZ_Assert(actorBones != nullptr, "Actor must be referenced before looking up its bones");
+
+        const AZ::Crc32 boneNameCrc(boneName);
+        if (actorBones != nullptr)
+        {
+            for (size_t boneIndex = 0; boneIndex < actorBones->m_boneNames.size(); ++boneIndex)
+            {
+                if (actorBones->m_boneNames[boneIndex] == boneNameCrc)
+                {
+#if MPS_DIAGNOSTICS
+                    ++m_stats.m_cachedLookupCount;
+#endif
+                    return actorBones->m_jointIndices[boneIndex];
+                }
+            }
+        }
+
+#if MPS_DIAGNOSTICS
+        ++m_stats.m_nameLookupCount;
+#endif
+        // EMotionFX returns InvalidIndex for unknown joints, which maps to InvalidBoneId
+        const int32_t jointIndex = static_cast<int32_t>(actorRequests.GetJointIndexByName(AZStd::string(boneName).c_str()));
+
+        if (actorBones != nullptr)
+        {
+            actorBones->m_boneNames.push_back(boneNameCrc);
+            actorBones->m_jointIndices.push_back(jointIndex);
+        }
+        return jointIndex;
+    }
+
+    uint32_t BoneIndexCache::GetActorCount() const
+    {
+        return aznumeric_cast<uint32_t>(m_actorBones.size());
+    }
+
+#if MPS_DIAGNOSTICS
+    const BoneIndexCache::Stats& BoneIndexCache::GetStats() const
+    {
+        return m_stats;
+    }
+#endif
+
+    BoneIndexCache::ActorBones* BoneIndexCache::FindActorBones(const EMotionFX::Actor* actor)
+    {
+        for (ActorBones& actorBones : m_actorBones)
+        {
+            if (actorBones.m_actor == actor)
+            {
+                return &actorBones;
+            }
+        }
+        return nullptr;
+    }
+
+    BoneIndexCache* GetBoneIndexCache()
+    {
+        return AZ::Interface<BoneIndexCache>::Get();
+    }
+
+#if MPS_DIAGNOSTICS
+    static void bg_BoneIndexCacheStats([[maybe_unused]] const AZ::ConsoleCommandContainer& arguments)
+    {
+        BoneIndexCache* boneIndexCache = GetBoneIndexCache();
+        if (boneIndexCache == nullptr)
+        {
+            AZLOG_WARN("bg_BoneIndexCacheStats requires an active bone index cache");
+            return;
+        }
+
+        const BoneIndexCache::Stats& stats = boneIndexCache->GetStats();
+        AZLOG_INFO("Bone index cache: %u actors cached, %llu bones resolved by name, %llu bones returned from the cache",
+            boneIndexCache->GetActorCount(),
+            aznumeric_cast<unsigned long long>(stats.m_nameLookupCount),
+            aznumeric_cast<unsigned long long>(stats.m_cachedLookupCount));
+    }
+    AZ_CONSOLEFREEFUNC(bg_BoneIndexCacheStats, AZ::ConsoleFunctorFlags::Null, "Logs the number of cached actors and how many bone lookups were resolved by name versus returned from the cache");
+#endif
+}
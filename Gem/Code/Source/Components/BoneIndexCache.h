@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project. For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+
+#pragma once
+
+#include <Source/MultiplayerSampleTypes.h>
+#include <AzCore/Math/Crc.h>
+#include <AzCore/RTTI/RTTI.h>
+#include <AzCore/std/containers/vector.h>
+#include <AzCore/std/string/string_view.h>
+
+namespace EMotionFX
+{
+    class Actor;
+    namespace Integration
+    {
+        class ActorComponentRequests;
+    }
+}
+
+namespace MultiplayerSample
+{
+    //! @class BoneIndexCache
+    //! @brief Caches the joint indices of named bones per actor asset.
+    //! Every instance of an actor shares the same skeleton, so a bone only has to be looked up by name once per actor.
+    //! Actors are reference counted by their live instances, reloading an actor asset destroys every instance of the old actor
+    //! which drops its cached indices before the new actor is created.
+    class BoneIndexCache
+    {
+    public:
+        AZ_RTTI(BoneIndexCache, "{B4E27D05-6A1C-4F93-8E0B-3D5A91C7F26E}");
+
+#if MPS_DIAGNOSTICS
+        //! Counters accumulated since the cache was created.
+        struct Stats
+        {
+            uint64_t m_nameLookupCount = 0; // Number of bones resolved by name
+            uint64_t m_cachedLookupCount = 0; // Number of bones returned from the cache
+        };
+#endif
+
+        BoneIndexCache();
+        virtual ~BoneIndexCache();
+
+        //! Adds a reference to an actor, called whenever an instance of the actor is created.
+        //! @param actor the actor an instance was created for
+        void AddActorReference(const EMotionFX::Actor* actor);
+
+        //! Removes a reference to an actor, cached joint indices are dropped once the last instance of the actor is destroyed.
+        //! @param actor the actor an instance was destroyed for
+        void RemoveActorReference(const EMotionFX::Actor* actor);
+
+        //! Returns the joint index of a bone, the bone is only looked up by name the first time it's requested for an actor.
+        //! @param actor         the actor to return the joint index for, must have been referenced through AddActorReference
+        //! @param boneName      the name of the bone
+        //! @param actorRequests actor requests for a live instance of the actor, used to resolve the bone name if it's not cached
+        //! @return the joint index of the bone, InvalidBoneId if the actor has no bone with that name
+        int32_t GetJointIndex(const EMotionFX::Actor* actor, AZStd::string_view boneName, EMotionFX::Integration::ActorComponentRequests& actorRequests);
+
+        //! Returns the number of actors with cached joint indices.
+        //! @return the number of cached actors
+        uint32_t GetActorCount() const;
+
+#if MPS_DIAGNOSTICS
+        //! Returns the counters accumulated since the cache was created.
+        //! @return the cache counters
+        const Stats& GetStats() const;
+#endif
+
+    private:
+        struct ActorBones
+        {
+            const EMotionFX::Actor* m_actor = nullptr;
+            uint32_t m_referenceCount = 0;
+            AZStd::vector<AZ::Crc32> m_boneNames; // m_boneNames[N] is the name of the bone at m_jointIndices[N]
+            AZStd::vector<int32_t> m_jointIndices;
+        };
+
+        ActorBones* FindActorBones(const EMotionFX::Actor* actor);
+
+        AZStd::vector<ActorBones> m_actorBones;
+#if MPS_DIAGNOSTICS
+        Stats m_stats;
+#endif
+    };
+
+    //! Returns the bone index cache if one is active.
+    //! @return the bone index cache, or nullptr if none is active
+    BoneIndexCache* GetBoneIndexCache();
+}
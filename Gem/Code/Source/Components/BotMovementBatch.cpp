@@ -0,0 +1,340 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project. For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+
+#include <Source/Components/BotMovementBatch.h>
+#include <Source/Weapons/SceneQuery.h>
+#include <AzCore/Component/Entity.h>
+#include <AzCore/Component/TransformBus.h>
+#include <AzCore/Console/IConsole.h>
+#include <AzCore/Console/ILogger.h>
+#include <AzCore/Interface/Interface.h>
+#include <AzCore/std/chrono/chrono.h>
+#include <AzFramework/Physics/CharacterBus.h>
+#include <AzFramework/Physics/PhysicsScene.h>
+#include <AzFramework/Physics/ShapeConfiguration.h>
+
+namespace MultiplayerSample
+{
+    AZ_CVAR(bool, sv_BotKinematicMovement, false, nullptr, AZ::ConsoleFunctorFlags::Null, "If true, AI bots spawned after this is set move kinematically over a cached ground grid instead of through their character controllers, kinematic bots only collide with static geometry");
+    AZ_CVAR(float, sv_BotGroundCellSize, 0.5f, nullptr, AZ::ConsoleFunctorFlags::Null, "The horizontal size in meters of a kinematic bot ground grid cell");
+    AZ_CVAR(float, sv_BotGroundProbeDistance, 4.0f, nullptr, AZ::ConsoleFunctorFlags::Null, "The distance in meters a kinematic bot ground grid cell raycasts down for ground");
+    AZ_CVAR(uint32_t, sv_BotGroundGridMaxCells, 262144, nullptr, AZ::ConsoleFunctorFlags::Null, "The number of cached kinematic bot ground cells after which the ground grid is cleared");
+
+    // Ground cells are also split vertically so stacked floors cache separately, the raycast for a cell starts at the top of its band
+    constexpr float GroundBandHeight = 0.5f;
+    constexpr float SweepSkinWidth = 0.01f; // Distance bots stop short of static geometry they are swept into
+    constexpr float MinSweepDistance = 0.0001f;
+
+    //! Packs the grid cell containing a position into a single key, 21 bits per horizontal axis and 22 bits for the vertical band.
+    static uint64_t GetGroundCellKey(const AZ::Vector3& position, float cellSize)
+    {
+        const int64_t cellX = static_cast<int64_t>(AZStd::floor(position.GetX() / cellSize)) + (1 << 20);
+        const int64_t cellY = static_cast<int64_t>(AZStd::floor(position.GetY() / cellSize)) + (1 << 20);
+        const int64_t cellZ = static_cast<int64_t>(AZStd::floor(position.GetZ() / GroundBandHeight)) + (1 << 21);
+        return ((static_cast<uint64_t>(cellX) & 0x1FFFFF) << 43)
+             | ((static_cast<uint64_t>(cellY) & 0x1FFFFF) << 22)
+             | (static_cast<uint64_t>(cellZ) & 0x3FFFFF);
+    }
+
+    uint32_t BotMovementBatch::MoveBuffers::GetMoveCount() const
+    {
+        return aznumeric_cast<uint32_t>(m_entities.size());
+    }
+
+    void BotMovementBatch::MoveBuffers::Clear()
+    {
+        m_entities.clear();
+        m_listeners.clear();
+        m_startPositions.clear();
+        m_displacements.clear();
+        m_radii.clear();
+        m_heights.clear();
+        m_stepHeights.clear();
+    }
+
+    BotMovementBatch::BotMovementBatch()
+    {
+        AZ::Interface<BotMovementBatch>::Register(this);
+        m_flushEvent.Enqueue(AZ::Time::ZeroTimeMs, true);
+    }
+
+    BotMovementBatch::~BotMovementBatch()
+    {
+        m_flushEvent.RemoveFromQueue();
+        AZ::Interface<BotMovementBatch>::Unregister(this);
+    }
+
+    void BotMovementBatch::EnqueueMove(AZ::Entity& entity, const AZ::Vector3& velocity, float deltaTime, float radius, float height, float stepHeight, BotMovementListener& listener)
+    {
+        m_pendingMoves.m_entities.push_back(&entity);
+        m_pendingMoves.m_listeners.push_back(&listener);
+        m_pendingMoves.m_startPositions.push_back(entity.GetTransform()->GetWorldTranslation());
+        m_pendingMoves.m_displacements.push_back(velocity * deltaTime);
+        m_pendingMoves.m_radii.push_back(radius);
+        m_pendingMoves.m_heights.push_back(height);
+        m_pendingMoves.m_stepHeights.push_back(stepHeight);
+    }
+
+    void BotMovementBatch::Cancel(const BotMovementListener& listener)
+    {
+        for (MoveBuffers* moves : { &m_pendingMoves, &m_executingMoves })
+        {
+            for (BotMovementListener*& moveListener : moves->m_listeners)
+            {
+                if (moveListener == &listener)
+                {
+                    moveListener = nullptr;
+                }
+            }
+        }
+    }
+
+    void BotMovementBatch::Flush()
+    {
+#if MPS_DIAGNOSTICS
+        ++m_tickCount;
+#endif
+        if (m_pendingMoves.GetMoveCount() == 0)
+        {
+            return;
+        }
+
+#if MPS_DIAGNOSTICS
+        const auto start = AZStd::chrono::steady_clock::now();
+#endif
+
+        // Listeners may enqueue new moves while being notified, those go to the next flush
+        AZStd::swap(m_pendingMoves, m_executingMoves);
+        MoveBuffers& moves = m_executingMoves;
+        const uint32_t moveCount = moves.GetMoveCount();
+
+        // Sweep every horizontally moving bot against static geometry in one batched query. The swept capsule is raised by the step
+        // height so bots walk up steps and slopes, which the ground grid then snaps them onto.
+        m_sweepRequests.clear();
+        m_sweepMoveIndices.clear();
+        for (uint32_t moveIndex = 0; moveIndex < moveCount; ++moveIndex)
+        {
+            AZ::Vector3 horizontal = moves.m_displacements[moveIndex];
+            horizontal.SetZ(0.0f);
+            const float distance = horizontal.GetLength();
+            if ((moves.m_listeners[moveIndex] == nullptr) || (distance < MinSweepDistance))
+            {
+                continue;
+            }
+
+            const uint32_t sweepIndex = aznumeric_cast<uint32_t>(m_sweepMoveIndices.size());
+            if (sweepIndex >= m_sweepRequestPool.size())
+            {
+                m_sweepRequestPool.push_back(AZStd::make_shared<AzPhysics::ShapeCastRequest>());
+                m_sweepRequestPool.back()->m_queryType = AzPhysics::SceneQuery::QueryType::Static;
+            }
+
+            const float radius = moves.m_radii[moveIndex];
+            const float stepHeight = moves.m_stepHeights[moveIndex];
+            const float sweepHeight = AZStd::max(moves.m_heights[moveIndex] - stepHeight, radius * 2.0f);
+
+            AzPhysics::ShapeCastRequest& request = *m_sweepRequestPool[sweepIndex];
+            auto* capsule = static_cast<Physics::CapsuleShapeConfiguration*>(request.m_shapeConfiguration.get());
+            if ((capsule == nullptr) || (capsule->m_radius != radius) || (capsule->m_height != sweepHeight))
+            {
+                request.m_shapeConfiguration = AZStd::make_shared<Physics::CapsuleShapeConfiguration>(sweepHeight, radius);
+            }
+            request.m_start = AZ::Transform::CreateTranslation(
+                moves.m_startPositions[moveIndex] + AZ::Vector3(0.0f, 0.0f, stepHeight + sweepHeight * 0.5f));
+            request.m_direction = horizontal / distance;
+            request.m_distance = distance + SweepSkinWidth;
+
+            m_sweepRequests.push_back(m_sweepRequestPool[sweepIndex]);
+            m_sweepMoveIndices.push_back(moveIndex);
+        }
+
+        auto* sceneInterface = AZ::Interface<AzPhysics::SceneInterface>::Get();
+        const AzPhysics::SceneHandle sceneHandle = SceneQuery::GetDefaultSceneHandle();
+        if (!m_sweepRequests.empty() && (sceneInterface != nullptr) && (sceneHandle != AzPhysics::InvalidSceneHandle))
+        {
+            const AzPhysics::SceneQueryHitsList sweepResults = sceneInterface->QuerySceneBatch(sceneHandle, m_sweepRequests);
+            for (uint32_t sweepIndex = 0; sweepIndex < sweepResults.size(); ++sweepIndex)
+            {
+                const AzPhysics::SceneQueryHits& result = sweepResults[sweepIndex];
+                if (result && result.m_hits[0].IsValid())
+                {
+                    // Blocked bots stop short of what they hit, the AI picks a new direction soon enough
+                    const AzPhysics::ShapeCastRequest& request = *m_sweepRequestPool[sweepIndex];
+                    const float allowedDistance = AZStd::max(result.m_hits[0].m_distance - SweepSkinWidth, 0.0f);
+                    AZ::Vector3& displacement = moves.m_displacements[m_sweepMoveIndices[sweepIndex]];
+                    const AZ::Vector3 clipped = request.m_direction * allowedDistance;
+                    displacement.Set(clipped.GetX(), clipped.GetY(), displacement.GetZ());
+                }
+            }
+        }
+
+        for (uint32_t moveIndex = 0; moveIndex < moveCount; ++moveIndex)
+        {
+            BotMovementListener* listener = moves.m_listeners[moveIndex];
+            if (listener == nullptr)
+            {
+                continue;
+            }
+
+            const float stepHeight = moves.m_stepHeights[moveIndex];
+            AZ::Vector3 position = moves.m_startPositions[moveIndex] + moves.m_displacements[moveIndex];
+
+            // Bots within a step of the ground land on it, whether stepping up, walking down a slope or falling onto it.
+            // The sample covers the whole vertical move so fast falling bots can't pass through the ground in a single tick.
+            bool onGround = false;
+            AZ::Vector3 groundPoint;
+            AZ::Vector3 groundNormal;
+            const float sampleTopZ = AZStd::max(moves.m_startPositions[moveIndex].GetZ(), position.GetZ()) + stepHeight;
+            const AZ::Vector3 samplePosition(position.GetX(), position.GetY(), sampleTopZ);
+            if (SampleGround(samplePosition, sampleTopZ - (position.GetZ() - stepHeight), groundPoint, groundNormal))
+            {
+                const bool movingUp = moves.m_displacements[moveIndex].GetZ() > 0.0f;
+                if (!movingUp || (position.GetZ() < groundPoint.GetZ()))
+                {
+                    position.SetZ(groundPoint.GetZ());
+                    onGround = true;
+                }
+            }
+
+            // The physics character doesn't follow the transform on its own, without this its capsule stays behind as an invisible
+            // blocker and hits land where the bot used to be rather than where it is drawn
+            AZ::Entity* entity = moves.m_entities[moveIndex];
+            entity->GetTransform()->SetWorldTranslation(position);
+            Physics::CharacterRequestBus::Event(entity->GetId(), &Physics::CharacterRequestBus::Events::SetBasePosition, position);
+            listener->OnBotMoveComplete(onGround);
+        }
+
+        moves.Clear();
+
+#if MPS_DIAGNOSTICS
+        m_flushUs += aznumeric_cast<float>(AZStd::chrono::duration_cast<AZStd::chrono::nanoseconds>(AZStd::chrono::steady_clock::now() - start).count()) / 1000.0f;
+#endif
+    }
+
+    bool BotMovementBatch::SampleGround(const AZ::Vector3& position, float maxDistance, AZ::Vector3& outGroundPoint, AZ::Vector3& outGroundNormal)
+    {
+        const BotGroundSample& sample = FindGroundSample(position);
+        if (!sample.m_hasGround || (sample.m_normal.GetZ() <= 0.0f))
+        {
+            return false;
+        }
+
+        // Extend the plane of the cell's hit to the position, the same way player movement extends its ground contact
+        const AZ::Vector3 offset = position - sample.m_point;
+        const float groundZ = sample.m_point.GetZ()
+            - (sample.m_normal.GetX() * offset.GetX() + sample.m_normal.GetY() * offset.GetY()) / sample.m_normal.GetZ();
+        if ((groundZ > position.GetZ()) || ((position.GetZ() - groundZ) > maxDistance))
+        {
+            return false;
+        }
+
+        outGroundPoint.Set(position.GetX(), position.GetY(), groundZ);
+        outGroundNormal = sample.m_normal;
+        return true;
+    }
+
+    const BotGroundSample& BotMovementBatch::FindGroundSample(const AZ::Vector3& position)
+    {
+        const float cellSize = AZStd::max(static_cast<float>(sv_BotGroundCellSize), 0.01f);
+        const uint64_t cellKey = GetGroundCellKey(position, cellSize);
+        if (auto iter = m_groundGrid.find(cellKey); iter != m_groundGrid.end())
+        {
+            return iter->second;
+        }
+
+        if (m_groundGrid.size() >= sv_BotGroundGridMaxCells)
+        {
+            ClearGroundGrid();
+        }
+
+        // Raycast down from the top of the cell's band at the center of the cell
+        BotGroundSample& sample = m_groundGrid[cellKey];
+        auto* sceneInterface = AZ::Interface<AzPhysics::SceneInterface>::Get();
+        const AzPhysics::SceneHandle sceneHandle = SceneQuery::GetDefaultSceneHandle();
+        if ((sceneInterface != nullptr) && (sceneHandle != AzPhysics::InvalidSceneHandle))
+        {
+            AzPhysics::RayCastRequest request;
+            request.m_start = AZ::Vector3(
+                (AZStd::floor(position.GetX() / cellSize) + 0.5f) * cellSize,
+                (AZStd::floor(position.GetY() / cellSize) + 0.5f) * cellSize,
+                (AZStd::floor(position.GetZ() / GroundBandHeight) + 1.0f) * GroundBandHeight);
+            request.m_direction = AZ::Vector3::CreateAxisZ(-1.f);
+            request.m_distance = sv_BotGroundProbeDistance;
+            request.m_queryType = AzPhysics::SceneQuery::QueryType::Static;
+
+            AzPhysics::SceneQueryHits result = sceneInterface->QueryScene(sceneHandle, &request);
+            if (result && result.m_hits[0].IsValid())
+            {
+                sample.m_point = result.m_hits[0].m_position;
+                sample.m_normal = result.m_hits[0].m_normal;
+                sample.m_hasGround = true;
+            }
+        }
+        return sample;
+    }
+
+    void BotMovementBatch::ClearGroundGrid()
+    {
+        m_groundGrid.clear();
+    }
+
+#if MPS_DIAGNOSTICS
+    void BotMovementBatch::RecordBotInput(bool kinematic, float elapsedUs)
+    {
+        PathStats& stats = kinematic ? m_kinematicStats : m_controllerStats;
+        ++stats.m_inputCount;
+        stats.m_inputUs += elapsedUs;
+    }
+
+    void BotMovementBatch::LogStats() const
+    {
+        const float tickCount = aznumeric_cast<float>(AZStd::max<uint64_t>(m_tickCount, 1));
+        const float kinematicInputCount = aznumeric_cast<float>(AZStd::max<uint64_t>(m_kinematicStats.m_inputCount, 1));
+        const float controllerInputCount = aznumeric_cast<float>(AZStd::max<uint64_t>(m_controllerStats.m_inputCount, 1));
+
+        AZLOG_INFO("Bot movement over %llu ticks: character controller %.1f inputs and %.1f us per tick (%.2f us per input), "
+            "kinematic %.1f inputs and %.1f us per tick including %.1f us of batched flush (%.2f us per input), %zu cached ground cells",
+            static_cast<unsigned long long>(m_tickCount),
+            aznumeric_cast<float>(m_controllerStats.m_inputCount) / tickCount, m_controllerStats.m_inputUs / tickCount, m_controllerStats.m_inputUs / controllerInputCount,
+            aznumeric_cast<float>(m_kinematicStats.m_inputCount) / tickCount, (m_kinematicStats.m_inputUs + m_flushUs) / tickCount, m_flushUs / tickCount,
+            (m_kinematicStats.m_inputUs + m_flushUs) / kinematicInputCount, m_groundGrid.size());
+    }
+
+    void BotMovementBatch::ResetStats()
+    {
+        m_kinematicStats = PathStats();
+        m_controllerStats = PathStats();
+        m_tickCount = 0;
+        m_flushUs = 0.0f;
+    }
+#endif
+
+    BotMovementBatch* GetBotMovementBatch()
+    {
+        return sv_BotKinematicMovement ? AZ::Interface<BotMovementBatch>::Get() : nullptr;
+    }
+
+#if MPS_DIAGNOSTICS
+    static void sv_BotMovementStats([[maybe_unused]] const AZ::ConsoleCommandContainer& arguments)
+    {
+        if (BotMovementBatch* botMovementBatch = AZ::Interface<BotMovementBatch>::Get())
+        {
+            botMovementBatch->LogStats();
+        }
+    }
+    AZ_CONSOLEFREEFUNC(sv_BotMovementStats, AZ::ConsoleFunctorFlags::Null, "Logs the per tick movement cost of AI bots moved kinematically and through their character controllers");
+
+    static void sv_BotMovementStatsReset([[maybe_unused]] const AZ::ConsoleCommandContainer& arguments)
+    {
+        if (BotMovementBatch* botMovementBatch = AZ::Interface<BotMovementBatch>::Get())
+        {
+            botMovementBatch->ResetStats();
+        }
+    }
+    AZ_CONSOLEFREEFUNC(sv_BotMovementStatsReset, AZ::ConsoleFunctorFlags::Null, "Clears the AI bot movement cost counters");
+#endif
+}
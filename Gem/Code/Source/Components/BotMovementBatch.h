@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project. For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+
+#pragma once
+
+#include <Source/MultiplayerSampleTypes.h>
+#include <AzCore/EBus/ScheduledEvent.h>
+#include <AzCore/Math/Vector3.h>
+#include <AzCore/RTTI/RTTI.h>
+#include <AzCore/std/containers/unordered_map.h>
+#include <AzCore/std/containers/vector.h>
+#include <AzCore/std/smart_ptr/shared_ptr.h>
+#include <AzFramework/Physics/Common/PhysicsSceneQueries.h>
+
+namespace AZ { class Entity; }
+
+namespace MultiplayerSample
+{
+    //! @class BotMovementListener
+    //! @brief Listener class for deferred BotMovementBatch moves.
+    class BotMovementListener
+    {
+    public:
+        //! Invoked once a batched move has been applied to the bot's transform.
+        //! @param onGround true if the bot ended the move standing on the ground grid
+        virtual void OnBotMoveComplete(bool onGround) = 0;
+    };
+
+    //! @struct BotGroundSample
+    //! @brief A cached ground raycast, the ground below nearby positions is found by extending the plane of the hit.
+    struct BotGroundSample
+    {
+        AZ::Vector3 m_point = AZ::Vector3::CreateZero();
+        AZ::Vector3 m_normal = AZ::Vector3::CreateAxisZ();
+        bool m_hasGround = false;
+    };
+
+    //! @class BotMovementBatch
+    //! @brief Server side service that moves AI bots kinematically instead of through their character controllers.
+    //! Ground is sampled from a grid of cached static raycasts and every bot's capsule is swept against static geometry in a single
+    //! batched scene query once per tick. No character controller moves or callbacks are involved, the character controller is only
+    //! teleported to the new position so the bot can still be hit and collided with where it is drawn. As only static geometry is swept,
+    //! kinematic bots pass through each other, through players and through dynamic bodies, and never push dynamic bodies.
+    class BotMovementBatch
+    {
+    public:
+        AZ_RTTI(BotMovementBatch, "{9E4B6F0A-3C1D-4F8E-A2B7-5D0C9E1F6A83}");
+
+        BotMovementBatch();
+        virtual ~BotMovementBatch();
+
+        //! Enqueues a move for a bot, applied to the bot's transform on the next flush.
+        //! @param entity    the bot entity to move
+        //! @param velocity  the velocity to move with
+        //! @param deltaTime the duration of the move
+        //! @param radius    the radius of the bot's capsule
+        //! @param height    the height of the bot's capsule
+        //! @param stepHeight the height the bot can step up onto without being blocked
+        //! @param listener  the listener to notify once the move has been applied
+        void EnqueueMove(AZ::Entity& entity, const AZ::Vector3& velocity, float deltaTime, float radius, float height, float stepHeight, BotMovementListener& listener);
+
+        //! Drops all pending moves for the provided listener, must be called before a listener is destroyed.
+        //! @param listener the listener to cancel pending moves for
+        void Cancel(const BotMovementListener& listener);
+
+        //! Executes all pending moves and notifies their listeners.
+        void Flush();
+
+        //! Finds the ground below a position from the cached ground grid, raycasting only the first time a grid cell is visited.
+        //! @param position    the position to find the ground below
+        //! @param maxDistance the largest distance below position to accept ground at
+        //! @param outGroundPoint the ground point below position
+        //! @param outGroundNormal the ground normal at outGroundPoint
+        //! @return true if ground was found within maxDistance
+        bool SampleGround(const AZ::Vector3& position, float maxDistance, AZ::Vector3& outGroundPoint, AZ::Vector3& outGroundNormal);
+
+        //! Drops every cached ground sample, for when static geometry changes.
+        void ClearGroundGrid();
+
+#if MPS_DIAGNOSTICS
+        //! Accumulates the cost of a single bot input for the movement stats.
+        //! @param kinematic true if the input was moved by this batch, false if it went through the character controller
+        //! @param elapsedUs the time spent processing the input
+        void RecordBotInput(bool kinematic, float elapsedUs);
+
+        //! Logs the per tick movement cost of bots moved by this batch and by their character controllers.
+        void LogStats() const;
+
+        //! Clears the movement stats.
+        void ResetStats();
+#endif
+
+    private:
+        //! Structure-of-arrays storage for one tick worth of moves.
+        struct MoveBuffers
+        {
+            AZStd::vector<AZ::Entity*> m_entities;
+            AZStd::vector<BotMovementListener*> m_listeners;
+            AZStd::vector<AZ::Vector3> m_startPositions;
+            AZStd::vector<AZ::Vector3> m_displacements;
+            AZStd::vector<float> m_radii;
+            AZStd::vector<float> m_heights;
+            AZStd::vector<float> m_stepHeights;
+
+            uint32_t GetMoveCount() const;
+            void Clear();
+        };
+
+#if MPS_DIAGNOSTICS
+        struct PathStats
+        {
+            uint64_t m_inputCount = 0;
+            float m_inputUs = 0.0f;
+        };
+#endif
+
+        const BotGroundSample& FindGroundSample(const AZ::Vector3& position);
+
+        MoveBuffers m_pendingMoves;   // Moves enqueued since the last flush
+        MoveBuffers m_executingMoves; // Moves being executed by the current flush, swapped with m_pendingMoves on flush
+        AzPhysics::SceneQueryRequests m_sweepRequests; // Capsule sweep requests, reused across flushes
+
+        AZStd::unordered_map<uint64_t, BotGroundSample> m_groundGrid;
+
+        AZStd::vector<AZStd::shared_ptr<AzPhysics::ShapeCastRequest>> m_sweepRequestPool;
+        AZStd::vector<uint32_t> m_sweepMoveIndices; // Move index of each sweep request, bots that aren't moving horizontally aren't swept
+
+#if MPS_DIAGNOSTICS
+        PathStats m_kinematicStats;
+        PathStats m_controllerStats;
+        uint64_t m_tickCount = 0;
+        float m_flushUs = 0.0f;
+#endif
+
+        AZ::ScheduledEvent m_flushEvent{ [this]()
+        {
+            Flush();
+        }, AZ::Name("BotMovementBatchFlush") };
+    };
+
+    //! Returns the bot movement batch if one is active and kinematic bot movement is enabled.
+    //! @return the bot movement batch, or nullptr if bots should move through their character controllers
+    BotMovementBatch* GetBotMovementBatch();
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project. For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+
+#include <Source/Components/InputActionMap.h>
+#include <Source/MultiplayerSampleTypes.h>
+#include <Source/Components/NetworkPlayerMovementComponent.h>
+#include <Source/Components/NetworkWeaponsComponent.h>
+#include <AzCore/Console/IConsole.h>
+#include <AzCore/Console/ILogger.h>
+#include <AzCore/Math/Random.h>
+#include <AzCore/std/chrono/chrono.h>
+#include <AzCore/std/containers/vector.h>
+
+namespace MultiplayerSample
+{
+#if MPS_DIAGNOSTICS
+    //! Checks that every binding of a map routes to its action and that events outside the map are not routed.
+    //! @return the number of misrouted events
+    template <typename ACTION>
+    static uint32_t CheckInputActionRouting(const InputActionMap<ACTION>& inputActions, const AZStd::vector<StartingPointInput::InputEventNotificationId>& unboundEventIds)
+    {
+        uint32_t misrouted = 0;
+        for (const InputActionBinding<ACTION>& binding : inputActions.GetBindings())
+        {
+            ACTION action;
+            if (!inputActions.TryGetAction(&binding.m_eventId, action) || action != binding.m_action)
+            {
+                ++misrouted;
+            }
+        }
+        for (const StartingPointInput::InputEventNotificationId& eventId : unboundEventIds)
+        {
+            ACTION action;
+            misrouted += inputActions.TryGetAction(&eventId, action) ? 1 : 0;
+        }
+        ACTION action;
+        misrouted += inputActions.TryGetAction(nullptr, action) ? 1 : 0;
+        return misrouted;
+    }
+
+    static void bg_InputActionMapCheck(const AZ::ConsoleCommandContainer& arguments)
+    {
+        const uint32_t eventCount = arguments.empty() ? 1000000 : aznumeric_cast<uint32_t>(AZStd::stoi(AZStd::string(arguments.front())));
+
+        const StartingPointInput::InputEventNotificationId unknownEventId("unboundInputEvent");
+        const uint32_t movementMisrouted = CheckInputActionRouting(GetMovementInputActions(),
+            { ZoomInEventId, ZoomOutEventId, DrawEventId, FirePrimaryEventId, FireSecondaryEventId, unknownEventId });
+        const uint32_t weaponMisrouted = CheckInputActionRouting(GetWeaponInputActions(),
+            { MoveFwdEventId, SprintEventId, LookUpDownEventId, ZoomInEventId, unknownEventId });
+
+        // Synthetic event stream over every event the movement controller is connected to, in the order the old comparison chain tested them
+        const AZStd::vector<StartingPointInput::InputEventNotificationId> chainEventIds =
+        {
+            MoveFwdEventId, MoveBackEventId, MoveLeftEventId, MoveRightEventId, SprintEventId, JumpEventId,
+            CrouchEventId, LookLeftRightEventId, LookUpDownEventId, ZoomInEventId, ZoomOutEventId
+        };
+        AZ::SimpleLcgRandom random(1234);
+        AZStd::vector<const StartingPointInput::InputEventNotificationId*> events(eventCount);
+        for (const StartingPointInput::InputEventNotificationId*& event : events)
+        {
+            event = &chainEventIds[random.GetRandom() % chainEventIds.size()];
+        }
+
+        // Reference path, compare the event against each id in turn as the if/else chains used to
+        uint32_t chainRouted = 0;
+        auto start = AZStd::chrono::steady_clock::now();
+        for (const StartingPointInput::InputEventNotificationId* event : events)
+        {
+            for (uint32_t index = 0; index < static_cast<uint32_t>(MovementInputAction::LookUpDown) + 1; ++index)
+            {
+                if (*event == chainEventIds[index])
+                {
+                    chainRouted += index;
+                    break;
+                }
+            }
+        }
+        const float chainUs = aznumeric_cast<float>(AZStd::chrono::duration_cast<AZStd::chrono::microseconds>(AZStd::chrono::steady_clock::now() - start).count());
+
+        // Reference path, scan the bound action name crcs in turn as the map did before it used a direct index table
+        const auto& bindings = GetMovementInputActions().GetBindings();
+        uint32_t scanRouted = 0;
+        start = AZStd::chrono::steady_clock::now();
+        for (const StartingPointInput::InputEventNotificationId* event : events)
+        {
+            for (const InputActionBinding<MovementInputAction>& binding : bindings)
+            {
+                if (binding.m_eventId.m_actionNameCrc == event->m_actionNameCrc)
+                {
+                    scanRouted += static_cast<uint32_t>(binding.m_action);
+                    break;
+                }
+            }
+        }
+        const float scanUs = aznumeric_cast<float>(AZStd::chrono::duration_cast<AZStd::chrono::microseconds>(AZStd::chrono::steady_clock::now() - start).count());
+
+        // Action map path
+        uint32_t mapRouted = 0;
+        start = AZStd::chrono::steady_clock::now();
+        for (const StartingPointInput::InputEventNotificationId* event : events)
+        {
+            MovementInputAction action;
+            if (GetMovementInputActions().TryGetAction(event, action))
+            {
+                mapRouted += static_cast<uint32_t>(action);
+            }
+        }
+        const float mapUs = aznumeric_cast<float>(AZStd::chrono::duration_cast<AZStd::chrono::microseconds>(AZStd::chrono::steady_clock::now() - start).count());
+
+        const bool routedSame = (chainRouted == mapRouted) && (scanRouted == mapRouted);
+        AZLOG_INFO("Input action map check: %u misrouted movement events, %u misrouted weapon events, movement map uses %u slots, weapon map %u slots. "
+            "%u synthetic events %s the reference paths, comparison chain %.1f us, crc scan %.1f us, action map %.1f us",
+            movementMisrouted, weaponMisrouted, GetMovementInputActions().GetSlotCount(), GetWeaponInputActions().GetSlotCount(),
+            eventCount, routedSame ? "routed the same as" : "DIVERGED from", chainUs, scanUs, mapUs);
+    }
+    AZ_CONSOLEFREEFUNC(bg_InputActionMapCheck, AZ::ConsoleFunctorFlags::Null, "Checks that every input binding routes to its movement or weapon action and times synthetic input events through the old comparison chain, a crc scan and the action map, optionally takes an event count");
+#endif
+}
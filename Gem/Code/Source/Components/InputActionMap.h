@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project. For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+
+#pragma once
+
+#include <AzCore/std/algorithm.h>
+#include <AzCore/std/containers/array.h>
+#include <AzCore/std/containers/fixed_vector.h>
+#include <AzCore/std/limits.h>
+#include <StartingPointInput/InputEventNotificationBus.h>
+
+namespace MultiplayerSample
+{
+    constexpr uint32_t MaxInputActionsPerMap = 16; // Maximum number of input events a single component maps to actions
+
+    //! @struct InputActionBinding
+    //! @brief Binds an input event to the action a component performs for it.
+    template <typename ACTION>
+    struct InputActionBinding
+    {
+        StartingPointInput::InputEventNotificationId m_eventId;
+        ACTION m_action;
+    };
+
+    //! @class InputActionMap
+    //! @brief Map from input event action name crc to a component defined action, used by input handlers in place of
+    //! comparing the current bus id against every event id the component listens to.
+    //! Bindings are placed in a small direct index table at the smallest size where their crcs don't collide, so a lookup is a
+    //! single modulo and one crc comparison however many bindings there are.
+    //! Only the action name crc is compared, components connect to their input events for any local user.
+    template <typename ACTION>
+    class InputActionMap
+    {
+    public:
+        InputActionMap(std::initializer_list<InputActionBinding<ACTION>> bindings)
+        {
+            AZ_Assert(bindings.size() <= MaxInputActionsPerMap, "Too many input actions, increase MaxInputActionsPerMap");
+            for (const InputActionBinding<ACTION>& binding : bindings)
+            {
+                m_actionNameCrcs.push_back(static_cast<AZ::u32>(binding.m_eventId.m_actionNameCrc));
+                m_bindings.push_back(binding);
+            }
+
+            for (uint32_t slotCount = AZStd::max<uint32_t>(aznumeric_cast<uint32_t>(m_bindings.size()), 1); slotCount <= MaxInputActionSlots; ++slotCount)
+            {
+                if (TryBuildSlots(slotCount))
+                {
+                    return;
+                }
+            }
+
+            // Every table size collided, fall back to scanning the bindings
+            m_slotCount = 0;
+        }
+
+        //! Looks up the action bound to an input event.
+        //! @param eventId   the input event to look up, typically the current InputEventNotificationBus id
+        //! @param outAction set to the bound action if one is found
+        //! @return true if the input event is bound to an action
+        bool TryGetAction(const StartingPointInput::InputEventNotificationId* eventId, ACTION& outAction) const
+        {
+            if (eventId == nullptr)
+            {
+                return false;
+            }
+
+            const AZ::u32 actionNameCrc = static_cast<AZ::u32>(eventId->m_actionNameCrc);
+            if (m_slotCount > 0)
+            {
+                const uint8_t slot = m_slots[actionNameCrc % m_slotCount];
+                if ((slot != EmptySlot) && (m_actionNameCrcs[slot] == actionNameCrc))
+                {
+                    outAction = m_bindings[slot].m_action;
+                    return true;
+                }
+                return false;
+            }
+
+            for (size_t index = 0; index < m_actionNameCrcs.size(); ++index)
+            {
+                if (m_actionNameCrcs[index] == actionNameCrc)
+                {
+                    outAction = m_bindings[index].m_action;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        //! Returns every binding in the map, in the order they were declared.
+        const AZStd::fixed_vector<InputActionBinding<ACTION>, MaxInputActionsPerMap>& GetBindings() const
+        {
+            return m_bindings;
+        }
+
+        //! Returns the size of the direct index table, 0 if lookups fall back to scanning the bindings.
+        uint32_t GetSlotCount() const
+        {
+            return m_slotCount;
+        }
+
+    private:
+        static constexpr uint32_t MaxInputActionSlots = 64;
+        static constexpr uint8_t EmptySlot = AZStd::numeric_limits<uint8_t>::max();
+
+        bool TryBuildSlots(uint32_t slotCount)
+        {
+            m_slots.fill(EmptySlot);
+            for (size_t index = 0; index < m_actionNameCrcs.size(); ++index)
+            {
+                uint8_t& slot = m_slots[m_actionNameCrcs[index] % slotCount];
+                if (slot != EmptySlot)
+                {
+                    return false;
+                }
+                slot = aznumeric_cast<uint8_t>(index);
+            }
+            m_slotCount = slotCount;
+            return true;
+        }
+
+        AZStd::array<uint8_t, MaxInputActionSlots> m_slots; // Binding index for each crc modulo m_slotCount, EmptySlot if unbound
+        uint32_t m_slotCount = 0;
+        AZStd::fixed_vector<AZ::u32, MaxInputActionsPerMap> m_actionNameCrcs; // Kept apart from the bindings so the crc check touches a single small array
+        AZStd::fixed_vector<InputActionBinding<ACTION>, MaxInputActionsPerMap> m_bindings;
+    };
+}
@@ -45,6 +45,7 @@ namespace MultiplayerSample
         m_effect.Initialize(GameEffect::EmitterType::FireAndForget);
 
         AZ::EntityBus::Handler::BusConnect(GetEntityId());
+        BallActiveAddEvent(m_ballActiveHandler);
         if (cl_EnergyBallDebugDraw)
         {
             m_debugDrawEvent.Enqueue(AZ::TimeMs{ 0 }, true);
@@ -57,6 +58,7 @@ namespace MultiplayerSample
 #if AZ_TRAIT_CLIENT
         m_effect = {};
         AZ::EntityBus::Handler::BusDisconnect();
+        m_ballActiveHandler.Disconnect();
         m_debugDrawEvent.RemoveFromQueue();
 #endif
     }
@@ -69,8 +71,29 @@ namespace MultiplayerSample
         // on this entity to perform hit logic. If we waited to run this until OnDeactivate, the other components would no
         // longer be active and wouldn't have a chance to process the logic.
 
-        // Create an explosion effect wherever the ball was last at before deactivating.
-        m_effect.TriggerEffect(GetEntity()->GetTransform()->GetWorldTM());
+        // Pooled energy balls explode when they are deactivated by the server rather than when the entity deactivates,
+        // only explode here if the ball was still in flight.
+        if (GetBallActive())
+        {
+            Explode(GetEntity()->GetTransform()->GetWorldTM().GetTranslation());
+        }
+    }
+
+    void EnergyBallComponent::OnBallActiveChanged(bool ballActive)
+    {
+        if (!ballActive)
+        {
+            // The ball may already have been parked, so explode where the server says the ball was killed
+            Explode(GetHitEvent().m_target);
+        }
+    }
+
+    void EnergyBallComponent::Explode(const AZ::Vector3& position)
+    {
+        // Create an explosion effect wherever the ball was last at.
+        AZ::Transform explosionTransform = GetEntity()->GetTransform()->GetWorldTM();
+        explosionTransform.SetTranslation(position);
+        m_effect.TriggerEffect(explosionTransform);
 
         auto hitEvent = GetHitEvent();
 
@@ -141,6 +164,11 @@ namespace MultiplayerSample
 #if AZ_TRAIT_SERVER
         m_collisionCheckEvent.RemoveFromQueue();
         m_killEvent.RemoveFromQueue();
+
+        if (WeaponQueryBatch* weaponQueryBatch = AZ::Interface<WeaponQueryBatch>::Get())
+        {
+            weaponQueryBatch->Cancel(*this);
+        }
 #endif
     }
 
@@ -153,6 +181,9 @@ namespace MultiplayerSample
 
         SetVelocity(direction * GetGatherParams().m_travelSpeed);
 
+        SetBallActive(true);
+        ModifyHitEvent().m_hitEntities.clear();
+
         m_shooterNetEntityId = owningNetEntityId;
         m_filteredNetEntityIds.clear();
         m_filteredNetEntityIds.insert(owningNetEntityId);
@@ -172,19 +203,46 @@ namespace MultiplayerSample
     void EnergyBallComponentController::CheckForCollisions()
     {
         const AZ::Vector3& position = GetEntity()->GetTransform()->GetWorldTM().GetTranslation();
-        const HitEffect& effect = GetHitEffect();
 
         // Sweep from our last checked transform to our current position to avoid tunneling
         const ActivateEvent activateEvent{ m_lastSweepTransform, position, m_shooterNetEntityId, GetNetEntityId() };
 
-        IntersectResults results;
-        GatherEntities(GetGatherParams(), activateEvent, m_filteredNetEntityIds, results);
+        if (WeaponQueryBatch* weaponQueryBatch = GetWeaponQueryBatch())
+        {
+            // Collisions are handled once the batch has been flushed this tick
+            weaponQueryBatch->EnqueueGather(GetGatherParams(), activateEvent, m_filteredNetEntityIds, *this, 0);
+        }
+        else
+        {
+            IntersectResults results;
+            GatherEntities(GetGatherParams(), activateEvent, m_filteredNetEntityIds, results);
+            HandleCollisions(position, results);
+        }
+
+        // Update our last sweep transform for the next time we check collision
+        m_lastSweepTransform = GetEntity()->GetTransform()->GetWorldTM();
+    }
+
+    void EnergyBallComponentController::OnWeaponQueryComplete
+    (
+        [[maybe_unused]] uint32_t userData,
+        const ActivateEvent& eventData,
+        [[maybe_unused]] ShotResult result,
+        const IntersectResults& results
+    )
+    {
+        HandleCollisions(eventData.m_targetPosition, results);
+    }
+
+    void EnergyBallComponentController::HandleCollisions(const AZ::Vector3& position, const IntersectResults& results)
+    {
+        const HitEffect& effect = GetHitEffect();
 
         if (!results.empty())
         {
             for (const IntersectResult& result : results)
             {
-                const HitEntity hitEntity{ result.m_position, result.m_normal, result.m_netEntityId };
+                const HitEntity hitEntity{ result.m_position, result.m_normal, result.m_netEntityId, result.m_surfaceIndex };
                 ModifyHitEvent().m_hitEntities.emplace_back(hitEntity);
 
                 const Multiplayer::ConstNetworkEntityHandle handle = Multiplayer::GetNetworkEntityManager()->GetEntity(result.m_netEntityId);
@@ -213,9 +271,6 @@ namespace MultiplayerSample
 
             KillEnergyBall();
         }
-
-        // Update our last sweep transform for the next time we check collision
-        m_lastSweepTransform = GetEntity()->GetTransform()->GetWorldTM();
     }
 
     void EnergyBallComponentController::KillEnergyBall()
@@ -223,6 +278,11 @@ namespace MultiplayerSample
         m_collisionCheckEvent.RemoveFromQueue();
         m_killEvent.RemoveFromQueue();
 
+        if (WeaponQueryBatch* weaponQueryBatch = AZ::Interface<WeaponQueryBatch>::Get())
+        {
+            weaponQueryBatch->Cancel(*this);
+        }
+
         SetVelocity(AZ::Vector3::CreateZero());
 
         auto& hitEvent = ModifyHitEvent();
@@ -231,10 +291,30 @@ namespace MultiplayerSample
         hitEvent.m_shooterNetEntityId = m_shooterNetEntityId;
         hitEvent.m_projectileNetEntityId = GetNetEntityId();
 
-        // Immediately remove the entity.
+        SetBallActive(false);
+
         const Multiplayer::NetEntityId netEntityId = GetNetEntityId();
         const Multiplayer::ConstNetworkEntityHandle entityHandle = Multiplayer::GetNetworkEntityManager()->GetEntity(netEntityId);
+        if (m_entityPool != nullptr)
+        {
+            // Park the ball out of the way until the cannon fires it again
+            GetNetworkTransformComponentController()->HandleMultiplayerTeleport(nullptr, m_entityPool->GetParkedTransform().GetTranslation());
+            m_entityPool->Release(entityHandle);
+            return;
+        }
+
+        // Immediately remove the entity.
         Multiplayer::GetNetworkEntityManager()->MarkForRemoval(entityHandle);
     }
+
+    void EnergyBallComponentController::SetEntityPool(NetworkEntityPool* entityPool)
+    {
+        m_poolClearedHandler.Disconnect();
+        m_entityPool = entityPool;
+        if (m_entityPool != nullptr)
+        {
+            m_entityPool->AddPoolClearedEventHandler(m_poolClearedHandler);
+        }
+    }
 #endif
 }
@@ -10,6 +10,8 @@
 #include <AzCore/Component/EntityBus.h>
 #include <Source/AutoGen/EnergyBallComponent.AutoComponent.h>
 #include <Source/Weapons/WeaponGathers.h>
+#include <Source/Weapons/WeaponQueryBatch.h>
+#include <Source/Components/Multiplayer/NetworkEntityPool.h>
 
 namespace MultiplayerSample
 {
@@ -28,8 +30,15 @@ namespace MultiplayerSample
     private:
 #if AZ_TRAIT_CLIENT
         void OnEntityDeactivated(const AZ::EntityId&) override;
+        void OnBallActiveChanged(bool ballActive);
+        void Explode(const AZ::Vector3& position);
         void DebugDraw();
 
+        AZ::Event<bool>::Handler m_ballActiveHandler{ [this](bool ballActive)
+        {
+            OnBallActiveChanged(ballActive);
+        } };
+
         AZ::ScheduledEvent m_debugDrawEvent{ [this]()
         {
             DebugDraw();
@@ -41,6 +50,9 @@ namespace MultiplayerSample
 
     class EnergyBallComponentController
         : public EnergyBallComponentControllerBase
+#if AZ_TRAIT_SERVER
+        , public WeaponQueryListener
+#endif
     {
     public:
         explicit EnergyBallComponentController(EnergyBallComponent& parent);
@@ -53,7 +65,18 @@ namespace MultiplayerSample
         void CheckForCollisions();
         void KillEnergyBall();
 
+        //! Sets the pool this energy ball is returned to when killed, energy balls without a pool are destroyed instead.
+        //! @param entityPool the owning pool
+        void SetEntityPool(NetworkEntityPool* entityPool);
+
+        //! WeaponQueryListener interface
+        //! @{
+        void OnWeaponQueryComplete(uint32_t userData, const ActivateEvent& eventData, ShotResult result, const IntersectResults& results) override;
+        //! @}
+
     private:
+        void HandleCollisions(const AZ::Vector3& position, const IntersectResults& results);
+
         AZ::ScheduledEvent m_collisionCheckEvent{ [this]()
         {
             CheckForCollisions();
@@ -68,6 +91,12 @@ namespace MultiplayerSample
         AZ::Transform m_lastSweepTransform = AZ::Transform::CreateIdentity();
         Multiplayer::NetEntityId m_shooterNetEntityId = Multiplayer::InvalidNetEntityId;
         NetEntityIdSet m_filteredNetEntityIds;
+
+        NetworkEntityPool* m_entityPool = nullptr;
+        AZ::Event<>::Handler m_poolClearedHandler{ [this]()
+        {
+            m_entityPool = nullptr;
+        } };
 #endif
     };
 }
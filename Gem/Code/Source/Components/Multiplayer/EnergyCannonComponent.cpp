@@ -9,12 +9,17 @@
 #include <MultiplayerSampleTypes.h>
 #include <AzCore/Component/ComponentApplicationBus.h>
 #include <AzCore/Component/TransformBus.h>
+#include <AzCore/Console/IConsole.h>
 #include <AzCore/Settings/SettingsRegistry.h>
 #include <Source/Components/Multiplayer/EnergyBallComponent.h>
 #include <Source/Components/Multiplayer/EnergyCannonComponent.h>
 
 namespace MultiplayerSample
 {
+#if AZ_TRAIT_SERVER
+    AZ_CVAR(float, sv_EnergyCannonPoolParkingDepth, 1000.0f, nullptr, AZ::ConsoleFunctorFlags::Null, "How far below its cannon a pooled energy ball is parked while not in flight");
+#endif
+
     void EnergyCannonComponent::Reflect(AZ::ReflectContext* context)
     {
         AZ::SerializeContext* serializeContext = azrtti_cast<AZ::SerializeContext*>(context);
@@ -62,6 +67,11 @@ namespace MultiplayerSample
 #if AZ_TRAIT_SERVER
         if (GetRateOfFireMs() > AZ::TimeMs{ 0 })
         {
+            // Build the prefab id once and pre-spawn energy balls so that firing reuses parked entities instead of creating new ones
+            const Multiplayer::PrefabEntityId prefabEntityId(AZ::Name(GetProjectileSpawnable().m_spawnableAsset.GetHint().c_str()));
+            const AZ::Vector3 parkedPosition = GetEntity()->GetTransform()->GetWorldTranslation() - AZ::Vector3::CreateAxisZ(sv_EnergyCannonPoolParkingDepth);
+            m_energyBallPool.Initialize(prefabEntityId, GetProjectilePoolSize(), AZ::Transform::CreateTranslation(parkedPosition));
+
             m_firingEvent.Enqueue(GetRateOfFireMs(), true);
         }
 #endif
@@ -72,6 +82,7 @@ namespace MultiplayerSample
 #if AZ_TRAIT_SERVER
         m_triggerBuildupEvent.RemoveFromQueue();
         m_firingEvent.RemoveFromQueue();
+        m_energyBallPool.Clear();
 #endif
     }
 
@@ -91,27 +102,12 @@ namespace MultiplayerSample
         const AZ::Vector3 ballPosition = cannonTm.TransformPoint(effectOffset);
         const AZ::Vector3 forward = cannonTm.TransformVector(GetFireVector());
 
-        const Multiplayer::PrefabEntityId prefabEntityId(AZ::Name(GetProjectileSpawnable().m_spawnableAsset.GetHint().c_str()));
-
         const AZ::Transform transform = AZ::Transform::CreateFromQuaternionAndTranslation(AZ::Quaternion::CreateIdentity(), ballPosition);
-
-        Multiplayer::INetworkEntityManager::EntityList entityList =
-            Multiplayer::GetNetworkEntityManager()->CreateEntitiesImmediate(prefabEntityId, Multiplayer::NetEntityRole::Authority, transform);
-
-        Multiplayer::NetworkEntityHandle spawnedEntity;
-        if (entityList.size() == 1)
-        {
-            spawnedEntity = entityList[0];
-        }
-        else
-        {
-            AZLOG_WARN("Attempt to spawn prefab %s failed. Check that prefab is network enabled and only contains a single entity. "
-                "If multiple entities are in the prefab, only the first one will get deleted. Spawn count: %zu", 
-                prefabEntityId.m_prefabName.GetCStr(), entityList.size());
-        }
+        Multiplayer::NetworkEntityHandle spawnedEntity = m_energyBallPool.Acquire(transform);
 
         if (EnergyBallComponent* ballComponent = spawnedEntity.FindComponent<EnergyBallComponent>())
         {
+            static_cast<EnergyBallComponentController*>(ballComponent->GetController())->SetEntityPool(&m_energyBallPool);
             ballComponent->RPC_LaunchBall(ballPosition, forward, GetNetEntityId());
             m_triggerBuildupEvent.Enqueue(GetRateOfFireMs() - GetBuildUpTimeMs(), false);
         }
@@ -8,6 +8,7 @@
 #pragma once
 
 #include <Source/AutoGen/EnergyCannonComponent.AutoComponent.h>
+#include <Source/Components/Multiplayer/NetworkEntityPool.h>
 
 namespace MultiplayerSample
 {
@@ -53,6 +54,8 @@ namespace MultiplayerSample
         {
             OnFireEnergyBall();
         }, AZ::Name("FireEnergyCannon")};
+
+        NetworkEntityPool m_energyBallPool;
 #endif
     };
 }
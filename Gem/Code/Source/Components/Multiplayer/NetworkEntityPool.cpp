@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project. For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+
+#include <Source/Components/Multiplayer/NetworkEntityPool.h>
+#include <AzCore/Console/IConsole.h>
+#include <AzCore/Console/ILogger.h>
+#include <AzCore/std/chrono/chrono.h>
+#include <Multiplayer/IMultiplayer.h>
+#include <Multiplayer/NetworkEntity/INetworkEntityManager.h>
+
+namespace MultiplayerSample
+{
+#if MPS_DIAGNOSTICS
+    static NetworkEntityPool::Stats s_stats;
+#endif
+
+    NetworkEntityPool::~NetworkEntityPool()
+    {
+        Clear();
+    }
+
+    void NetworkEntityPool::Initialize(const Multiplayer::PrefabEntityId& prefabEntityId, uint32_t poolSize, const AZ::Transform& parkedTransform)
+    {
+        Clear();
+
+        m_prefabEntityId = prefabEntityId;
+        m_parkedTransform = parkedTransform;
+
+        m_entities.reserve(poolSize);
+        m_availableEntities.reserve(poolSize);
+        for (uint32_t index = 0; index < poolSize; ++index)
+        {
+            Multiplayer::NetworkEntityHandle entityHandle = Spawn(m_parkedTransform);
+            if (!entityHandle.Exists())
+            {
+                break;
+            }
+            m_availableEntities.push_back(entityHandle);
+        }
+    }
+
+    Multiplayer::NetworkEntityHandle NetworkEntityPool::Acquire(const AZ::Transform& transform)
+    {
+#if MPS_DIAGNOSTICS
+        const auto start = AZStd::chrono::steady_clock::now();
+        ++s_stats.m_acquireCount;
+#endif
+
+        Multiplayer::NetworkEntityHandle entityHandle;
+        while (!m_availableEntities.empty() && !entityHandle.Exists())
+        {
+            // Skip any pooled entities that were removed out from under us
+            entityHandle = m_availableEntities.back();
+            m_availableEntities.pop_back();
+        }
+
+        if (!entityHandle.Exists())
+        {
+            entityHandle = Spawn(transform);
+        }
+
+#if MPS_DIAGNOSTICS
+        s_stats.m_acquireTimeUs += AZStd::chrono::duration_cast<AZStd::chrono::microseconds>(AZStd::chrono::steady_clock::now() - start).count();
+#endif
+        return entityHandle;
+    }
+
+    void NetworkEntityPool::Release(const Multiplayer::ConstNetworkEntityHandle& entityHandle)
+    {
+        for (const Multiplayer::NetworkEntityHandle& pooledEntity : m_entities)
+        {
+            if (pooledEntity.GetNetEntityId() == entityHandle.GetNetEntityId())
+            {
+#if MPS_DIAGNOSTICS
+                ++s_stats.m_releaseCount;
+#endif
+                m_availableEntities.push_back(pooledEntity);
+                return;
+            }
+        }
+
+        AZ_Assert(false, "Attempting to release an entity that is not owned by this pool");
+    }
+
+    void NetworkEntityPool::Clear()
+    {
+        m_poolClearedEvent.Signal();
+
+        for (Multiplayer::NetworkEntityHandle& entityHandle : m_entities)
+        {
+            if (entityHandle.Exists())
+            {
+#if MPS_DIAGNOSTICS
+                ++s_stats.m_despawnCount;
+#endif
+                Multiplayer::GetNetworkEntityManager()->MarkForRemoval(entityHandle);
+            }
+        }
+
+        m_entities.clear();
+        m_availableEntities.clear();
+    }
+
+    const AZ::Transform& NetworkEntityPool::GetParkedTransform() const
+    {
+        return m_parkedTransform;
+    }
+
+    void NetworkEntityPool::AddPoolClearedEventHandler(AZ::Event<>::Handler& handler)
+    {
+        handler.Connect(m_poolClearedEvent);
+    }
+
+#if MPS_DIAGNOSTICS
+    const NetworkEntityPool::Stats& NetworkEntityPool::GetStats()
+    {
+        return s_stats;
+    }
+#endif
+
+    Multiplayer::NetworkEntityHandle NetworkEntityPool::Spawn(const AZ::Transform& transform)
+    {
+        Multiplayer::INetworkEntityManager::EntityList entityList =
+            Multiplayer::GetNetworkEntityManager()->CreateEntitiesImmediate(m_prefabEntityId, Multiplayer::NetEntityRole::Authority, transform);
+
+        if (entityList.size() != 1)
+        {
+            AZLOG_WARN("Attempt to spawn prefab %s failed. Check that prefab is network enabled and only contains a single entity. "
+                "If multiple entities are in the prefab, only the first one will be pooled. Spawn count: %zu",
+                m_prefabEntityId.m_prefabName.GetCStr(), entityList.size());
+
+            if (entityList.empty())
+            {
+                return Multiplayer::NetworkEntityHandle();
+            }
+        }
+
+#if MPS_DIAGNOSTICS
+        ++s_stats.m_spawnCount;
+#endif
+        m_entities.push_back(entityList[0]);
+        return entityList[0];
+    }
+
+#if MPS_DIAGNOSTICS
+    static void sv_NetworkEntityPoolStats([[maybe_unused]] const AZ::ConsoleCommandContainer& arguments)
+    {
+        const NetworkEntityPool::Stats& stats = NetworkEntityPool::GetStats();
+        const double averageAcquireUs = (stats.m_acquireCount > 0) ? aznumeric_cast<double>(stats.m_acquireTimeUs) / stats.m_acquireCount : 0.0;
+        AZLOG_INFO("Network entity pools: %llu spawned, %llu despawned, %llu acquired, %llu released, %.3f us average acquire time",
+            aznumeric_cast<unsigned long long>(stats.m_spawnCount),
+            aznumeric_cast<unsigned long long>(stats.m_despawnCount),
+            aznumeric_cast<unsigned long long>(stats.m_acquireCount),
+            aznumeric_cast<unsigned long long>(stats.m_releaseCount),
+            averageAcquireUs);
+    }
+    AZ_CONSOLEFREEFUNC(sv_NetworkEntityPoolStats, AZ::ConsoleFunctorFlags::Null, "Logs spawn, despawn, acquire and release counts and the average acquire time for all network entity pools");
+#endif
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project. For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+
+#pragma once
+
+#include <Source/MultiplayerSampleTypes.h>
+#include <AzCore/EBus/Event.h>
+#include <AzCore/Math/Transform.h>
+#include <AzCore/std/containers/vector.h>
+#include <Multiplayer/NetworkEntity/NetworkEntityHandle.h>
+#include <Multiplayer/MultiplayerTypes.h>
+
+namespace MultiplayerSample
+{
+    //! @class NetworkEntityPool
+    //! @brief Server side pool of pre-spawned network entities that are parked while not in use instead of being destroyed.
+    //! Pooled entities stay alive and replicated for the lifetime of the pool, so reusing one avoids creating and
+    //! destroying a full network entity on both the server and every client.
+    class NetworkEntityPool
+    {
+    public:
+#if MPS_DIAGNOSTICS
+        //! Counters accumulated across every pool in the process.
+        struct Stats
+        {
+            uint64_t m_spawnCount = 0;
+            uint64_t m_despawnCount = 0;
+            uint64_t m_acquireCount = 0;
+            uint64_t m_releaseCount = 0;
+            uint64_t m_acquireTimeUs = 0;
+        };
+#endif
+
+        NetworkEntityPool() = default;
+        ~NetworkEntityPool();
+
+        //! Spawns the initial set of parked entities.
+        //! @param prefabEntityId  the network prefab entity to pool, the prefab must contain a single network entity
+        //! @param poolSize        the number of entities to spawn up front
+        //! @param parkedTransform where entities are kept while they are not in use
+        void Initialize(const Multiplayer::PrefabEntityId& prefabEntityId, uint32_t poolSize, const AZ::Transform& parkedTransform);
+
+        //! Takes a parked entity out of the pool, spawning a new pooled entity if none are available.
+        //! @param transform the transform to spawn a new entity at if the pool is empty, reused entities are not moved
+        //! @return handle to the acquired entity, invalid if spawning failed
+        Multiplayer::NetworkEntityHandle Acquire(const AZ::Transform& transform);
+
+        //! Returns a previously acquired entity to the pool, the caller is responsible for parking it.
+        //! @param entityHandle the entity to return
+        void Release(const Multiplayer::ConstNetworkEntityHandle& entityHandle);
+
+        //! Removes every pooled entity and signals the pool cleared event.
+        void Clear();
+
+        //! Returns where entities are kept while they are not in use.
+        //! @return the parked transform
+        const AZ::Transform& GetParkedTransform() const;
+
+        //! Adds a handler invoked when the pool is cleared, pooled entities must stop referencing the pool at that point.
+        //! @param handler the handler to add
+        void AddPoolClearedEventHandler(AZ::Event<>::Handler& handler);
+
+#if MPS_DIAGNOSTICS
+        //! Returns the counters accumulated across every pool in the process.
+        //! @return the pool counters
+        static const Stats& GetStats();
+#endif
+
+    private:
+        Multiplayer::NetworkEntityHandle Spawn(const AZ::Transform& transform);
+
+        // Do not allow copying or assignment
+        NetworkEntityPool(const NetworkEntityPool&) = delete;
+        NetworkEntityPool& operator =(const NetworkEntityPool&) = delete;
+
+        Multiplayer::PrefabEntityId m_prefabEntityId;
+        AZ::Transform m_parkedTransform = AZ::Transform::CreateIdentity();
+        AZStd::vector<Multiplayer::NetworkEntityHandle> m_entities; // Every entity owned by the pool
+        AZStd::vector<Multiplayer::NetworkEntityHandle> m_availableEntities; // Parked entities ready to be acquired
+        AZ::Event<> m_poolClearedEvent;
+    };
+}
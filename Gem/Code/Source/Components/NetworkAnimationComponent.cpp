@@ -6,6 +6,7 @@
  */
 
 #include <Source/Components/NetworkAnimationComponent.h>
+#include <Source/Components/BoneIndexCache.h>
 #include <Multiplayer/Components/NetworkCharacterComponent.h>
 #include <Source/Components/NetworkSimplePlayerCameraComponent.h>
 #include <Source/Components/NetworkPlayerMovementComponent.h>
@@ -13,6 +14,7 @@
 #include <Integration/AnimationBus.h>
 #include <Integration/AnimGraphNetworkingBus.h>
 #include <AzCore/Component/TransformBus.h>
+#include <EMotionFX/Source/ActorInstance.h>
 
 #if AZ_TRAIT_CLIENT
 #include <DebugDraw/DebugDrawBus.h>
@@ -61,25 +63,34 @@ namespace MultiplayerSample
     void NetworkAnimationComponent::OnDeactivate([[maybe_unused]] Multiplayer::EntityIsMigrating entityIsMigrating)
     {
         EMotionFX::Integration::ActorComponentNotificationBus::Handler::BusDisconnect();
+
+        // We won't hear about the actor instance being destroyed anymore, so release our reference now
+        SetActor(nullptr);
     }
 
     int32_t NetworkAnimationComponent::GetBoneIdByName(const char* boneName) const
     {
-        if (m_actorRequests != nullptr)
+        if (m_actorRequests == nullptr)
         {
-            return static_cast<int32_t>(m_actorRequests->GetJointIndexByName(boneName));
+            return InvalidBoneId;
         }
-        return InvalidBoneId;
+
+        BoneIndexCache* boneIndexCache = GetBoneIndexCache();
+        if ((boneIndexCache != nullptr) && (m_actor != nullptr))
+        {
+            return boneIndexCache->GetJointIndex(m_actor, boneName, *m_actorRequests);
+        }
+        return static_cast<int32_t>(m_actorRequests->GetJointIndexByName(boneName));
+    }
+
+    void NetworkAnimationComponent::AddActorChangedEventHandler(AZ::Event<>::Handler& handler)
+    {
+        handler.Connect(m_actorChangedEvent);
     }
 
     bool NetworkAnimationComponent::GetJointTransformByName(const char* jointName, AZ::Transform& outJointTransform) const
     {
-        if (m_actorRequests == nullptr)
-        {
-            return false;
-        }
-        const int32_t jointId = static_cast<int32_t>(m_actorRequests->GetJointIndexByName(jointName));
-        return GetJointTransformById(jointId, outJointTransform);
+        return GetJointTransformById(GetBoneIdByName(jointName), outJointTransform);
     }
 
     bool NetworkAnimationComponent::GetJointTransformById(int32_t jointId, AZ::Transform& outJointTransform) const
@@ -241,14 +252,39 @@ namespace MultiplayerSample
         m_networkRequests->UpdateActorExternal(deltaTime);
     }
 
-    void NetworkAnimationComponent::OnActorInstanceCreated([[maybe_unused]] EMotionFX::ActorInstance* actorInstance)
+    void NetworkAnimationComponent::SetActor(const EMotionFX::Actor* actor)
+    {
+        if (actor == m_actor)
+        {
+            return;
+        }
+
+        if (BoneIndexCache* boneIndexCache = GetBoneIndexCache())
+        {
+            if (m_actor != nullptr)
+            {
+                boneIndexCache->RemoveActorReference(m_actor);
+            }
+            if (actor != nullptr)
+            {
+                boneIndexCache->AddActorReference(actor);
+            }
+        }
+        m_actor = actor;
+    }
+
+    void NetworkAnimationComponent::OnActorInstanceCreated(EMotionFX::ActorInstance* actorInstance)
     {
         m_actorRequests = EMotionFX::Integration::ActorComponentRequestBus::FindFirstHandler(GetEntityId());
+        SetActor((actorInstance != nullptr) ? actorInstance->GetActor() : nullptr);
+        m_actorChangedEvent.Signal();
     }
 
     void NetworkAnimationComponent::OnActorInstanceDestroyed([[maybe_unused]] EMotionFX::ActorInstance* actorInstance)
     {
         m_actorRequests = nullptr;
+        SetActor(nullptr);
+        m_actorChangedEvent.Signal();
     }
 
     void NetworkAnimationComponent::OnAnimGraphInstanceCreated([[maybe_unused]] EMotionFX::AnimGraphInstance* animGraphInstance)
@@ -14,6 +14,7 @@
 
 namespace EMotionFX
 {
+    class Actor;
     class AnimGraphComponentNetworkRequests;
     namespace Integration
     {
@@ -45,13 +46,22 @@ namespace MultiplayerSample
         void OnActivate(Multiplayer::EntityIsMigrating entityIsMigrating) override;
         void OnDeactivate(Multiplayer::EntityIsMigrating entityIsMigrating) override;
 
+        //! Returns the joint index of a bone, cached per actor so only the first lookup of each bone resolves the name.
+        //! Resolve bones when the actor changes and keep the index rather than calling this per frame.
+        //! @param boneName the name of the bone
+        //! @return the joint index of the bone, InvalidBoneId if there is no actor instance or no bone with that name
         int32_t GetBoneIdByName(const char* boneName) const;
 
+        //! Adds a handler invoked whenever the actor instance is created or destroyed, previously resolved bone ids must be resolved again.
+        //! @param handler the handler to add
+        void AddActorChangedEventHandler(AZ::Event<>::Handler& handler);
+
         bool GetJointTransformByName(const char* boneName, AZ::Transform& outJointTransform) const;
         bool GetJointTransformById(int32_t boneId, AZ::Transform& outJointTransform) const;
 
     private:
         void OnPreRender(float deltaTime);
+        void SetActor(const EMotionFX::Actor* actor);
 
         //! EMotionFX::Integration::ActorComponentNotificationBus::Handler
         //! @{
@@ -69,6 +79,8 @@ namespace MultiplayerSample
         EMotionFX::Integration::ActorComponentRequests* m_actorRequests = nullptr;
         EMotionFX::AnimGraphComponentNetworkRequests* m_networkRequests = nullptr;
         EMotionFX::Integration::AnimGraphComponentRequests* m_animationGraph = nullptr;
+        const EMotionFX::Actor* m_actor = nullptr; // Actor of the current actor instance, referenced in the bone index cache
+        AZ::Event<> m_actorChangedEvent;
 
         // Hardcoded parameters, be nice if this was flexible and configurable from within the editor
         size_t m_movementDirectionParamId = InvalidParamIndex;
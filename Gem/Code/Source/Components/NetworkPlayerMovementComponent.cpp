@@ -12,8 +12,13 @@
 #include <Source/Components/NetworkAnimationComponent.h>
 #include <Source/Components/NetworkMatchComponent.h>
 #include <Source/Components/NetworkSimplePlayerCameraComponent.h>
+#include <Source/Components/PredictionStats.h>
+#include <Source/MultiplayerSampleTypes.h>
+#include <Source/Weapons/SceneQuery.h>
 #include <Multiplayer/Components/NetworkTransformComponent.h>
+#include <AzCore/Console/ILogger.h>
 #include <AzCore/Time/ITime.h>
+#include <AzCore/std/chrono/chrono.h>
 #include <AzFramework/Components/CameraBus.h>
 #include <AzFramework/Physics/SystemBus.h>
 #include <AzFramework/Physics/PhysicsScene.h>
@@ -42,6 +47,123 @@ namespace MultiplayerSample
      * Keep the ranges and the precision of QuantizedValues and float types in mind when modifying mouse input configuration values.
      */
     AZ_CVAR(float, cl_MaxMouseDelta, 128.0f, nullptr, AZ::ConsoleFunctorFlags::Null, "The sum of mouse deltas will be clamped to this maximum");
+    AZ_CVAR(bool, bg_ReuseGroundContact, true, nullptr, AZ::ConsoleFunctorFlags::Null, "If true, player slope headings probe a short range around the extended plane of the last ground contact before falling back to the full step height probe");
+    AZ_CVAR(float, bg_GroundContactReuseDistance, 0.5f, nullptr, AZ::ConsoleFunctorFlags::Null, "The horizontal distance in meters from the last ground contact within which its plane places the slope heading probe");
+
+    AZ_CVAR(bool, cl_MovementPartialReplay, true, nullptr, AZ::ConsoleFunctorFlags::Null, "If true, corrected inputs that start from the state they were predicted from restore their predicted result instead of moving again");
+    AZ_CVAR(float, cl_MovementReplayTolerance, 0.001f, nullptr, AZ::ConsoleFunctorFlags::Null, "The largest difference in position, velocity, aim or timers for a replayed input to count as starting from its predicted state");
+
+#if MPS_DIAGNOSTICS
+    //! Counters for locally predicted movement inputs, accumulated since startup.
+    struct MovementReplayStats
+    {
+        uint64_t m_simulatedCount = 0;   // Inputs moved by the character, predicted for the first time or resimulated
+        uint64_t m_resimulatedCount = 0; // Replayed inputs that diverged from their prediction and had to be moved again
+        uint64_t m_restoredCount = 0;    // Replayed inputs restored from their predicted result
+        float m_simulatedUs = 0.0f;
+    };
+    static MovementReplayStats s_movementReplayStats;
+#endif
+
+    bool MovementSnapshot::IsWithinTolerance(const MovementSnapshot& rhs, float tolerance) const
+    {
+        return (m_onGround == rhs.m_onGround)
+            && (m_wasOnGround == rhs.m_wasOnGround)
+            && (m_isJumping == rhs.m_isJumping)
+            && (m_animStates == rhs.m_animStates)
+            && m_position.IsClose(rhs.m_position, tolerance)
+            && m_aimAngles.IsClose(rhs.m_aimAngles, tolerance)
+            && m_velocityFromExternalSources.IsClose(rhs.m_velocityFromExternalSources, tolerance)
+            && m_selfGeneratedVelocity.IsClose(rhs.m_selfGeneratedVelocity, tolerance)
+            && AZ::IsClose(m_secondsSinceOnGround, rhs.m_secondsSinceOnGround, tolerance)
+            && AZ::IsClose(m_secondsSinceJumpRequest, rhs.m_secondsSinceJumpRequest, tolerance);
+    }
+
+    // Ground is sampled ahead of the player by a tiny amount, within the step height up or down
+    constexpr float SlopeForwardEpsilon = 0.01f;
+    constexpr float SlopeHeightEpsilon = 0.01f;
+    constexpr float MinGroundContactNormalZ = 0.1f; // Contacts steeper than this are walls rather than ground and are never extended
+    constexpr float GroundContactProbeHeight = 0.05f; // Distance above and below the extended contact plane a validating probe covers
+
+    //! Raycasts straight down from start for the ground below it.
+    //! @param sceneHandle the physics scene to query
+    //! @param start       the position to raycast down from
+    //! @param distance    the distance to raycast
+    //! @param outHit      the ground hit
+    //! @return true if ground was hit
+    static bool SampleGround(AzPhysics::SceneHandle sceneHandle, const AZ::Vector3& start, float distance, AzPhysics::SceneQueryHit& outHit)
+    {
+        auto* sceneInterface = AZ::Interface<AzPhysics::SceneInterface>::Get();
+        if ((sceneInterface == nullptr) || (sceneHandle == AzPhysics::InvalidSceneHandle))
+        {
+            return false;
+        }
+
+        AzPhysics::RayCastRequest request;
+        request.m_start = start;
+        request.m_direction = AZ::Vector3::CreateAxisZ(-1.f);
+        request.m_distance = distance;
+        request.m_queryType = AzPhysics::SceneQuery::QueryType::Static;
+
+        AzPhysics::SceneQueryHits result = sceneInterface->QueryScene(sceneHandle, &request);
+        if (result && result.m_hits[0].IsValid())
+        {
+            outHit = result.m_hits[0];
+            return true;
+        }
+        return false;
+    }
+
+    //! Extends the plane of a ground contact to the ground height below a query position.
+    //! @param contactPoint   a point on the ground
+    //! @param contactNormal  the ground normal at contactPoint
+    //! @param queryPosition  the position to find the ground below, only its XY is used
+    //! @param outGroundPoint the point on the contact plane below queryPosition
+    //! @return false if the query position is too far from the contact or the contact is too steep to extend
+    static bool ExtendGroundContact(const AZ::Vector3& contactPoint, const AZ::Vector3& contactNormal, const AZ::Vector3& queryPosition, AZ::Vector3& outGroundPoint)
+    {
+        if (contactNormal.GetZ() < MinGroundContactNormalZ)
+        {
+            return false;
+        }
+
+        const float deltaX = queryPosition.GetX() - contactPoint.GetX();
+        const float deltaY = queryPosition.GetY() - contactPoint.GetY();
+        const float reuseDistance = bg_GroundContactReuseDistance;
+        if ((deltaX * deltaX + deltaY * deltaY) > (reuseDistance * reuseDistance))
+        {
+            return false;
+        }
+
+        const float groundZ = contactPoint.GetZ() - (contactNormal.GetX() * deltaX + contactNormal.GetY() * deltaY) / contactNormal.GetZ();
+        outGroundPoint = AZ::Vector3(queryPosition.GetX(), queryPosition.GetY(), groundZ);
+        return true;
+    }
+
+    //! Finds the ground ahead of the player within the step height, first probing a short range around the extended plane of the last
+    //! ground contact. The plane is only used to place the probe, ground is always taken from a hit so step downs and ledges ahead of
+    //! the player, where the plane no longer matches the geometry, miss the short probe and fall back to the full step height probe.
+    //! @param sceneHandle     the physics scene to query
+    //! @param contact         the last ground contact, or nullptr if there is none
+    //! @param origin          the bottom of the player
+    //! @param ahead           the position ahead of the player to find the ground below
+    //! @param sampleHeight    the distance above and below origin to accept ground within
+    //! @param outHit          the ground hit
+    //! @return true if ground was hit
+    static bool SampleGroundAhead(AzPhysics::SceneHandle sceneHandle, const AzPhysics::SceneQueryHit* contact, const AZ::Vector3& origin,
+        const AZ::Vector3& ahead, float sampleHeight, AzPhysics::SceneQueryHit& outHit)
+    {
+        AZ::Vector3 extendedPoint;
+        if ((contact != nullptr) && ExtendGroundContact(contact->m_position, contact->m_normal, ahead, extendedPoint)
+            && (AZStd::abs(extendedPoint.GetZ() - origin.GetZ()) <= sampleHeight)
+            && SampleGround(sceneHandle, extendedPoint + AZ::Vector3(0.f, 0.f, GroundContactProbeHeight), GroundContactProbeHeight * 2.f, outHit))
+        {
+            return true;
+        }
+
+        // Raycast straight down starting at the step height plus an epsilon and ending at negative step height plus an epsilon.
+        return SampleGround(sceneHandle, ahead + AZ::Vector3(0.f, 0.f, sampleHeight), sampleHeight * 2.f, outHit);
+    }
 
 #if AZ_TRAIT_CLIENT
     AZ_CVAR(bool, mps_botMode, false, nullptr, AZ::ConsoleFunctorFlags::Null, "If true, enable bot (AI) mode for client.");
@@ -49,6 +171,27 @@ namespace MultiplayerSample
     AZ_CVAR(float, mps_botMaxInterval, 9500.0f, nullptr, AZ::ConsoleFunctorFlags::Null, "The maximum amount of time between bot control updates");
 #endif
 
+    //! Sets the movement driven animation states for a processed input.
+    //! @param frameContext    the movement state of the input
+    //! @param sprint          whether the input is sprinting
+    //! @param crouch          whether the input is crouching
+    //! @param inOutAnimStates the animation states to update, bits not driven by movement are left untouched
+    static void ApplyMovementAnimStates(const MovementFrameContext& frameContext, bool sprint, bool crouch, CharacterAnimStateBitset& inOutAnimStates)
+    {
+        inOutAnimStates.SetBit(aznumeric_cast<uint32_t>(CharacterAnimState::Sprinting), sprint);
+        inOutAnimStates.SetBit(aznumeric_cast<uint32_t>(CharacterAnimState::Crouching), crouch);
+
+        // The Landing anim state will automatically turn off after it's triggered
+        inOutAnimStates.SetBit(aznumeric_cast<uint32_t>(CharacterAnimState::Landing), frameContext.m_onGround && !frameContext.m_wasOnGround && !frameContext.m_jumpTriggered);
+
+        // Always set/clear the jump state every tick or you might get ghost jump animations.
+        // We only set it on the tick where the jump is first triggered, not for the entire jump.
+        inOutAnimStates.SetBit(aznumeric_cast<uint32_t>(CharacterAnimState::Jumping), frameContext.m_jumpTriggered);
+
+        // Set whether or not we're currently falling.
+        inOutAnimStates.SetBit(aznumeric_cast<uint32_t>(CharacterAnimState::Falling), !frameContext.m_onGround);
+    }
+
     NetworkPlayerMovementComponentController::NetworkPlayerMovementComponentController(NetworkPlayerMovementComponent& parent)
         : NetworkPlayerMovementComponentControllerBase(parent)
 #if AZ_TRAIT_SERVER		
@@ -70,6 +213,7 @@ namespace MultiplayerSample
         {
             m_updateAI.Enqueue(AZ::TimeMs{ 0 }, true);
             m_networkAiComponentController = GetNetworkAiComponentController();
+            m_botMovementBatch = GetBotMovementBatch();
         }
 #endif
 
@@ -114,6 +258,12 @@ namespace MultiplayerSample
 
     void NetworkPlayerMovementComponentController::OnDeactivate([[maybe_unused]] Multiplayer::EntityIsMigrating entityIsMigrating)
     {
+        if (m_botMovementBatch != nullptr)
+        {
+            m_botMovementBatch->Cancel(*this);
+            m_botMovementBatch = nullptr;
+        }
+
 #if AZ_TRAIT_CLIENT
         if (IsNetEntityRoleAutonomous() && !mps_botMode)
         {
@@ -127,6 +277,7 @@ namespace MultiplayerSample
         // Wait until the character is activated before requesting its parameters.
         Physics::CharacterRequestBus::EventResult(m_stepHeight, GetEntityId(), &Physics::CharacterRequestBus::Events::GetStepHeight);
         PhysX::CharacterControllerRequestBus::EventResult(m_radius, GetEntityId(), &PhysX::CharacterControllerRequestBus::Events::GetRadius);
+        PhysX::CharacterControllerRequestBus::EventResult(m_height, GetEntityId(), &PhysX::CharacterControllerRequestBus::Events::GetHeight);
         PhysX::CharacterGameplayRequestBus::EventResult(
             m_gravityMultiplier, GetEntityId(), &PhysX::CharacterGameplayRequestBus::Events::GetGravityMultiplier);
 
@@ -140,7 +291,8 @@ namespace MultiplayerSample
 
         // Check current game-play state
         INetworkMatch* networkMatchComponent = AZ::Interface<INetworkMatch>::Get();
-        if (networkMatchComponent && (networkMatchComponent->PlayerActionsAllowed() != AllowedPlayerActions::None))
+        const AllowedPlayerActions allowedActions = networkMatchComponent ? networkMatchComponent->PlayerActionsAllowed() : AllowedPlayerActions::None;
+        if (allowedActions != AllowedPlayerActions::None)
         {
             // View Axis are clamped and brought into the -1,1 range for transport across the network.
             // These are set if the player actions allow for rotation and/or all movement.
@@ -152,7 +304,7 @@ namespace MultiplayerSample
         m_viewYaw = 0.f;
         m_viewPitch = 0.f;
 
-        if (networkMatchComponent && (networkMatchComponent->PlayerActionsAllowed() == AllowedPlayerActions::All))
+        if (allowedActions == AllowedPlayerActions::All)
         {
             // Check if the user requested to toggle sprint-state
             if (m_toggleSprint)
@@ -207,8 +359,18 @@ namespace MultiplayerSample
         NetworkPlayerMovementComponentNetworkInput* playerInput = input.FindComponentInput<NetworkPlayerMovementComponentNetworkInput>();
         if (playerInput->m_resetCount != GetNetworkTransformComponentController()->GetResetCount())
         {
+            // Count each run of discarded inputs once rather than every input in it
+            if (!m_isDiscardingResetInputs)
+            {
+                m_isDiscardingResetInputs = true;
+                if (PredictionStats* predictionStats = GetPredictionStats())
+                {
+                    predictionStats->RecordCorrection(CorrectionCause::ResetCount);
+                }
+            }
             return;
         }
+        m_isDiscardingResetInputs = false;
 
         NetworkWeaponsComponentNetworkInput* weaponInput = input.FindComponentInput<NetworkWeaponsComponentNetworkInput>();
         if ((weaponInput != nullptr) && weaponInput->m_firing.AnySet())
@@ -218,72 +380,251 @@ namespace MultiplayerSample
             playerInput->m_sprint = false;
         }
 
-        const bool wasOnGround = GetWasOnGround();
-        bool onGround = GetOnGround();
+        if (!IsNetEntityRoleAutonomous())
+        {
+            if (m_aiEnabled)
+            {
+                SimulateBotInput(*playerInput, deltaTime);
+            }
+            else
+            {
+                SimulateInput(*playerInput, deltaTime);
+            }
+            return;
+        }
+
+        // Corrections replay every input since the corrected frame, but inputs that start from the state they were first predicted from
+        // can only end in the state they were predicted to end in. Those are restored from history instead of being moved again.
+        // The first replayed input always moves again, it starts from the server's corrected state which the snapshot only partly describes.
+        const Multiplayer::ClientInputId clientInputId = input.GetClientInputId();
+        PredictedInput& predictedInput = m_predictedInputHistory[aznumeric_cast<uint32_t>(clientInputId) % PredictedInputHistorySize];
+        const bool isReprocessing = GetNetBindComponent()->IsReprocessingInput();
+        const bool isFirstReplayedInput = isReprocessing && !m_isReplayingCorrection;
+        TrackCorrection(predictedInput, clientInputId, isReprocessing);
+        if (isReprocessing && !isFirstReplayedInput && cl_MovementPartialReplay && (predictedInput.m_clientInputId == clientInputId))
+        {
+            if (CaptureMovementSnapshot().IsWithinTolerance(predictedInput.m_preState, cl_MovementReplayTolerance))
+            {
+                ApplyMovementSnapshot(predictedInput.m_postState);
+                GetNetworkSimplePlayerCameraComponentController()->SetSprintMode(playerInput->m_sprint);
+#if MPS_DIAGNOSTICS
+                ++s_movementReplayStats.m_restoredCount;
+#endif
+                return;
+            }
+        }
+
+        predictedInput.m_clientInputId = clientInputId;
+        predictedInput.m_preState = CaptureMovementSnapshot();
+
+#if MPS_DIAGNOSTICS
+        const auto start = AZStd::chrono::steady_clock::now();
+#endif
+        if (m_aiEnabled)
+        {
+            SimulateBotInput(*playerInput, deltaTime);
+        }
+        else
+        {
+            SimulateInput(*playerInput, deltaTime);
+        }
+#if MPS_DIAGNOSTICS
+        ++s_movementReplayStats.m_simulatedCount;
+        s_movementReplayStats.m_simulatedUs += aznumeric_cast<float>(AZStd::chrono::duration_cast<AZStd::chrono::nanoseconds>(AZStd::chrono::steady_clock::now() - start).count()) / 1000.0f;
+        s_movementReplayStats.m_resimulatedCount += isReprocessing ? 1 : 0;
+#endif
+
+        predictedInput.m_postState = CaptureMovementSnapshot();
+    }
+
+    void NetworkPlayerMovementComponentController::SimulateBotInput(const NetworkPlayerMovementComponentNetworkInput& playerInput, float deltaTime)
+    {
+#if MPS_DIAGNOSTICS
+        // Bot input cost feeds the bot movement batch comparison, player inputs aren't timed
+        const auto start = AZStd::chrono::steady_clock::now();
+        SimulateInput(playerInput, deltaTime);
+        const float elapsedUs = aznumeric_cast<float>(AZStd::chrono::duration_cast<AZStd::chrono::nanoseconds>(AZStd::chrono::steady_clock::now() - start).count()) / 1000.0f;
+
+        if (BotMovementBatch* botMovementBatch = AZ::Interface<BotMovementBatch>::Get())
+        {
+            botMovementBatch->RecordBotInput(m_botMovementBatch != nullptr, elapsedUs);
+        }
+#else
+        SimulateInput(playerInput, deltaTime);
+#endif
+    }
+
+    void NetworkPlayerMovementComponentController::SimulateInput(const NetworkPlayerMovementComponentNetworkInput& playerInput, float deltaTime)
+    {
+        MovementFrameContext frameContext;
+        frameContext.m_wasOnGround = GetWasOnGround();
+        frameContext.m_onGround = GetOnGround();
 
         // Update the "on ground" state for the character.
-        PhysX::CharacterGameplayRequestBus::EventResult(onGround, GetEntityId(), &PhysX::CharacterGameplayRequestBus::Events::IsOnGround);
-        SetOnGround(onGround);
+        // Kinematic bots have no controller state to query, their grounded state was set when the bot movement batch last moved them.
+        if (m_botMovementBatch == nullptr)
+        {
+            PhysX::CharacterGameplayRequestBus::EventResult(frameContext.m_onGround, GetEntityId(), &PhysX::CharacterGameplayRequestBus::Events::IsOnGround);
+            SetOnGround(frameContext.m_onGround);
+        }
 
         // Track timers for how recently it's been since the player was on the ground and how recently they pressed the jump button.
         // These will be compared against "slop factors" to allow for a little bit of leniency in jumping to make it feel more reactive.
-        SetSecondsSinceOnGround(onGround ? 0.0f : (GetSecondsSinceOnGround() + deltaTime));
-        SetSecondsSinceJumpRequest(playerInput->m_jump ? 0.0f : (GetSecondsSinceJumpRequest() + deltaTime));
+        SetSecondsSinceOnGround(frameContext.m_onGround ? 0.0f : (GetSecondsSinceOnGround() + deltaTime));
+        SetSecondsSinceJumpRequest(playerInput.m_jump ? 0.0f : (GetSecondsSinceJumpRequest() + deltaTime));
 
         // Update orientation
-        AZ::Vector3 aimAngles = GetNetworkSimplePlayerCameraComponentController()->GetAimAngles();
-        aimAngles.SetZ(NormalizeHeading(aimAngles.GetZ() - playerInput->m_viewYaw * cl_AimStickScaleZ * cl_MaxMouseDelta));
-        aimAngles.SetX(NormalizeHeading(aimAngles.GetX() - playerInput->m_viewPitch * cl_AimStickScaleX * cl_MaxMouseDelta));
-        aimAngles.SetX(NormalizeHeading(AZ::GetClamp(aimAngles.GetX(), -AZ::Constants::QuarterPi * 1.5f, AZ::Constants::QuarterPi * 1.5f)));
-        GetNetworkSimplePlayerCameraComponentController()->SetAimAngles(aimAngles);
-
-        const AZ::Quaternion newOrientation = AZ::Quaternion::CreateRotationZ(aimAngles.GetZ());
+        NetworkSimplePlayerCameraComponentController* cameraController = GetNetworkSimplePlayerCameraComponentController();
+        frameContext.m_aimAngles = cameraController->GetAimAngles();
+        frameContext.m_aimAngles.SetZ(NormalizeHeading(frameContext.m_aimAngles.GetZ() - playerInput.m_viewYaw * cl_AimStickScaleZ * cl_MaxMouseDelta));
+        frameContext.m_aimAngles.SetX(NormalizeHeading(frameContext.m_aimAngles.GetX() - playerInput.m_viewPitch * cl_AimStickScaleX * cl_MaxMouseDelta));
+        frameContext.m_aimAngles.SetX(NormalizeHeading(AZ::GetClamp(frameContext.m_aimAngles.GetX(), -AZ::Constants::QuarterPi * 1.5f, AZ::Constants::QuarterPi * 1.5f)));
+        cameraController->SetAimAngles(frameContext.m_aimAngles);
+
+        const AZ::Quaternion newOrientation = AZ::Quaternion::CreateRotationZ(frameContext.m_aimAngles.GetZ());
         GetEntity()->GetTransform()->SetLocalRotationQuaternion(newOrientation);
 
         // Update velocity
-        bool jumpTriggered = false;
-        bool movingDownward = false;
-        UpdateVelocity(*playerInput, deltaTime, jumpTriggered, movingDownward);
+        UpdateVelocity(playerInput, deltaTime, frameContext);
 
         // absolute velocity is based on velocity generated by the player and other sources
         const AZ::Vector3 absoluteVelocity = GetVelocityFromExternalSources() + GetSelfGeneratedVelocity();
 
-        GetNetworkCharacterComponentController()->TryMoveWithVelocity(absoluteVelocity, deltaTime);
+        if (m_botMovementBatch != nullptr)
+        {
+            m_botMovementBatch->EnqueueMove(*GetEntity(), absoluteVelocity, deltaTime, m_radius, m_height, m_stepHeight, *this);
+        }
+        else
+        {
+            GetNetworkCharacterComponentController()->TryMoveWithVelocity(absoluteVelocity, deltaTime);
+        }
 
         // If a jump was triggered, reset our jump request time to our "slop threshold" so that we don't double-count the jump request
         // if we land too quickly.
-        if (jumpTriggered)
+        if (frameContext.m_jumpTriggered)
         {
             SetSecondsSinceJumpRequest(GetJumpPressQueuedSeconds());
         }
 
         // Tell the camera whether or not we're sprinting
-        GetNetworkSimplePlayerCameraComponentController()->SetSprintMode(playerInput->m_sprint);
-        GetNetworkAnimationComponentController()->ModifyActiveAnimStates().SetBit(aznumeric_cast<uint32_t>(CharacterAnimState::Sprinting), playerInput->m_sprint);
-        GetNetworkAnimationComponentController()->ModifyActiveAnimStates().SetBit(aznumeric_cast<uint32_t>(CharacterAnimState::Crouching), playerInput->m_crouch);
-
-        // The Landing anim state will automatically turn off after it's triggered
-        GetNetworkAnimationComponentController()->ModifyActiveAnimStates().SetBit(aznumeric_cast<uint32_t>(CharacterAnimState::Landing), onGround && !wasOnGround && !jumpTriggered);
+        cameraController->SetSprintMode(playerInput.m_sprint);
 
-        // Always set/clear the jump state every tick or you might get ghost jump animations.
-        // We only set it on the tick where the jump is first triggered, not for the entire jump.
-        GetNetworkAnimationComponentController()->ModifyActiveAnimStates().SetBit(aznumeric_cast<uint32_t>(CharacterAnimState::Jumping), jumpTriggered);
+        // Animation states are committed in a single write so the replicated bitset is only marked dirty when a bit actually changes
+        CharacterAnimStateBitset animStates = GetNetworkAnimationComponentController()->GetActiveAnimStates();
+        ApplyMovementAnimStates(frameContext, playerInput.m_sprint, playerInput.m_crouch, animStates);
+        if (animStates != GetNetworkAnimationComponentController()->GetActiveAnimStates())
+        {
+            GetNetworkAnimationComponentController()->ModifyActiveAnimStates() = animStates;
+        }
 
-        // Set whether or not we're currently falling.
-        GetNetworkAnimationComponentController()->ModifyActiveAnimStates().SetBit(aznumeric_cast<uint32_t>(CharacterAnimState::Falling), !onGround);
+        // Kinematic bots are moved at the end of the tick, OnBotMoveComplete finishes their input
+        if (m_botMovementBatch != nullptr)
+        {
+            return;
+        }
 
         // If we're still on the ground, then zero out our velocity from external forces
         // This prevents us from sliding along the ground after we land
-        PhysX::CharacterGameplayRequestBus::EventResult(onGround, GetEntityId(), &PhysX::CharacterGameplayRequestBus::Events::IsOnGround);
-        if (onGround)
+        // The character has moved since the last query, so this has to ask the character controller again
+        bool onGroundAfterMove = frameContext.m_onGround;
+        PhysX::CharacterGameplayRequestBus::EventResult(onGroundAfterMove, GetEntityId(), &PhysX::CharacterGameplayRequestBus::Events::IsOnGround);
+        if (onGroundAfterMove)
         {
             SetVelocityFromExternalSources(AZ::Vector3::CreateZero());
         }
 
         // At the end, track whether or not we were on the ground for this input so we can compare states when processing the next input.
+        SetWasOnGround(onGroundAfterMove);
+    }
+
+    void NetworkPlayerMovementComponentController::OnBotMoveComplete(bool onGround)
+    {
+        if (onGround)
+        {
+            SetVelocityFromExternalSources(AZ::Vector3::CreateZero());
+        }
+        SetOnGround(onGround);
         SetWasOnGround(onGround);
     }
 
+    void NetworkPlayerMovementComponentController::TrackCorrection(const PredictedInput& predictedInput, Multiplayer::ClientInputId clientInputId, bool isReprocessing)
+    {
+        PredictionStats* predictionStats = GetPredictionStats();
+        if (!isReprocessing)
+        {
+            // The first new input after a replay ends the correction
+            if (m_isReplayingCorrection && (predictionStats != nullptr))
+            {
+                predictionStats->RecordReplay(m_correctionReplayCount);
+            }
+            m_isReplayingCorrection = false;
+            return;
+        }
+
+        if (!m_isReplayingCorrection)
+        {
+            // The first replayed input starts from the corrected state, compare it against what was predicted for the same input
+            m_isReplayingCorrection = true;
+            m_correctionReplayCount = 0;
+            if ((predictionStats != nullptr) && (predictedInput.m_clientInputId == clientInputId))
+            {
+                const MovementSnapshot corrected = CaptureMovementSnapshot();
+                const MovementSnapshot& predicted = predictedInput.m_preState;
+                const float tolerance = cl_MovementReplayTolerance;
+
+                CorrectionCause cause = CorrectionCause::PositionDivergence;
+                if ((corrected.m_onGround != predicted.m_onGround) || (corrected.m_wasOnGround != predicted.m_wasOnGround) || (corrected.m_isJumping != predicted.m_isJumping))
+                {
+                    cause = CorrectionCause::GroundDivergence;
+                }
+                else if (!corrected.m_selfGeneratedVelocity.IsClose(predicted.m_selfGeneratedVelocity, tolerance)
+                    || !corrected.m_velocityFromExternalSources.IsClose(predicted.m_velocityFromExternalSources, tolerance))
+                {
+                    cause = CorrectionCause::VelocityDivergence;
+                }
+                predictionStats->RecordCorrection(cause, corrected.m_position.GetDistance(predicted.m_position));
+            }
+        }
+        ++m_correctionReplayCount;
+    }
+
+    MovementSnapshot NetworkPlayerMovementComponentController::CaptureMovementSnapshot() const
+    {
+        MovementSnapshot snapshot;
+        snapshot.m_position = GetEntity()->GetTransform()->GetWorldTranslation();
+        snapshot.m_aimAngles = GetNetworkSimplePlayerCameraComponentController()->GetAimAngles();
+        snapshot.m_velocityFromExternalSources = GetVelocityFromExternalSources();
+        snapshot.m_selfGeneratedVelocity = GetSelfGeneratedVelocity();
+        snapshot.m_animStates = GetNetworkAnimationComponentController()->GetActiveAnimStates();
+        snapshot.m_secondsSinceOnGround = GetSecondsSinceOnGround();
+        snapshot.m_secondsSinceJumpRequest = GetSecondsSinceJumpRequest();
+        snapshot.m_onGround = GetOnGround();
+        snapshot.m_wasOnGround = GetWasOnGround();
+        snapshot.m_isJumping = GetIsJumping();
+        return snapshot;
+    }
+
+    void NetworkPlayerMovementComponentController::ApplyMovementSnapshot(const MovementSnapshot& snapshot)
+    {
+        // The physics character doesn't follow the transform on its own, it has to be moved along with it
+        GetEntity()->GetTransform()->SetWorldTranslation(snapshot.m_position);
+        GetEntity()->GetTransform()->SetLocalRotationQuaternion(AZ::Quaternion::CreateRotationZ(snapshot.m_aimAngles.GetZ()));
+        Physics::CharacterRequestBus::Event(GetEntityId(), &Physics::CharacterRequestBus::Events::SetBasePosition, snapshot.m_position);
+
+        GetNetworkSimplePlayerCameraComponentController()->SetAimAngles(snapshot.m_aimAngles);
+        SetVelocityFromExternalSources(snapshot.m_velocityFromExternalSources);
+        SetSelfGeneratedVelocity(snapshot.m_selfGeneratedVelocity);
+        SetSecondsSinceOnGround(snapshot.m_secondsSinceOnGround);
+        SetSecondsSinceJumpRequest(snapshot.m_secondsSinceJumpRequest);
+        SetOnGround(snapshot.m_onGround);
+        SetWasOnGround(snapshot.m_wasOnGround);
+        SetIsJumping(snapshot.m_isJumping);
+        if (snapshot.m_animStates != GetNetworkAnimationComponentController()->GetActiveAnimStates())
+        {
+            GetNetworkAnimationComponentController()->ModifyActiveAnimStates() = snapshot.m_animStates;
+        }
+    }
+
 #if AZ_TRAIT_SERVER
     void NetworkPlayerMovementComponentController::HandleApplyImpulse([[maybe_unused]] AzNetworking::IConnection* connection, const AZ::Vector3& impulse, const bool& external)
     {
@@ -312,7 +653,7 @@ namespace MultiplayerSample
     }
 #endif
 
-    void NetworkPlayerMovementComponentController::UpdateVelocity(const NetworkPlayerMovementComponentNetworkInput& playerInput, float deltaTime, bool& jumpTriggered, bool& movingDownward)
+    void NetworkPlayerMovementComponentController::UpdateVelocity(const NetworkPlayerMovementComponentNetworkInput& playerInput, float deltaTime, MovementFrameContext& frameContext)
     {
         AZ::Vector3 velocityFromExternalSources = GetVelocityFromExternalSources(); // non-player generated (jump pads, explosions etc.)
         AZ::Vector3 selfGeneratedVelocity = GetSelfGeneratedVelocity(); // player generated
@@ -320,9 +661,7 @@ namespace MultiplayerSample
         const float secondsSinceOnGround = GetSecondsSinceOnGround();
         const float secondsSinceJumpRequest = GetSecondsSinceJumpRequest();
 
-        const bool onGround = GetOnGround();
-
-        if (onGround)
+        if (frameContext.m_onGround)
         {
             // Reset our jumping state if we're on the ground.
             if (GetIsJumping())
@@ -370,7 +709,7 @@ namespace MultiplayerSample
                         // even while in midair.
                         const float initialJumpVelocity = AZ::Sqrt(2.0f * (-m_gravity * m_gravityMultiplier) * GetMaxJumpHeight());
                         selfGeneratedVelocity.SetZ(initialJumpVelocity);
-                        jumpTriggered = true;
+                        frameContext.m_jumpTriggered = true;
                         SetIsJumping(true);
 
                         GameplayEffectsNotificationBus::Broadcast(&GameplayEffectsNotificationBus::Events::OnPositionalEffect,
@@ -448,7 +787,7 @@ namespace MultiplayerSample
                 // we can distinguish this state from arbitrary falling.
                 if (moveVelocity.GetZ() < 0.0f)
                 {
-                    movingDownward = true;
+                    frameContext.m_movingDownward = true;
                 }
             }
         }
@@ -463,7 +802,7 @@ namespace MultiplayerSample
         SetSelfGeneratedVelocity(selfGeneratedVelocity);
     }
 
-    AZ::Vector3 NetworkPlayerMovementComponentController::GetSlopeHeading(float headingAngleRadians) const
+    AZ::Vector3 NetworkPlayerMovementComponentController::GetSlopeHeading(float headingAngleRadians)
     {
         // Returns a unit vector pointing in the direction that the player is moving.
 
@@ -472,39 +811,49 @@ namespace MultiplayerSample
 
         // The origin is set to the bottom of the player, not the center.
         const AZ::Vector3 origin = GetEntity()->GetTransform()->GetWorldTranslation();
-        constexpr float forwardEpsilon = 0.01f;
-        constexpr float heightEpsilon = 0.01f;
 
-        // Raycast straight down in front of the player by a tiny amount (forwardEpsilon) starting at the step height plus an epsilon
-        // and ending at negative step height plus an epsilon. This will tell us if there's any surface directly in front of the player
-        // within the step height up or down. If so, we'll use that to calculate the Z direction.
-        const AZ::Vector3 start = origin + fwd * (m_radius + forwardEpsilon) + AZ::Vector3(0.f, 0.f, m_stepHeight + heightEpsilon);
+        // Look for ground directly in front of the player by a tiny amount (SlopeForwardEpsilon), within the step height plus an epsilon
+        // up or down. If there is any, we'll use that to calculate the Z direction.
+        const AZ::Vector3 ahead = origin + fwd * (m_radius + SlopeForwardEpsilon);
+        const float sampleHeight = m_stepHeight + SlopeHeightEpsilon;
 
-        AzPhysics::RayCastRequest request;
-        request.m_start = start;
-        request.m_direction = AZ::Vector3::CreateAxisZ(-1.f);
-        request.m_distance = (m_stepHeight + heightEpsilon) * 2.f;
-        request.m_queryType = AzPhysics::SceneQuery::QueryType::Static;
-
-        AzPhysics::SceneQueryHits result;
-        if (auto* sceneInterface = AZ::Interface<AzPhysics::SceneInterface>::Get())
+        AZ::Vector3 groundPoint;
+        bool foundGround = false;
+        if (m_botMovementBatch != nullptr)
+        {
+            // Kinematic bots sample the same range from the cached ground grid
+            AZ::Vector3 groundNormal;
+            foundGround = m_botMovementBatch->SampleGround(ahead + AZ::Vector3(0.f, 0.f, sampleHeight), sampleHeight * 2.f, groundPoint, groundNormal);
+        }
+        else
         {
-            if (AzPhysics::SceneHandle sceneHandle = sceneInterface->GetSceneHandle(AzPhysics::DefaultPhysicsSceneName);
-                sceneHandle != AzPhysics::InvalidSceneHandle)
+            // While grounded, the last contact narrows the probe. Either way the ground comes from a hit, so replays that start
+            // without the contact the input was first predicted with still find the same ground.
+            AzPhysics::SceneQueryHit contact;
+            contact.m_position = m_groundContactPoint;
+            contact.m_normal = m_groundContactNormal;
+            const bool useContact = bg_ReuseGroundContact && GetOnGround() && m_hasGroundContact;
+
+            AzPhysics::SceneQueryHit hit;
+            foundGround = SampleGroundAhead(SceneQuery::GetDefaultSceneHandle(), useContact ? &contact : nullptr, origin, ahead, sampleHeight, hit);
+            m_hasGroundContact = foundGround;
+            if (foundGround)
             {
-                result = sceneInterface->QueryScene(sceneHandle, &request);
+                groundPoint = hit.m_position;
+                m_groundContactPoint = hit.m_position;
+                m_groundContactNormal = hit.m_normal;
             }
         }
 
         // If we've found a surface in front of us that's within the step height in size in either direction, then we'll create a vector
         // from the current bottom of the player to that new location so that our heading direction accounts for the Z slope.
-        if (result && result.m_hits[0].IsValid())
+        if (foundGround)
         {
             // we use epsilon here to avoid the case where we are pushing up against an object and become slightly
             // elevated
-            if (result.m_hits[0].m_position.GetZ() < (origin.GetZ() - heightEpsilon))
+            if (groundPoint.GetZ() < (origin.GetZ() - SlopeHeightEpsilon))
             {
-                const AZ::Vector3 delta = result.m_hits[0].m_position - origin;
+                const AZ::Vector3 delta = groundPoint - origin;
                 return delta.GetNormalized();
             }
         }
@@ -525,106 +874,119 @@ namespace MultiplayerSample
         return heading;
     }
 
-    void NetworkPlayerMovementComponentController::OnPressed(float value)
+    const InputActionMap<MovementInputAction>& GetMovementInputActions()
     {
-        const StartingPointInput::InputEventNotificationId* inputId = StartingPointInput::InputEventNotificationBus::GetCurrentBusId();
+        static const InputActionMap<MovementInputAction> movementInputActions
+        {
+            { MoveFwdEventId, MovementInputAction::MoveFwd },
+            { MoveBackEventId, MovementInputAction::MoveBack },
+            { MoveLeftEventId, MovementInputAction::MoveLeft },
+            { MoveRightEventId, MovementInputAction::MoveRight },
+            { SprintEventId, MovementInputAction::Sprint },
+            { JumpEventId, MovementInputAction::Jump },
+            { CrouchEventId, MovementInputAction::Crouch },
+            { LookLeftRightEventId, MovementInputAction::LookLeftRight },
+            { LookUpDownEventId, MovementInputAction::LookUpDown },
+        };
+        return movementInputActions;
+    }
 
-        if (inputId == nullptr)
+    void NetworkPlayerMovementComponentController::OnPressed(float value)
+    {
+        MovementInputAction action;
+        if (!GetMovementInputActions().TryGetAction(StartingPointInput::InputEventNotificationBus::GetCurrentBusId(), action))
         {
             return;
         }
-        else if (*inputId == MoveFwdEventId)
+
+        switch (action)
         {
+        case MovementInputAction::MoveFwd:
             m_forwardDown = true;
-        }
-        else if (*inputId == MoveBackEventId)
-        {
+            break;
+        case MovementInputAction::MoveBack:
             m_backwardDown = true;
-        }
-        else if (*inputId == MoveLeftEventId)
-        {
+            break;
+        case MovementInputAction::MoveLeft:
             m_leftDown = true;
-        }
-        else if (*inputId == MoveRightEventId)
-        {
+            break;
+        case MovementInputAction::MoveRight:
             m_rightDown = true;
-        }
-        else if (*inputId == SprintEventId)
-        {
+            break;
+        case MovementInputAction::Sprint:
             m_toggleSprint = true;
-        }
-        else if (*inputId == JumpEventId)
-        {
+            break;
+        case MovementInputAction::Jump:
             m_jumping = true;
-        }
-        else if (*inputId == CrouchEventId)
-        {
+            break;
+        case MovementInputAction::Crouch:
             m_crouching = true;
-        }
-        else if (*inputId == LookLeftRightEventId)
-        {
+            break;
+        case MovementInputAction::LookLeftRight:
             // Accumulate input to be processed in CreateInput().
             // In-between two CreateInput() calls, multiple series of presses and holds can occur, accumulate all of them,
             // otherwise we will drop some of the input data by only including the last press and hold combination.
             m_viewYaw += value;
-        }
-        else if (*inputId == LookUpDownEventId)
-        {
+            break;
+        case MovementInputAction::LookUpDown:
             m_viewPitch += value;
+            break;
         }
     }
 
     void NetworkPlayerMovementComponentController::OnReleased([[maybe_unused]]float value)
     {
-        const StartingPointInput::InputEventNotificationId* inputId = StartingPointInput::InputEventNotificationBus::GetCurrentBusId();
-
-        if (inputId == nullptr)
+        MovementInputAction action;
+        if (!GetMovementInputActions().TryGetAction(StartingPointInput::InputEventNotificationBus::GetCurrentBusId(), action))
         {
             return;
         }
-        else if (*inputId == MoveFwdEventId)
+
+        switch (action)
         {
+        case MovementInputAction::MoveFwd:
             m_forwardDown = false;
-        }
-        else if (*inputId == MoveBackEventId)
-        {
+            break;
+        case MovementInputAction::MoveBack:
             m_backwardDown = false;
-        }
-        else if (*inputId == MoveLeftEventId)
-        {
+            break;
+        case MovementInputAction::MoveLeft:
             m_leftDown = false;
-        }
-        else if (*inputId == MoveRightEventId)
-        {
+            break;
+        case MovementInputAction::MoveRight:
             m_rightDown = false;
-        }
-        else if (*inputId == JumpEventId)
-        {
+            break;
+        case MovementInputAction::Jump:
             m_jumping = false;
-        }
-        else if (*inputId == CrouchEventId)
-        {
+            break;
+        case MovementInputAction::Crouch:
             m_crouching = false;
+            break;
+        default:
+            break;
         }
     }
 
     void NetworkPlayerMovementComponentController::OnHeld(float value)
     {
-        const StartingPointInput::InputEventNotificationId* inputId = StartingPointInput::InputEventNotificationBus::GetCurrentBusId();
-
-        if (inputId == nullptr)
+        MovementInputAction action;
+        if (!GetMovementInputActions().TryGetAction(StartingPointInput::InputEventNotificationBus::GetCurrentBusId(), action))
         {
             return;
         }
-        else if (*inputId == LookLeftRightEventId)
+
+        switch (action)
         {
+        case MovementInputAction::LookLeftRight:
             // accumulate input to be processed in CreateInput()
             m_viewYaw += value;
-        }
-        else if (*inputId == LookUpDownEventId)
-        {
+            break;
+        case MovementInputAction::LookUpDown:
             // accumulate input to be processed in CreateInput()
             m_viewPitch += value;
+            break;
+        default:
+            break;
         }
     }
 
@@ -707,4 +1069,179 @@ namespace MultiplayerSample
         }
     }
 #endif
+
+#if MPS_DIAGNOSTICS
+    static void bg_SlopeHeadingCheck(const AZ::ConsoleCommandContainer& arguments)
+    {
+        const AzPhysics::SceneHandle sceneHandle = SceneQuery::GetDefaultSceneHandle();
+        if (sceneHandle == AzPhysics::InvalidSceneHandle)
+        {
+            AZLOG_WARN("bg_SlopeHeadingCheck requires a loaded level");
+            return;
+        }
+
+        if (arguments.empty())
+        {
+            AZLOG_WARN("bg_SlopeHeadingCheck requires the entity id of a grounded player, optionally followed by a sample count");
+            return;
+        }
+
+        const AZ::EntityId entityId(AZStd::stoull(AZStd::string(arguments[0])));
+        const uint32_t sampleCount = (arguments.size() > 1) ? aznumeric_cast<uint32_t>(AZStd::stoi(AZStd::string(arguments[1]))) : 10000;
+
+        // Sample around the player with its own character parameters, the same way the controller does once its character is activated
+        AZ::Vector3 origin = AZ::Vector3::CreateZero();
+        float stepHeight = -1.0f;
+        float radius = -1.0f;
+        Physics::CharacterRequestBus::EventResult(origin, entityId, &Physics::CharacterRequestBus::Events::GetBasePosition);
+        Physics::CharacterRequestBus::EventResult(stepHeight, entityId, &Physics::CharacterRequestBus::Events::GetStepHeight);
+        PhysX::CharacterControllerRequestBus::EventResult(radius, entityId, &PhysX::CharacterControllerRequestBus::Events::GetRadius);
+        if ((stepHeight < 0.0f) || (radius < 0.0f))
+        {
+            AZLOG_WARN("bg_SlopeHeadingCheck found no character controller on entity %s", entityId.ToString().c_str());
+            return;
+        }
+        const float sampleHeight = stepHeight + SlopeHeightEpsilon;
+
+        // Seed the contact the same way the controller does, with a full probe ahead of the player on its first input
+        AzPhysics::SceneQueryHit contact;
+        if (!SampleGroundAhead(sceneHandle, nullptr, origin, origin + AZ::Vector3(0.f, radius + SlopeForwardEpsilon, 0.f), sampleHeight, contact))
+        {
+            AZLOG_WARN("bg_SlopeHeadingCheck found no ground within the step height of entity %s", entityId.ToString().c_str());
+            return;
+        }
+
+        AZStd::vector<AZ::Vector3> aheadPositions;
+        aheadPositions.reserve(sampleCount);
+        for (uint32_t sample = 0; sample < sampleCount; ++sample)
+        {
+            const float heading = AZ::Constants::TwoPi * sample / sampleCount;
+            const AZ::Vector3 fwd = AZ::Quaternion::CreateRotationZ(heading).TransformVector(AZ::Vector3::CreateAxisY());
+            aheadPositions.push_back(origin + fwd * (radius + SlopeForwardEpsilon));
+        }
+
+        AZStd::vector<AzPhysics::SceneQueryHit> fullHits(sampleCount);
+        AZStd::vector<bool> fullFound(sampleCount, false);
+        auto start = AZStd::chrono::steady_clock::now();
+        for (uint32_t sample = 0; sample < sampleCount; ++sample)
+        {
+            fullFound[sample] = SampleGroundAhead(sceneHandle, nullptr, origin, aheadPositions[sample], sampleHeight, fullHits[sample]);
+        }
+        const float fullUs = aznumeric_cast<float>(AZStd::chrono::duration_cast<AZStd::chrono::microseconds>(AZStd::chrono::steady_clock::now() - start).count());
+
+        AZStd::vector<AzPhysics::SceneQueryHit> contactHits(sampleCount);
+        AZStd::vector<bool> contactFound(sampleCount, false);
+        start = AZStd::chrono::steady_clock::now();
+        for (uint32_t sample = 0; sample < sampleCount; ++sample)
+        {
+            contactFound[sample] = SampleGroundAhead(sceneHandle, &contact, origin, aheadPositions[sample], sampleHeight, contactHits[sample]);
+        }
+        const float contactUs = aznumeric_cast<float>(AZStd::chrono::duration_cast<AZStd::chrono::microseconds>(AZStd::chrono::steady_clock::now() - start).count());
+
+        // Probing around the contact plane must find the same ground as the full probe, including at step downs and ledges
+        uint32_t mismatchCount = 0;
+        float maxHeightError = 0.0f;
+        for (uint32_t sample = 0; sample < sampleCount; ++sample)
+        {
+            if (contactFound[sample] != fullFound[sample])
+            {
+                ++mismatchCount;
+            }
+            else if (contactFound[sample])
+            {
+                maxHeightError = AZStd::max(maxHeightError, AZStd::abs(contactHits[sample].m_position.GetZ() - fullHits[sample].m_position.GetZ()));
+            }
+        }
+
+        AZLOG_INFO("Slope heading check, %u samples around entity %s: %u disagreed on whether there is ground, max height error %.5f m. "
+            "Full probe %.3f us per input, contact probe %.3f us per input",
+            sampleCount, entityId.ToString().c_str(), mismatchCount, maxHeightError, fullUs / sampleCount, contactUs / sampleCount);
+    }
+    AZ_CONSOLEFREEFUNC(bg_SlopeHeadingCheck, AZ::ConsoleFunctorFlags::Null, "Compares slope heading ground probes placed by the last ground contact against full step height probes around a player, takes the player's entity id and an optional sample count");
+#endif
+
+#if MPS_DIAGNOSTICS
+    static void bg_MovementAnimStatesCheck(const AZ::ConsoleCommandContainer& arguments)
+    {
+        const uint32_t inputCount = arguments.empty() ? 10000 : aznumeric_cast<uint32_t>(AZStd::stoi(AZStd::string(arguments.front())));
+
+        struct SampleInput
+        {
+            MovementFrameContext m_frameContext;
+            bool m_sprint = false;
+            bool m_crouch = false;
+        };
+
+        // Random but reproducible inputs, starting from a random set of animation states so untouched bits are checked too
+        AZ::SimpleLcgRandom random(1234);
+        AZStd::vector<SampleInput> inputs(inputCount);
+        for (SampleInput& input : inputs)
+        {
+            const uint32_t bits = random.GetRandom();
+            input.m_frameContext.m_wasOnGround = (bits & 1) != 0;
+            input.m_frameContext.m_onGround = (bits & 2) != 0;
+            input.m_frameContext.m_jumpTriggered = (bits & 4) != 0;
+            input.m_sprint = (bits & 8) != 0;
+            input.m_crouch = (bits & 16) != 0;
+        }
+        CharacterAnimStateBitset initialStates;
+        for (uint32_t bit = 0; bit < static_cast<uint32_t>(CharacterAnimState::MAX); ++bit)
+        {
+            initialStates.SetBit(bit, (random.GetRandom() & 1) != 0);
+        }
+
+        // Reference path, one write per animation bit as ProcessInput used to do
+        CharacterAnimStateBitset referenceStates = initialStates;
+        AZStd::vector<CharacterAnimStateBitset> referenceResults(inputCount);
+        uint32_t referenceWrites = 0;
+        auto start = AZStd::chrono::steady_clock::now();
+        for (uint32_t index = 0; index < inputCount; ++index)
+        {
+            const SampleInput& input = inputs[index];
+            const MovementFrameContext& frameContext = input.m_frameContext;
+            referenceStates.SetBit(aznumeric_cast<uint32_t>(CharacterAnimState::Sprinting), input.m_sprint);
+            referenceStates.SetBit(aznumeric_cast<uint32_t>(CharacterAnimState::Crouching), input.m_crouch);
+            referenceStates.SetBit(aznumeric_cast<uint32_t>(CharacterAnimState::Landing), frameContext.m_onGround && !frameContext.m_wasOnGround && !frameContext.m_jumpTriggered);
+            referenceStates.SetBit(aznumeric_cast<uint32_t>(CharacterAnimState::Jumping), frameContext.m_jumpTriggered);
+            referenceStates.SetBit(aznumeric_cast<uint32_t>(CharacterAnimState::Falling), !frameContext.m_onGround);
+            referenceWrites += 5;
+            referenceResults[index] = referenceStates;
+        }
+        const float referenceUs = aznumeric_cast<float>(AZStd::chrono::duration_cast<AZStd::chrono::microseconds>(AZStd::chrono::steady_clock::now() - start).count());
+
+        // Frame context path, a single write only when the states change
+        CharacterAnimStateBitset states = initialStates;
+        uint32_t writes = 0;
+        uint32_t mismatches = 0;
+        start = AZStd::chrono::steady_clock::now();
+        for (uint32_t index = 0; index < inputCount; ++index)
+        {
+            CharacterAnimStateBitset newStates = states;
+            ApplyMovementAnimStates(inputs[index].m_frameContext, inputs[index].m_sprint, inputs[index].m_crouch, newStates);
+            if (newStates != states)
+            {
+                states = newStates;
+                ++writes;
+            }
+            mismatches += (states != referenceResults[index]) ? 1 : 0;
+        }
+        const float frameContextUs = aznumeric_cast<float>(AZStd::chrono::duration_cast<AZStd::chrono::microseconds>(AZStd::chrono::steady_clock::now() - start).count());
+
+        AZLOG_INFO("Movement anim states check, %u inputs: %u mismatched states. Per bit %u writes in %.1f us, frame context %u writes in %.1f us",
+            inputCount, mismatches, referenceWrites, referenceUs, writes, frameContextUs);
+    }
+    AZ_CONSOLEFREEFUNC(bg_MovementAnimStatesCheck, AZ::ConsoleFunctorFlags::Null, "Checks that committing movement animation states in a single write matches per bit writes, optionally takes an input count");
+
+    static void cl_MovementReplayStats([[maybe_unused]] const AZ::ConsoleCommandContainer& arguments)
+    {
+        const MovementReplayStats& stats = s_movementReplayStats;
+        const uint64_t replayedCount = stats.m_resimulatedCount + stats.m_restoredCount;
+        const float averageUs = (stats.m_simulatedCount > 0) ? stats.m_simulatedUs / stats.m_simulatedCount : 0.0f;
+
+        // Restoring a snapshot costs a handful of property writes, so each restored input saves roughly one average move
+        AZLOG_INFO("Movement replay: %" PRIu64 " inputs simulated averaging %.2f us, %" PRIu64 " replayed of which %" PRIu64 " resimulated and %" PRIu64 " restored, saving roughly %.1f us",
+            stats.m_simulatedCount, averageUs, replayedCount, stats.m_resimulatedCount, stats.m_restoredCount, averageUs * stats.m_restoredCount);
+    }
+    AZ_CONSOLEFREEFUNC(cl_MovementReplayStats, AZ::ConsoleFunctorFlags::Null, "Logs how many corrected movement inputs were resimulated versus restored from their prediction");
+#endif
 } // namespace MultiplayerSample
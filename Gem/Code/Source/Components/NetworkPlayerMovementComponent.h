@@ -8,6 +8,8 @@
 #pragma once
 
 #include <Source/AutoGen/NetworkPlayerMovementComponent.AutoComponent.h>
+#include <Source/Components/BotMovementBatch.h>
+#include <Source/Components/InputActionMap.h>
 #include <Source/Components/NetworkAiComponent.h>
 #include <StartingPointInput/InputEventNotificationBus.h>
 #include <AzFramework/Physics/CharacterBus.h>
@@ -30,10 +32,61 @@ namespace MultiplayerSample
     const StartingPointInput::InputEventNotificationId ZoomInEventId("zoomIn");
     const StartingPointInput::InputEventNotificationId ZoomOutEventId("zoomOut");
 
+    //! Actions the player movement controller performs for its input events.
+    enum class MovementInputAction : uint8_t
+    {
+        MoveFwd,
+        MoveBack,
+        MoveLeft,
+        MoveRight,
+        Sprint,
+        Jump,
+        Crouch,
+        LookLeftRight,
+        LookUpDown
+    };
+
+    //! Returns the map from player movement input events to movement actions.
+    const InputActionMap<MovementInputAction>& GetMovementInputActions();
+
+    //! @struct MovementFrameContext
+    //! @brief Movement state evaluated once per processed input and shared by every step of ProcessInput.
+    struct MovementFrameContext
+    {
+        bool m_wasOnGround = false;    // Grounded state at the end of the previous input
+        bool m_onGround = false;       // Grounded state before this input's move
+        bool m_jumpTriggered = false;  // True on the input a jump starts
+        bool m_movingDownward = false; // True if the player is deliberately moving down a slope or step
+        AZ::Vector3 m_aimAngles = AZ::Vector3::CreateZero();
+    };
+
+    //! @struct MovementSnapshot
+    //! @brief The predicted movement state of a player, captured around each locally predicted input.
+    struct MovementSnapshot
+    {
+        AZ::Vector3 m_position = AZ::Vector3::CreateZero();
+        AZ::Vector3 m_aimAngles = AZ::Vector3::CreateZero();
+        AZ::Vector3 m_velocityFromExternalSources = AZ::Vector3::CreateZero();
+        AZ::Vector3 m_selfGeneratedVelocity = AZ::Vector3::CreateZero();
+        CharacterAnimStateBitset m_animStates;
+        float m_secondsSinceOnGround = 0.0f;
+        float m_secondsSinceJumpRequest = 0.0f;
+        bool m_onGround = false;
+        bool m_wasOnGround = false;
+        bool m_isJumping = false;
+
+        //! Returns whether two snapshots would produce the same movement for the same input.
+        //! @param rhs       the snapshot to compare against
+        //! @param tolerance the largest difference allowed in any position, velocity, angle or timer
+        //! @return true if every flag matches and every value is within tolerance
+        bool IsWithinTolerance(const MovementSnapshot& rhs, float tolerance) const;
+    };
+
     class NetworkPlayerMovementComponentController
         : public NetworkPlayerMovementComponentControllerBase
         , private StartingPointInput::InputEventNotificationBus::MultiHandler
         , protected Physics::CharacterNotificationBus::Handler
+        , private BotMovementListener
     {
     public:
         NetworkPlayerMovementComponentController(NetworkPlayerMovementComponent& parent);
@@ -58,10 +111,27 @@ namespace MultiplayerSample
     private:
         friend class NetworkAiComponentController;
 
-        void UpdateVelocity(const NetworkPlayerMovementComponentNetworkInput& playerInput, float deltaTime, bool& jumpTriggered, bool& movingDownward);
+        //! Moves the player for a single input.
+        //! @param playerInput the movement input to process
+        //! @param deltaTime   the duration of the input
+        void SimulateInput(const NetworkPlayerMovementComponentNetworkInput& playerInput, float deltaTime);
+
+        //! Moves a bot for a single input, recording its cost with the bot movement batch.
+        //! @param playerInput the movement input to process
+        //! @param deltaTime   the duration of the input
+        void SimulateBotInput(const NetworkPlayerMovementComponentNetworkInput& playerInput, float deltaTime);
+
+        MovementSnapshot CaptureMovementSnapshot() const;
+        void ApplyMovementSnapshot(const MovementSnapshot& snapshot);
+
+        void UpdateVelocity(const NetworkPlayerMovementComponentNetworkInput& playerInput, float deltaTime, MovementFrameContext& frameContext);
         float NormalizeHeading(float heading) const;
 
-        AZ::Vector3 GetSlopeHeading(float targetHeading) const;
+        //! Returns a unit vector in the direction of movement, following the slope of the ground directly ahead of the player.
+        //! The ground is sampled with a raycast only when the predicted ground contact can't be extended to the position ahead.
+        //! @param targetHeading the heading the player is moving towards
+        //! @return the movement direction
+        AZ::Vector3 GetSlopeHeading(float targetHeading);
 
         //! AZ::InputEventNotificationBus interface
         //! @{
@@ -115,5 +185,37 @@ namespace MultiplayerSample
         float m_gravityMultiplier = 1.0f;
         float m_stepHeight = 0.1f;
         float m_radius = 0.3f;
+        float m_height = 1.8f;
+
+        // The last ground sampled ahead of the player, only used to narrow the next slope heading probe so it is not predicted state
+        AZ::Vector3 m_groundContactPoint = AZ::Vector3::CreateZero();
+        AZ::Vector3 m_groundContactNormal = AZ::Vector3::CreateAxisZ();
+        bool m_hasGroundContact = false;
+
+        //! BotMovementListener interface
+        void OnBotMoveComplete(bool onGround) override;
+
+        BotMovementBatch* m_botMovementBatch = nullptr; // Set for AI bots that move kinematically rather than through their character controller
+
+        //! Movement state around a single locally predicted input, replayed inputs that start from the same state can reuse the result.
+        struct PredictedInput
+        {
+            Multiplayer::ClientInputId m_clientInputId = Multiplayer::ClientInputId{ 0 };
+            MovementSnapshot m_preState;
+            MovementSnapshot m_postState;
+        };
+        static constexpr uint32_t PredictedInputHistorySize = 64; // Covers the inputs in flight at roughly one second of latency at 60hz
+        AZStd::array<PredictedInput, PredictedInputHistorySize> m_predictedInputHistory;
+
+        //! Feeds prediction stats with the corrections and replays seen by locally predicted inputs.
+        //! @param predictedInput the history entry for the input being processed
+        //! @param clientInputId  the id of the input being processed
+        //! @param isReprocessing true if the input is being replayed after a correction
+        void TrackCorrection(const PredictedInput& predictedInput, Multiplayer::ClientInputId clientInputId, bool isReprocessing);
+
+        // Correction tracking for prediction stats
+        uint32_t m_correctionReplayCount = 0; // Inputs replayed so far for the correction being replayed
+        bool m_isReplayingCorrection = false;
+        bool m_isDiscardingResetInputs = false;
     };
 }
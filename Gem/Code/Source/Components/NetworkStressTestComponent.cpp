@@ -11,6 +11,13 @@
 #include <Source/Components/NetworkAiComponent.h>
 #include <Source/Components/NetworkPlayerMovementComponent.h>
 
+#include <Source/MultiplayerSampleTypes.h>
+#include <Source/Weapons/ProjectileStore.h>
+#include <Source/Weapons/WeaponQueryBatch.h>
+
+#include <AzCore/Console/IConsole.h>
+#include <AzCore/Console/ILogger.h>
+#include <AzCore/EBus/IEventScheduler.h>
 #include <AzCore/Serialization/EditContext.h>
 #include <AzCore/Serialization/SerializeContext.h>
 #include <Multiplayer/IMultiplayer.h>
@@ -156,20 +163,12 @@ namespace MultiplayerSample
     }
 
 #if AZ_TRAIT_SERVER
-    void NetworkStressTestComponentController::HandleSpawnAIEntity(
-        AzNetworking::IConnection* invokingConnection,
-        const float& fireIntervalMinMs,
-        const float& fireIntervalMaxMs,
-        const float& actionIntervalMinMs,
-        const float& actionIntervalMaxMs,
-        [[maybe_unused]] const int& teamId)
+    static Multiplayer::NetworkEntityHandle CreateAiEntity(
+        float fireIntervalMinMs,
+        float fireIntervalMaxMs,
+        float actionIntervalMinMs,
+        float actionIntervalMaxMs)
     {
-        if (GetSpawnCount() > GetMaxSpawns())
-        {
-            return;
-        }
-        ModifySpawnCount()++;
-
         static Multiplayer::PrefabEntityId prefabId(AZ::Name{ "prefabs/player.network.spawnable" });
 
         Multiplayer::INetworkEntityManager::EntityList entityList =
@@ -184,7 +183,7 @@ namespace MultiplayerSample
         if (entityList.empty())
         {
             AZ_Error("NetworkStressTestComponentController", false, "No AI entity to spawn");
-            return;
+            return Multiplayer::NetworkEntityHandle();
         }
 
         Multiplayer::NetworkEntityHandle createdEntity = entityList[0];
@@ -192,11 +191,160 @@ namespace MultiplayerSample
         NetworkAiComponentController* networkAiController = createdEntity.FindController<NetworkAiComponentController>();
         networkAiController->ConfigureAi(fireIntervalMinMs, fireIntervalMaxMs, actionIntervalMinMs, actionIntervalMaxMs);
         networkAiController->SetEnabled(true);
+        return createdEntity;
+    }
+
+    void NetworkStressTestComponentController::HandleSpawnAIEntity(
+        AzNetworking::IConnection* invokingConnection,
+        const float& fireIntervalMinMs,
+        const float& fireIntervalMaxMs,
+        const float& actionIntervalMinMs,
+        const float& actionIntervalMaxMs,
+        [[maybe_unused]] const int& teamId)
+    {
+        if (GetSpawnCount() > GetMaxSpawns())
+        {
+            return;
+        }
+        ModifySpawnCount()++;
+
+        Multiplayer::NetworkEntityHandle createdEntity = CreateAiEntity(fireIntervalMinMs, fireIntervalMaxMs, actionIntervalMinMs, actionIntervalMaxMs);
+        if (!createdEntity.Exists())
+        {
+            return;
+        }
+
         if (invokingConnection)
         {
             createdEntity.GetNetBindComponent()->SetOwningConnectionId(invokingConnection->GetConnectionId());
         }
         createdEntity.Activate();
     }
+
+#if MPS_DIAGNOSTICS
+    //! Measures rewind sync coalescing under real load, AI shooters are spawned and fire through the full weapon pipeline.
+    //! The same shooters are measured for one phase with coalescing enabled and one with it disabled.
+    struct RewindSyncStressTest
+    {
+        static constexpr const char* CoalescingCvar = "sv_RewindSyncCoalescing";
+
+        AZStd::vector<Multiplayer::NetworkEntityHandle> m_shooters;
+        RewindSyncScope::Stats m_phaseStats[2];
+        AZ::TimeMs m_phaseDurationMs = AZ::Time::ZeroTimeMs;
+        bool m_wasCoalescing = true;
+    };
+
+    static bool s_rewindSyncStressTestRunning = false;
+
+    static void AccumulateRewindSyncStats(RewindSyncScope::Stats& totalStats, const RewindSyncScope::Stats& stats)
+    {
+        totalStats.m_requestedSyncs += stats.m_requestedSyncs;
+        totalStats.m_performedSyncs += stats.m_performedSyncs;
+        totalStats.m_skippedSyncs += stats.m_skippedSyncs;
+    }
+
+    static RewindSyncScope::Stats GetTotalRewindSyncStats()
+    {
+        RewindSyncScope::Stats totalStats;
+        if (const WeaponQueryBatch* weaponQueryBatch = AZ::Interface<WeaponQueryBatch>::Get())
+        {
+            AccumulateRewindSyncStats(totalStats, weaponQueryBatch->GetRewindSyncStats());
+        }
+        if (const ProjectileStore* projectileStore = AZ::Interface<ProjectileStore>::Get())
+        {
+            AccumulateRewindSyncStats(totalStats, projectileStore->GetRewindSyncStats());
+        }
+        return totalStats;
+    }
+
+    static RewindSyncScope::Stats operator-(const RewindSyncScope::Stats& lhs, const RewindSyncScope::Stats& rhs)
+    {
+        RewindSyncScope::Stats result;
+        result.m_requestedSyncs = lhs.m_requestedSyncs - rhs.m_requestedSyncs;
+        result.m_performedSyncs = lhs.m_performedSyncs - rhs.m_performedSyncs;
+        result.m_skippedSyncs = lhs.m_skippedSyncs - rhs.m_skippedSyncs;
+        return result;
+    }
+
+    static void RunRewindSyncStressPhase(AZStd::shared_ptr<RewindSyncStressTest> stressTest, uint32_t phase)
+    {
+        AZ::IConsole* console = AZ::Interface<AZ::IConsole>::Get();
+        if (phase > 0)
+        {
+            stressTest->m_phaseStats[phase - 1] = GetTotalRewindSyncStats() - stressTest->m_phaseStats[phase - 1];
+        }
+
+        if (phase < AZ_ARRAY_SIZE(stressTest->m_phaseStats))
+        {
+            // Phase 0 measures with coalescing, phase 1 without
+            console->PerformCommand(AZStd::string::format("%s %s", RewindSyncStressTest::CoalescingCvar, (phase == 0) ? "true" : "false").c_str());
+            stressTest->m_phaseStats[phase] = GetTotalRewindSyncStats();
+            AZ::Interface<AZ::IEventScheduler>::Get()->AddCallback([stressTest, phase]()
+            {
+                RunRewindSyncStressPhase(stressTest, phase + 1);
+            }, AZ::Name("RewindSyncStressTestPhase"), stressTest->m_phaseDurationMs);
+            return;
+        }
+
+        console->PerformCommand(AZStd::string::format("%s %s", RewindSyncStressTest::CoalescingCvar, stressTest->m_wasCoalescing ? "true" : "false").c_str());
+        for (const Multiplayer::NetworkEntityHandle& shooter : stressTest->m_shooters)
+        {
+            if (shooter.Exists())
+            {
+                Multiplayer::GetNetworkEntityManager()->MarkForRemoval(shooter);
+            }
+        }
+
+        const RewindSyncScope::Stats& coalesced = stressTest->m_phaseStats[0];
+        const RewindSyncScope::Stats& uncoalesced = stressTest->m_phaseStats[1];
+        AZLOG_INFO("Rewind sync stress test, %zu AI shooters for %lld ms per phase: coalesced %llu requested, %llu performed, %llu skipped;"
+            " uncoalesced %llu requested, %llu performed",
+            stressTest->m_shooters.size(), aznumeric_cast<long long>(stressTest->m_phaseDurationMs),
+            aznumeric_cast<unsigned long long>(coalesced.m_requestedSyncs),
+            aznumeric_cast<unsigned long long>(coalesced.m_performedSyncs),
+            aznumeric_cast<unsigned long long>(coalesced.m_skippedSyncs),
+            aznumeric_cast<unsigned long long>(uncoalesced.m_requestedSyncs),
+            aznumeric_cast<unsigned long long>(uncoalesced.m_performedSyncs));
+        s_rewindSyncStressTestRunning = false;
+    }
+
+    static void sv_RewindSyncStressTest(const AZ::ConsoleCommandContainer& arguments)
+    {
+        if (AZ::Interface<WeaponQueryBatch>::Get() == nullptr)
+        {
+            AZLOG_WARN("sv_RewindSyncStressTest must be run on a host with a loaded level");
+            return;
+        }
+
+        if (s_rewindSyncStressTestRunning)
+        {
+            AZLOG_WARN("sv_RewindSyncStressTest is already running");
+            return;
+        }
+
+        const uint32_t shooterCount = (arguments.size() > 0) ? aznumeric_cast<uint32_t>(AZStd::stoi(AZStd::string(arguments[0]))) : 64;
+        const int32_t phaseSeconds = (arguments.size() > 1) ? AZStd::stoi(AZStd::string(arguments[1])) : 10;
+
+        auto stressTest = AZStd::make_shared<RewindSyncStressTest>();
+        stressTest->m_phaseDurationMs = AZ::TimeMs{ phaseSeconds * 1000 };
+        AZ::Interface<AZ::IConsole>::Get()->GetCvarValue(RewindSyncStressTest::CoalescingCvar, stressTest->m_wasCoalescing);
+
+        // Shooters fire as often as the AI allows and rarely change action so that their shots overlap in the same ticks
+        stressTest->m_shooters.reserve(shooterCount);
+        for (uint32_t shooter = 0; shooter < shooterCount; ++shooter)
+        {
+            Multiplayer::NetworkEntityHandle createdEntity = CreateAiEntity(100.0f, 200.0f, 5000.0f, 10000.0f);
+            if (createdEntity.Exists())
+            {
+                createdEntity.Activate();
+                stressTest->m_shooters.push_back(createdEntity);
+            }
+        }
+
+        s_rewindSyncStressTestRunning = true;
+        RunRewindSyncStressPhase(stressTest, 0);
+    }
+    AZ_CONSOLEFREEFUNC(sv_RewindSyncStressTest, AZ::ConsoleFunctorFlags::Null, "Spawns AI shooters and logs rewind syncs with coalescing enabled and then disabled, optionally takes a shooter count and seconds per phase");
+#endif
 #endif
 } // namespace MultiplayerSample
@@ -14,9 +14,16 @@
 #include <Source/Components/NetworkMatchComponent.h>
 #include <Source/Components/NetworkSimplePlayerCameraComponent.h>
 #include <Source/Components/Multiplayer/PlayerIdentityComponent.h>
+#include <Source/Components/PredictionStats.h>
+#include <Source/MultiplayerSampleTypes.h>
 #include <Source/Weapons/BaseWeapon.h>
+#include <Source/Weapons/SceneQuery.h>
+#include <Source/Weapons/WeaponDefinitionLibrary.h>
+#include <Source/Weapons/WeaponFireRecorder.h>
+#include <AzCore/Component/TickBus.h>
 #include <AzCore/Component/TransformBus.h>
 #include <AzCore/Math/Plane.h>
+#include <AzCore/std/chrono/chrono.h>
 #include <AzFramework/Physics/PhysicsScene.h>
 #include <AzFramework/Physics/Common/PhysicsSceneQueries.h>
 #include <WeaponNotificationBus.h>
@@ -33,6 +40,110 @@ namespace MultiplayerSample
     AZ_CVAR(float, sv_WeaponsImpulseScalar, 750.0f, nullptr, AZ::ConsoleFunctorFlags::Null, "A fudge factor for imparting impulses on rigid bodies due to weapon hits");
     AZ_CVAR(float, sv_WeaponsStartPositionClampRange, 1.f, nullptr, AZ::ConsoleFunctorFlags::Null, "A fudge factor between the where the client and server say a shot started");
     AZ_CVAR(float, sv_WeaponsDotClamp, 0.35f, nullptr, AZ::ConsoleFunctorFlags::Null, "Acceptable dot product range for a shot between the camera raycast and weapon raycast.");
+    AZ_CVAR(uint32_t, cl_WeaponsMaxCatchUpActivations, 3, nullptr, AZ::ConsoleFunctorFlags::Null, "The maximum number of missed activations a simulated weapon replays in a single update, older activations are skipped");
+    AZ_CVAR(uint32_t, cl_WeaponsMaxCatchUpEffectsPerFrame, 16, nullptr, AZ::ConsoleFunctorFlags::Null, "The maximum number of catch up activations and merged effects all simulated weapons play in a single frame, the newest activation of each weapon is never limited");
+    AZ_CVAR(bool, cl_WeaponsCacheReplayedAim, true, nullptr, AZ::ConsoleFunctorFlags::Null, "If true, replayed inputs reuse the aim target resolved when the input was first processed instead of raycasting again");
+    AZ_CVAR(bool, sv_WeaponsBatchConfirmedHits, true, nullptr, AZ::ConsoleFunctorFlags::Null, "If true, confirmed hits are sent to clients once per tick in a quantized batch instead of one rpc per hit event");
+
+    //! How a simulated weapon catches up on a jump in its replicated activation count.
+    //! The missed activations are split by age: the newest are replayed, the oldest are skipped. A replayed activation is simulated
+    //! with its own shot and effects, skipped activations only advance the count. If any were skipped they're merged into a single
+    //! activate effect using the latest fire params, since every missed activation shares those params anyway.
+    struct ActivationCatchUp
+    {
+        uint32_t m_replayedCount = 0; // Newest activations, simulated with their full effects
+        uint32_t m_skippedCount = 0; // Oldest activations, only counted
+    };
+
+    //! Catch up effects played by every simulated weapon during the current frame.
+    struct ActivationCatchUpFrame
+    {
+        AZ::ScriptTimePoint m_frameTime; // Time of the frame the counts belong to
+        uint32_t m_effectCount = 0; // Older replayed activations and merged effects played this frame
+#if MPS_DIAGNOSTICS
+        float m_elapsedUs = 0.0f; // Time spent catching up this frame
+#endif
+    };
+    static ActivationCatchUpFrame s_activationCatchUpFrame;
+
+#if MPS_DIAGNOSTICS
+    //! Counters for activation catch up on simulated weapons, accumulated since startup.
+    struct ActivationCatchUpStats
+    {
+        uint64_t m_updateCount = 0;
+        uint64_t m_replayedCount = 0;
+        uint64_t m_skippedCount = 0;
+        uint32_t m_maxMissedCount = 0;
+        float m_maxFrameUs = 0.0f; // Worst total catch up time of a single frame
+    };
+    static ActivationCatchUpStats s_activationCatchUpStats;
+#endif
+
+#if MPS_DIAGNOSTICS
+    //! Counters for aim resolution of firing inputs replayed during correction, accumulated since startup.
+    struct ReplayedAimStats
+    {
+        uint64_t m_cachedCount = 0; // Replayed inputs that reused their resolved aim
+        uint64_t m_resolvedCount = 0; // Replayed inputs that had to resolve their aim again
+        float m_cachedUs = 0.0f;
+        float m_resolvedUs = 0.0f;
+    };
+    static ReplayedAimStats s_replayedAimStats;
+#endif
+
+    static ActivationCatchUp ComputeActivationCatchUp(uint32_t missedCount, uint32_t maxReplayedCount, float activationIntervalSec, float shotLifetimeSec)
+    {
+        // Activations are at least one cooldown apart and the newest one just fired, so older shots have already
+        // travelled for a multiple of the cooldown. Instant shots are over as soon as they're fired.
+        uint32_t liveCount = missedCount;
+        if (shotLifetimeSec <= 0.0f)
+        {
+            liveCount = 1;
+        }
+        else if (activationIntervalSec > 0.0f)
+        {
+            liveCount = aznumeric_cast<uint32_t>(shotLifetimeSec / activationIntervalSec) + 1;
+        }
+
+        ActivationCatchUp catchUp;
+        catchUp.m_replayedCount = AZStd::min(missedCount, AZStd::min(maxReplayedCount, liveCount));
+        catchUp.m_skippedCount = missedCount - catchUp.m_replayedCount;
+        return catchUp;
+    }
+
+    static ActivationCatchUp ComputeActivationCatchUp(uint32_t missedCount, const WeaponParams& weaponParams)
+    {
+        const GatherParams& gatherParams = weaponParams.m_gatherParams;
+        const float activationIntervalSec = aznumeric_cast<float>(weaponParams.m_cooldownTimeMs) * 0.001f;
+        const float shotLifetimeSec = (gatherParams.m_travelSpeed > 0.0f) ? gatherParams.m_castDistance / gatherParams.m_travelSpeed : 0.0f;
+        return ComputeActivationCatchUp(missedCount, cl_WeaponsMaxCatchUpActivations, activationIntervalSec, shotLifetimeSec);
+    }
+
+    static ActivationCatchUpFrame& GetActivationCatchUpFrame()
+    {
+        AZ::ScriptTimePoint frameTime;
+        AZ::TickRequestBus::BroadcastResult(frameTime, &AZ::TickRequestBus::Events::GetTimeAtCurrentTick);
+        if (frameTime.Get() != s_activationCatchUpFrame.m_frameTime.Get())
+        {
+            s_activationCatchUpFrame = ActivationCatchUpFrame();
+            s_activationCatchUpFrame.m_frameTime = frameTime;
+        }
+        return s_activationCatchUpFrame;
+    }
+
+    static void ApplyCatchUpFrameBudget(ActivationCatchUp& catchUp, bool& playMergedEffect, uint32_t& frameEffectCount, uint32_t maxFrameEffectCount)
+    {
+        // The newest activation is the one a weapon fires every update, only the older replays and the merged effect are catch up work
+        const uint32_t remainingCount = (frameEffectCount < maxFrameEffectCount) ? maxFrameEffectCount - frameEffectCount : 0;
+        const uint32_t olderReplayedCount = (catchUp.m_replayedCount > 0) ? catchUp.m_replayedCount - 1 : 0;
+        const uint32_t allowedOlderCount = AZStd::min(olderReplayedCount, remainingCount);
+
+        // Replays over the budget are skipped instead, which may leave room for the merged effect
+        catchUp.m_replayedCount -= olderReplayedCount - allowedOlderCount;
+        catchUp.m_skippedCount += olderReplayedCount - allowedOlderCount;
+        playMergedEffect = playMergedEffect && (catchUp.m_skippedCount > 0) && (allowedOlderCount < remainingCount);
+        frameEffectCount += allowedOlderCount + (playMergedEffect ? 1 : 0);
+    }
 
     class BehaviorWeaponNotificationBusHandler
         : public WeaponNotificationBus::Handler
@@ -87,6 +198,7 @@ namespace MultiplayerSample
     NetworkWeaponsComponent::NetworkWeaponsComponent()
         : NetworkWeaponsComponentBase()
         , m_activationCountHandler([this](int32_t index, uint8_t value) { OnUpdateActivationCounts(index, value); })
+        , m_actorChangedHandler([this]() { ResolveFireBones(); })
     {
         ;
     }
@@ -94,17 +206,31 @@ namespace MultiplayerSample
     void NetworkWeaponsComponent::OnInit()
     {
         AZStd::uninitialized_fill_n(m_fireBoneJointIds.data(), MaxWeaponsPerComponent, InvalidBoneId);
+        AZStd::uninitialized_fill_n(m_weaponDefinitionIndices.data(), MaxWeaponsPerComponent, InvalidWeaponDefinitionIndex);
     }
 
     void NetworkWeaponsComponent::OnActivate([[maybe_unused]] Multiplayer::EntityIsMigrating entityIsMigrating)
     {
+        const WeaponDefinitionLibrary* weaponDefinitionLibrary = GetWeaponDefinitionLibrary();
         for (uint32_t weaponIndex = 0; weaponIndex < MaxWeaponsPerComponent; ++weaponIndex)
         {
+            // Weapons reference a shared definition, so players and bots don't each hold their own copy of the parameters
+            const AZStd::string& definitionName = GetWeaponDefinitionNames(weaponIndex);
+            m_weaponDefinitionIndices[weaponIndex] = InvalidWeaponDefinitionIndex;
+            if (!definitionName.empty() && (weaponDefinitionLibrary != nullptr))
+            {
+                m_weaponDefinitionIndices[weaponIndex] = weaponDefinitionLibrary->FindDefinitionIndex(AZ::Name(definitionName));
+                if (m_weaponDefinitionIndices[weaponIndex] == InvalidWeaponDefinitionIndex)
+                {
+                    AZLOG_WARN("Weapon definition %s was not found, weapon %u is left empty", definitionName.c_str(), weaponIndex);
+                }
+            }
+
             const ConstructParams constructParams
             {
                 GetEntityHandle(),
                 aznumeric_cast<WeaponIndex>(weaponIndex),
-                GetWeaponParams(weaponIndex),
+                GetWeaponDefinition(aznumeric_cast<WeaponIndex>(weaponIndex)),
                 *this
             };
 
@@ -118,6 +244,10 @@ namespace MultiplayerSample
 
         m_tickSimulatedWeapons.Enqueue(AZ::Time::ZeroTimeMs);
 
+        // Fire bones are resolved by name once per actor, shots only ever use the joint indices
+        GetNetworkAnimationComponent()->AddActorChangedEventHandler(m_actorChangedHandler);
+        ResolveFireBones();
+
 #if AZ_TRAIT_CLIENT
         if (m_debugDraw == nullptr)
         {
@@ -129,6 +259,22 @@ namespace MultiplayerSample
     void NetworkWeaponsComponent::OnDeactivate([[maybe_unused]] Multiplayer::EntityIsMigrating entityIsMigrating)
     {
         m_tickSimulatedWeapons.RemoveFromQueue();
+        m_flushConfirmedHits.RemoveFromQueue();
+        m_confirmedHits.Clear();
+        m_actorChangedHandler.Disconnect();
+    }
+
+    int32_t NetworkWeaponsComponent::GetFireBoneJointId(WeaponIndex weaponIndex) const
+    {
+        return m_fireBoneJointIds[aznumeric_cast<uint32_t>(weaponIndex)];
+    }
+
+    void NetworkWeaponsComponent::ResolveFireBones()
+    {
+        for (uint32_t weaponIndex = 0; weaponIndex < MaxWeaponsPerComponent; ++weaponIndex)
+        {
+            m_fireBoneJointIds[weaponIndex] = GetNetworkAnimationComponent()->GetBoneIdByName(GetFireBoneNames(weaponIndex).c_str());
+        }
     }
 
 #if AZ_TRAIT_CLIENT
@@ -143,6 +289,21 @@ namespace MultiplayerSample
         WeaponHitInfo weaponHitInfo(*GetWeapon(weaponIndex), hitEvent);
         OnWeaponConfirmHit(weaponHitInfo);
     }
+
+    void NetworkWeaponsComponent::HandleSendConfirmHits([[maybe_unused]] AzNetworking::IConnection* invokingConnection, const HitConfirmBatch& hitConfirmBatch)
+    {
+        hitConfirmBatch.VisitHitEvents(GetNetEntityId(), [this](WeaponIndex weaponIndex, const HitEvent& hitEvent)
+        {
+            if ((aznumeric_cast<uint32_t>(weaponIndex) >= MaxWeaponsPerComponent) || (GetWeapon(weaponIndex) == nullptr))
+            {
+                AZLOG_ERROR("Got confirmed hit for null weapon index");
+                return;
+            }
+
+            WeaponHitInfo weaponHitInfo(*GetWeapon(weaponIndex), hitEvent);
+            OnWeaponConfirmHit(weaponHitInfo);
+        });
+    }
 #endif
 
     void NetworkWeaponsComponent::ActivateWeaponWithParams(WeaponIndex weaponIndex, WeaponState& weaponState, const FireParams& fireParams, bool validateActivations)
@@ -159,6 +320,22 @@ namespace MultiplayerSample
         return m_weapons[aznumeric_cast<uint32_t>(weaponIndex)].get();
     }
 
+    const WeaponParams& NetworkWeaponsComponent::GetWeaponDefinition(WeaponIndex weaponIndex) const
+    {
+        const uint32_t index = aznumeric_cast<uint32_t>(weaponIndex);
+        if (m_weaponDefinitionIndices[index] != InvalidWeaponDefinitionIndex)
+        {
+            if (const WeaponDefinitionLibrary* weaponDefinitionLibrary = GetWeaponDefinitionLibrary())
+            {
+                return *weaponDefinitionLibrary->GetDefinition(m_weaponDefinitionIndices[index]);
+            }
+        }
+
+        // WeaponType::None, no weapon is constructed from these
+        static const WeaponParams emptyWeaponParams;
+        return emptyWeaponParams;
+    }
+
     void NetworkWeaponsComponent::AddOnWeaponActivateEventHandler(OnWeaponActivateEvent::Handler& handler)
     {
         handler.Connect(m_onWeaponActivateEvent);
@@ -185,6 +362,16 @@ namespace MultiplayerSample
         m_onWeaponActivateEvent.Signal(activationInfo);
         WeaponNotificationBus::Broadcast(&WeaponNotificationBus::Events::OnWeaponActivate, GetEntity()->GetId(), activationInfo.m_activateEvent.m_initialTransform);
 
+#if AZ_TRAIT_SERVER
+        if (IsNetEntityRoleAuthority() && (activationInfo.m_weapon.GetParams().m_weaponType == WeaponType::Trace))
+        {
+            if (WeaponFireRecorder* weaponFireRecorder = GetWeaponFireRecorder(); (weaponFireRecorder != nullptr) && weaponFireRecorder->IsRecording())
+            {
+                weaponFireRecorder->RecordShot(activationInfo.m_weapon.GetParams().m_gatherParams, activationInfo.m_activateEvent);
+            }
+        }
+#endif
+
 #if AZ_TRAIT_CLIENT
         if (cl_WeaponsDrawDebug && m_debugDraw)
         {
@@ -215,7 +402,14 @@ namespace MultiplayerSample
         {
 #if AZ_TRAIT_SERVER
             OnWeaponConfirmHit(hitInfo);
-            static_cast<NetworkWeaponsComponentController*>(GetController())->SendConfirmHit(hitInfo.m_weapon.GetWeaponIndex(), hitInfo.m_hitEvent);
+            if (sv_WeaponsBatchConfirmedHits)
+            {
+                QueueConfirmedHit(hitInfo);
+            }
+            else
+            {
+                static_cast<NetworkWeaponsComponentController*>(GetController())->SendConfirmHit(hitInfo.m_weapon.GetWeaponIndex(), hitInfo.m_hitEvent);
+            }
 #endif
         }
         else
@@ -224,6 +418,31 @@ namespace MultiplayerSample
         }
     }
 
+    void NetworkWeaponsComponent::QueueConfirmedHit(const WeaponHitInfo& hitInfo)
+    {
+        const WeaponIndex weaponIndex = hitInfo.m_weapon.GetWeaponIndex();
+        if (!m_confirmedHits.TryAddHitEvent(weaponIndex, hitInfo.m_shotOrigin, hitInfo.m_hitEvent))
+        {
+            // The batch is full or its origin is too far from this hit, send what we have and start a new batch
+            FlushConfirmedHits();
+            m_confirmedHits.TryAddHitEvent(weaponIndex, hitInfo.m_shotOrigin, hitInfo.m_hitEvent);
+        }
+
+        if (!m_flushConfirmedHits.IsScheduled())
+        {
+            m_flushConfirmedHits.Enqueue(AZ::Time::ZeroTimeMs);
+        }
+    }
+
+    void NetworkWeaponsComponent::FlushConfirmedHits()
+    {
+        if (!m_confirmedHits.IsEmpty() && HasController())
+        {
+            static_cast<NetworkWeaponsComponentController*>(GetController())->SendConfirmHits(m_confirmedHits);
+        }
+        m_confirmedHits.Clear();
+    }
+
     void NetworkWeaponsComponent::OnWeaponPredictHit(const WeaponHitInfo& hitInfo)
     {
         // If we're replaying inputs then early out
@@ -382,15 +601,50 @@ namespace MultiplayerSample
 
         AZLOG(NET_Weapons, "Client activation event for weapon index %u", index);
 
+#if MPS_DIAGNOSTICS
+        const auto start = AZStd::chrono::steady_clock::now();
+#endif
+
         WeaponState& weaponState = m_simulatedWeaponStates[index];
         const FireParams& fireParams = GetActivationParams(index);
         weapon->SetFireParams(fireParams);
 
+        // After packet loss or a late join the count can jump by dozens, only the newest activations are worth simulating
+        // since every missed activation shares the latest replicated fire params anyway
+        const uint8_t missedCount = value - weaponState.m_activationCount;
+        const WeaponSimulationLod lod = GetSimulationLod(*weapon);
+        ActivationCatchUp catchUp = (lod == WeaponSimulationLod::Culled)
+            ? ActivationCatchUp{ 0, missedCount }
+            : ComputeActivationCatchUp(missedCount, weapon->GetParams());
+
+        // A burst of updates in one frame, such as after a hitch, shares a single budget across every simulated weapon
+        ActivationCatchUpFrame& catchUpFrame = GetActivationCatchUpFrame();
+        bool playMergedEffect = (lod != WeaponSimulationLod::Culled);
+        ApplyCatchUpFrameBudget(catchUp, playMergedEffect, catchUpFrame.m_effectCount, cl_WeaponsMaxCatchUpEffectsPerFrame);
+        weaponState.m_activationCount += aznumeric_cast<uint8_t>(catchUp.m_skippedCount);
+
+#if AZ_TRAIT_CLIENT
+        // Replayed activations play their own effects, the skipped activations are merged into a single representative effect
+        if (playMergedEffect)
+        {
+            weapon->ExecuteActivateEffect(AZ::Transform::CreateLookAt(fireParams.m_sourcePosition, fireParams.m_targetPosition), fireParams.m_targetPosition);
+        }
+#endif
+
         while (weaponState.m_activationCount != value)
         {
             constexpr bool validateActivations = false;
             ActivateWeaponWithParams(aznumeric_cast<WeaponIndex>(index), weaponState, fireParams, validateActivations);
         }
+
+#if MPS_DIAGNOSTICS
+        catchUpFrame.m_elapsedUs += aznumeric_cast<float>(AZStd::chrono::duration_cast<AZStd::chrono::microseconds>(AZStd::chrono::steady_clock::now() - start).count());
+        ++s_activationCatchUpStats.m_updateCount;
+        s_activationCatchUpStats.m_replayedCount += catchUp.m_replayedCount;
+        s_activationCatchUpStats.m_skippedCount += catchUp.m_skippedCount;
+        s_activationCatchUpStats.m_maxMissedCount = AZStd::max<uint32_t>(s_activationCatchUpStats.m_maxMissedCount, missedCount);
+        s_activationCatchUpStats.m_maxFrameUs = AZStd::max(s_activationCatchUpStats.m_maxFrameUs, catchUpFrame.m_elapsedUs);
+#endif
     }
 
     void NetworkWeaponsComponent::OnTickSimulatedWeapons(float seconds)
@@ -399,11 +653,36 @@ namespace MultiplayerSample
         {
             if (auto* weapon = GetWeapon(static_cast<WeaponIndex>(weaponIndex)))
             {
-                weapon->TickActiveShots(m_simulatedWeaponStates[weaponIndex], seconds);
+                WeaponState& weaponState = m_simulatedWeaponStates[weaponIndex];
+                switch (GetSimulationLod(*weapon))
+                {
+                case WeaponSimulationLod::Full:
+                    weapon->TickActiveShots(weaponState, seconds);
+                    break;
+                case WeaponSimulationLod::EndpointOnly:
+                    weapon->TickActiveShotEndpoints(weaponState, seconds);
+                    break;
+                case WeaponSimulationLod::Culled:
+                    weaponState.m_activeShots.clear();
+                    break;
+                }
             }
         }
     }
 
+    WeaponSimulationLod NetworkWeaponsComponent::GetSimulationLod(const IWeapon& weapon) const
+    {
+        // Authoritative shots decide hits and autonomous shots are the local player's own, neither is ever reduced
+        WeaponLodViewer viewer;
+        if (IsNetEntityRoleAuthority() || HasController() || !GetWeaponLodViewer(viewer))
+        {
+            return WeaponSimulationLod::Full;
+        }
+
+        const FireParams& fireParams = weapon.GetFireParams();
+        return ComputeWeaponSimulationLod(viewer, fireParams.m_sourcePosition, fireParams.m_targetPosition);
+    }
+
     NetworkWeaponsComponentController::NetworkWeaponsComponentController(NetworkWeaponsComponent& parent)
         : NetworkWeaponsComponentControllerBase(parent)
         , m_updateAI{[this] { UpdateAI(); }, AZ::Name{ "WeaponsControllerAI" } }
@@ -441,9 +720,7 @@ namespace MultiplayerSample
 
     AZ::Vector3 NetworkWeaponsComponent::GetCurrentShotStartPosition()
     {
-        constexpr uint32_t weaponIndexInt = 0;
-        const char* fireBoneName = GetFireBoneNames(weaponIndexInt).c_str();
-        const int32_t boneIdx = GetNetworkAnimationComponent()->GetBoneIdByName(fireBoneName);
+        const int32_t boneIdx = GetFireBoneJointId(PrimaryWeaponIndex);
 
         AZ::Transform fireBoneTransform = AZ::Transform::CreateIdentity();
         if (!GetNetworkAnimationComponent()->GetJointTransformById(boneIdx, fireBoneTransform))
@@ -507,82 +784,180 @@ namespace MultiplayerSample
             GetNetworkAnimationComponentController()->ModifyActiveAnimStates().SetBit(aznumeric_cast<uint32_t>(CharacterAnimState::Shooting), false);
         }
 
-        const AZ::Transform cameraTransform = GetNetworkSimplePlayerCameraComponentController()->GetCameraTransform(/*collisionEnabled=*/false);
-
-        for (uint32_t weaponIndexInt = 0; weaponIndexInt < MaxWeaponsPerComponent; ++weaponIndexInt)
+        if (weaponInput->m_firing.AnySet())
         {
-            if (weaponInput->m_firing.GetBit(weaponIndexInt))
+            // Replays on the autonomous client reuse the aim resolved when the input was first processed, keyed by the input id alone.
+            // The server never replays inputs, so it always resolves aim and keeps no history.
+            const Multiplayer::ClientInputId clientInputId = input.GetClientInputId();
+            const bool isReprocessing = GetNetBindComponent()->IsReprocessingInput();
+            ResolvedAim* resolvedAim = (cl_WeaponsCacheReplayedAim && IsNetEntityRoleAutonomous())
+                ? &m_resolvedAimHistory[aznumeric_cast<uint32_t>(clientInputId) % ResolvedAimHistorySize]
+                : nullptr;
+            const bool useResolvedAim = isReprocessing && (resolvedAim != nullptr) && (resolvedAim->m_clientInputId == clientInputId);
+            if ((resolvedAim != nullptr) && !useResolvedAim)
             {
-                const char* fireBoneName = GetFireBoneNames(weaponIndexInt).c_str();
-                int32_t boneIdx = GetNetworkAnimationComponentController()->GetParent().GetBoneIdByName(fireBoneName);
+                resolvedAim->m_clientInputId = clientInputId;
+                resolvedAim->m_resolvedWeapons.Reset();
+            }
 
-                AZ::Transform fireBoneTransform;
-                if (!GetNetworkAnimationComponentController()->GetParent().GetJointTransformById(boneIdx, fireBoneTransform))
+#if MPS_DIAGNOSTICS
+            const auto start = AZStd::chrono::steady_clock::now();
+#endif
+            // The camera is only needed to resolve aim, a replay served entirely from the history never reads it
+            AZ::Transform cameraTransform = AZ::Transform::CreateIdentity();
+            bool hasCameraTransform = false;
+            for (uint32_t weaponIndexInt = 0; weaponIndexInt < MaxWeaponsPerComponent; ++weaponIndexInt)
+            {
+                if (!weaponInput->m_firing.GetBit(weaponIndexInt))
                 {
-                    AZLOG_WARN("Failed to get transform for fire bone joint Id %u", boneIdx);
+                    continue;
                 }
 
-                // Validate the proposed start position is reasonably close to the related bone
-                if ((fireBoneTransform.GetTranslation() - weaponInput->m_shotStartPosition).GetLength() > sv_WeaponsStartPositionClampRange)
+                const WeaponIndex weaponIndex = aznumeric_cast<WeaponIndex>(weaponIndexInt);
+                if (useResolvedAim && resolvedAim->m_resolvedWeapons.GetBit(weaponIndexInt))
                 {
-                    weaponInput->m_shotStartPosition = fireBoneTransform.GetTranslation();
-                    AZLOG_WARN("Shot origin was outside of clamp range, resetting to bone position");
+                    weaponInput->m_shotStartPosition = resolvedAim->m_fireParams[weaponIndexInt].m_sourcePosition;
+                    TryStartFire(weaponIndex, resolvedAim->m_fireParams[weaponIndexInt]);
+                    continue;
                 }
 
-                // Setup a default aim target
-                const WeaponParams weaponParams = GetWeaponParams(weaponIndexInt);
-                AZ::Vector3 aimTarget = cameraTransform.GetTranslation() + cameraTransform.GetBasisY() * weaponParams.m_weaponMaxAimDistance;
-
-                // Given a plane centered on the shot start position with the orientation of the camera
-                // find the intersection of the camera ray with this plane and use it as the 
-                // start position for the trace to avoid any hits behind the weapon 
-                const AZ::Plane weaponPlane = AZ::Plane::CreateFromNormalAndPoint(cameraTransform.GetBasisY(), weaponInput->m_shotStartPosition);
-                AZ::Vector3 rayStart = cameraTransform.GetTranslation();
-                // on success, rayStart will contain the intersection point, on false we'll fallback to the camera translation
-                if (!weaponPlane.CastRay(cameraTransform.GetTranslation(), cameraTransform.GetBasisY(), rayStart))
+                if (!hasCameraTransform)
                 {
-                    AZLOG_WARN("Falling back to detect aim target based on camera origin");
+                    cameraTransform = GetNetworkSimplePlayerCameraComponentController()->GetCameraTransform(/*collisionEnabled=*/false);
+                    hasCameraTransform = true;
                 }
 
-                // Cast the ray in the physics system from the center of the camera forward
-                if (auto* sceneInterface = AZ::Interface<AzPhysics::SceneInterface>::Get())
+                const FireParams fireParams = ResolveFireParams(weaponIndex, *weaponInput, cameraTransform);
+                if (resolvedAim != nullptr)
+                {
+                    resolvedAim->m_fireParams[weaponIndexInt] = fireParams;
+                    resolvedAim->m_resolvedWeapons.SetBit(weaponIndexInt, true);
+                }
+                TryStartFire(weaponIndex, fireParams);
+            }
+
+#if MPS_DIAGNOSTICS
+            if (isReprocessing)
+            {
+                const float elapsedUs = aznumeric_cast<float>(AZStd::chrono::duration_cast<AZStd::chrono::microseconds>(AZStd::chrono::steady_clock::now() - start).count());
+                if (useResolvedAim)
+                {
+                    ++s_replayedAimStats.m_cachedCount;
+                    s_replayedAimStats.m_cachedUs += elapsedUs;
+                }
+                else
+                {
+                    ++s_replayedAimStats.m_resolvedCount;
+                    s_replayedAimStats.m_resolvedUs += elapsedUs;
+                }
+            }
+#endif
+        }
+
+        UpdateWeaponFiring(deltaTime);
+
+        if (IsNetEntityRoleAutonomous())
+        {
+            TrackPredictedActivations(input.GetClientInputId());
+        }
+    }
+
+    void NetworkWeaponsComponentController::TrackPredictedActivations(Multiplayer::ClientInputId clientInputId)
+    {
+        PredictedActivations& predictedActivations = m_predictedActivationHistory[aznumeric_cast<uint32_t>(clientInputId) % PredictedActivationHistorySize];
+        const bool isReprocessing = GetNetBindComponent()->IsReprocessingInput();
+        const bool isReplayingSameInput = isReprocessing && (predictedActivations.m_clientInputId == clientInputId);
+
+        bool activationsDiverged = false;
+        for (uint32_t weaponIndexInt = 0; weaponIndexInt < MaxWeaponsPerComponent; ++weaponIndexInt)
+        {
+            const uint8_t activationCount = GetWeaponStates(weaponIndexInt).m_activationCount;
+            activationsDiverged |= isReplayingSameInput && (predictedActivations.m_activationCounts[weaponIndexInt] != activationCount);
+            predictedActivations.m_activationCounts[weaponIndexInt] = activationCount;
+        }
+        predictedActivations.m_clientInputId = clientInputId;
+
+        // Once an input diverges every later replayed input usually does too, the whole replay is a single misprediction
+        if (!isReprocessing)
+        {
+            m_replayDiverged = false;
+        }
+        else if (activationsDiverged && !m_replayDiverged)
+        {
+            m_replayDiverged = true;
+            if (PredictionStats* predictionStats = GetPredictionStats())
+            {
+                predictionStats->RecordCorrection(CorrectionCause::WeaponDivergence);
+            }
+        }
+    }
+
+    FireParams NetworkWeaponsComponentController::ResolveFireParams(WeaponIndex weaponIndex, NetworkWeaponsComponentNetworkInput& weaponInput, const AZ::Transform& cameraTransform)
+    {
+        const int32_t boneIdx = GetParent().GetFireBoneJointId(weaponIndex);
+
+        AZ::Transform fireBoneTransform;
+        if (!GetNetworkAnimationComponentController()->GetParent().GetJointTransformById(boneIdx, fireBoneTransform))
+        {
+            AZLOG_WARN("Failed to get transform for fire bone joint Id %u", boneIdx);
+        }
+
+        // Validate the proposed start position is reasonably close to the related bone
+        if ((fireBoneTransform.GetTranslation() - weaponInput.m_shotStartPosition).GetLength() > sv_WeaponsStartPositionClampRange)
+        {
+            weaponInput.m_shotStartPosition = fireBoneTransform.GetTranslation();
+            AZLOG_WARN("Shot origin was outside of clamp range, resetting to bone position");
+        }
+
+        // Setup a default aim target
+        const WeaponParams& weaponParams = GetParent().GetWeaponDefinition(weaponIndex);
+        AZ::Vector3 aimTarget = cameraTransform.GetTranslation() + cameraTransform.GetBasisY() * weaponParams.m_weaponMaxAimDistance;
+
+        // Given a plane centered on the shot start position with the orientation of the camera
+        // find the intersection of the camera ray with this plane and use it as the 
+        // start position for the trace to avoid any hits behind the weapon 
+        const AZ::Plane weaponPlane = AZ::Plane::CreateFromNormalAndPoint(cameraTransform.GetBasisY(), weaponInput.m_shotStartPosition);
+        AZ::Vector3 rayStart = cameraTransform.GetTranslation();
+        // on success, rayStart will contain the intersection point, on false we'll fallback to the camera translation
+        if (!weaponPlane.CastRay(cameraTransform.GetTranslation(), cameraTransform.GetBasisY(), rayStart))
+        {
+            AZLOG_WARN("Falling back to detect aim target based on camera origin");
+        }
+
+        // Cast the ray in the physics system from the center of the camera forward
+        if (auto* sceneInterface = AZ::Interface<AzPhysics::SceneInterface>::Get())
+        {
+            if (AzPhysics::SceneHandle sceneHandle = SceneQuery::GetDefaultSceneHandle();
+                sceneHandle != AzPhysics::InvalidSceneHandle)
+            {
+                AzPhysics::RayCastRequest physicsRayRequest;
+                physicsRayRequest.m_start = rayStart;
+                physicsRayRequest.m_direction = cameraTransform.GetBasisY();
+                physicsRayRequest.m_distance = weaponParams.m_weaponMaxAimDistance;
+                physicsRayRequest.m_queryType = AzPhysics::SceneQuery::QueryType::StaticAndDynamic;
+                physicsRayRequest.m_reportMultipleHits = true;
+
+                if (AzPhysics::SceneQueryHits result = sceneInterface->QueryScene(sceneHandle, &physicsRayRequest))
                 {
-                    if (AzPhysics::SceneHandle sceneHandle = sceneInterface->GetSceneHandle(AzPhysics::DefaultPhysicsSceneName);
-                        sceneHandle != AzPhysics::InvalidSceneHandle)
+                    float minDistance = AZStd::numeric_limits<float>::max();
+                    for (const AzPhysics::SceneQueryHit& hit : result.m_hits)
                     {
-                        AzPhysics::RayCastRequest physicsRayRequest;
-                        physicsRayRequest.m_start = rayStart;
-                        physicsRayRequest.m_direction = cameraTransform.GetBasisY();
-                        physicsRayRequest.m_distance = weaponParams.m_weaponMaxAimDistance;
-                        physicsRayRequest.m_queryType = AzPhysics::SceneQuery::QueryType::StaticAndDynamic;
-                        physicsRayRequest.m_reportMultipleHits = true;
-
-                        if (AzPhysics::SceneQueryHits result = sceneInterface->QueryScene(sceneHandle, &physicsRayRequest))
+                        // Set target to closest found intersection within dot tolerance, if any
+                        AZ::Vector3 targetDirection = hit.m_position - weaponInput.m_shotStartPosition;
+                        AZ::Vector3 aimDirection = physicsRayRequest.m_direction;
+                        targetDirection.Normalize();
+                        aimDirection.Normalize();
+                        if ((targetDirection.Dot(aimDirection) > sv_WeaponsDotClamp) && (hit.m_distance <= minDistance))
                         {
-                            float minDistance = AZStd::numeric_limits<float>::max();
-                            for (const AzPhysics::SceneQueryHit& hit : result.m_hits)
-                            {
-                                // Set target to closest found intersection within dot tolerance, if any
-                                AZ::Vector3 targetDirection = hit.m_position - weaponInput->m_shotStartPosition;
-                                AZ::Vector3 aimDirection = physicsRayRequest.m_direction;
-                                targetDirection.Normalize();
-                                aimDirection.Normalize();
-                                if ((targetDirection.Dot(aimDirection) > sv_WeaponsDotClamp) && (hit.m_distance <= minDistance))
-                                {
-                                    aimTarget = hit.m_position;
-                                    minDistance = hit.m_distance;
-                                }
-                            }
+                            aimTarget = hit.m_position;
+                            minDistance = hit.m_distance;
                         }
                     }
-                }             
-
-                FireParams fireParams{ weaponInput->m_shotStartPosition, aimTarget, Multiplayer::InvalidNetEntityId };
-                TryStartFire(aznumeric_cast<WeaponIndex>(weaponIndexInt), fireParams);
+                }
             }
         }
 
-        UpdateWeaponFiring(deltaTime);
+        return FireParams{ weaponInput.m_shotStartPosition, aimTarget, Multiplayer::InvalidNetEntityId };
     }
 
     void NetworkWeaponsComponentController::UpdateWeaponFiring([[maybe_unused]] float deltaTime)
@@ -647,43 +1022,57 @@ namespace MultiplayerSample
         return false;
     }
 
-    void NetworkWeaponsComponentController::OnPressed([[maybe_unused]] float value)
+    const InputActionMap<WeaponInputAction>& GetWeaponInputActions()
     {
-        const StartingPointInput::InputEventNotificationId* inputId = StartingPointInput::InputEventNotificationBus::GetCurrentBusId();
+        static const InputActionMap<WeaponInputAction> weaponInputActions
+        {
+            { DrawEventId, WeaponInputAction::Draw },
+            { FirePrimaryEventId, WeaponInputAction::FirePrimary },
+            { FireSecondaryEventId, WeaponInputAction::FireSecondary },
+        };
+        return weaponInputActions;
+    }
 
-        if (inputId == nullptr)
+    void NetworkWeaponsComponentController::OnPressed([[maybe_unused]] float value)
+    {
+        WeaponInputAction action;
+        if (!GetWeaponInputActions().TryGetAction(StartingPointInput::InputEventNotificationBus::GetCurrentBusId(), action))
         {
             return;
         }
-        else if (*inputId == DrawEventId)
+
+        switch (action)
         {
+        case WeaponInputAction::Draw:
             m_weaponDrawnChanged = true;
-        }
-        else if (*inputId == FirePrimaryEventId)
-        {
+            break;
+        case WeaponInputAction::FirePrimary:
             m_weaponFiring.SetBit(aznumeric_cast<uint32_t>(PrimaryWeaponIndex), true);
-        }
-        else if (*inputId == FireSecondaryEventId)
-        {
+            break;
+        case WeaponInputAction::FireSecondary:
             m_weaponFiring.SetBit(aznumeric_cast<uint32_t>(SecondaryWeaponIndex), true);
+            break;
         }
     }
 
     void NetworkWeaponsComponentController::OnReleased([[maybe_unused]] float value)
     {
-        const StartingPointInput::InputEventNotificationId* inputId = StartingPointInput::InputEventNotificationBus::GetCurrentBusId();
-
-        if (inputId == nullptr)
+        WeaponInputAction action;
+        if (!GetWeaponInputActions().TryGetAction(StartingPointInput::InputEventNotificationBus::GetCurrentBusId(), action))
         {
             return;
         }
-        else if (*inputId == FirePrimaryEventId)
+
+        switch (action)
         {
+        case WeaponInputAction::FirePrimary:
             m_weaponFiring.SetBit(aznumeric_cast<uint32_t>(PrimaryWeaponIndex), false);
-        }
-        else if (*inputId == FireSecondaryEventId)
-        {
+            break;
+        case WeaponInputAction::FireSecondary:
             m_weaponFiring.SetBit(aznumeric_cast<uint32_t>(SecondaryWeaponIndex), false);
+            break;
+        default:
+            break;
         }
     }
 
@@ -702,4 +1091,84 @@ namespace MultiplayerSample
         }
 #endif
     }
+
+#if MPS_DIAGNOSTICS
+    static void cl_WeaponsCatchUpCheck([[maybe_unused]] const AZ::ConsoleCommandContainer& arguments)
+    {
+        struct CatchUpProfile
+        {
+            const char* m_name;
+            float m_activationIntervalSec;
+            float m_shotLifetimeSec;
+        };
+        constexpr CatchUpProfile profiles[] =
+        {
+            { "instant trace", 0.1f, 0.0f },
+            { "travelling trace", 0.1f, 0.35f },
+            { "projectile", 0.5f, 4.0f },
+            { "no cooldown", 0.0f, 1.0f },
+        };
+        constexpr uint32_t missedCounts[] = { 0, 1, 2, 5, 20, 64, 255 };
+
+        bool passed = true;
+        for (const CatchUpProfile& profile : profiles)
+        {
+            for (const uint32_t missedCount : missedCounts)
+            {
+                const ActivationCatchUp catchUp = ComputeActivationCatchUp(missedCount, cl_WeaponsMaxCatchUpActivations, profile.m_activationIntervalSec, profile.m_shotLifetimeSec);
+                const bool valid = (catchUp.m_replayedCount + catchUp.m_skippedCount == missedCount)
+                    && (catchUp.m_replayedCount <= cl_WeaponsMaxCatchUpActivations)
+                    && ((missedCount == 0) || (cl_WeaponsMaxCatchUpActivations == 0) || (catchUp.m_replayedCount > 0));
+                passed = passed && valid;
+                AZLOG_INFO("Catch up for %s weapon, %u missed activations: %u replayed, %u skipped%s",
+                    profile.m_name, missedCount, catchUp.m_replayedCount, catchUp.m_skippedCount, valid ? "" : " (invalid)");
+            }
+        }
+
+        // A late join delivers large jumps for every simulated weapon in the same frame
+        constexpr uint32_t burstWeaponCount = 64;
+        uint32_t frameEffectCount = 0;
+        uint32_t burstReplayedCount = 0;
+        for (uint32_t weapon = 0; weapon < burstWeaponCount; ++weapon)
+        {
+            ActivationCatchUp catchUp = ComputeActivationCatchUp(20, cl_WeaponsMaxCatchUpActivations, 0.5f, 4.0f);
+            const uint32_t newestCount = (catchUp.m_replayedCount > 0) ? 1 : 0;
+            bool playMergedEffect = true;
+            ApplyCatchUpFrameBudget(catchUp, playMergedEffect, frameEffectCount, cl_WeaponsMaxCatchUpEffectsPerFrame);
+            passed = passed && (catchUp.m_replayedCount + catchUp.m_skippedCount == 20) && (catchUp.m_replayedCount >= newestCount);
+            burstReplayedCount += catchUp.m_replayedCount;
+        }
+        passed = passed && (frameEffectCount <= cl_WeaponsMaxCatchUpEffectsPerFrame);
+        AZLOG_INFO("Catch up burst of %u weapons in one frame: %u activations replayed, %u catch up effects played",
+            burstWeaponCount, burstReplayedCount, frameEffectCount);
+
+        if (passed)
+        {
+            AZLOG_INFO("Weapon catch up check passed, at most %u activations are replayed per update and %u catch up effects per frame",
+                static_cast<uint32_t>(cl_WeaponsMaxCatchUpActivations), static_cast<uint32_t>(cl_WeaponsMaxCatchUpEffectsPerFrame));
+        }
+        else
+        {
+            AZLOG_WARN("Weapon catch up check failed");
+        }
+
+        AZLOG_INFO("Weapon catch up stats: %llu updates, %llu activations replayed, %llu skipped, largest jump %u, worst frame %.1f us",
+            aznumeric_cast<unsigned long long>(s_activationCatchUpStats.m_updateCount),
+            aznumeric_cast<unsigned long long>(s_activationCatchUpStats.m_replayedCount),
+            aznumeric_cast<unsigned long long>(s_activationCatchUpStats.m_skippedCount),
+            s_activationCatchUpStats.m_maxMissedCount, s_activationCatchUpStats.m_maxFrameUs);
+    }
+    AZ_CONSOLEFREEFUNC(cl_WeaponsCatchUpCheck, AZ::ConsoleFunctorFlags::Null, "Runs synthetic activation count jumps through the simulated weapon catch up policy and logs the worst catch up frame measured so far");
+#endif
+
+#if MPS_DIAGNOSTICS
+    static void cl_WeaponsReplayedAimStats([[maybe_unused]] const AZ::ConsoleCommandContainer& arguments)
+    {
+        const ReplayedAimStats& stats = s_replayedAimStats;
+        AZLOG_INFO("Replayed firing inputs: %llu reused their aim (%.2f us avg), %llu resolved it again (%.2f us avg)",
+            aznumeric_cast<unsigned long long>(stats.m_cachedCount), (stats.m_cachedCount > 0) ? stats.m_cachedUs / stats.m_cachedCount : 0.0f,
+            aznumeric_cast<unsigned long long>(stats.m_resolvedCount), (stats.m_resolvedCount > 0) ? stats.m_resolvedUs / stats.m_resolvedCount : 0.0f);
+    }
+    AZ_CONSOLEFREEFUNC(cl_WeaponsReplayedAimStats, AZ::ConsoleFunctorFlags::Null, "Logs how many replayed firing inputs reused their resolved aim and the average aim resolution cost of each");
+#endif
 } // namespace MultiplayerSample
@@ -8,8 +8,10 @@
 #pragma once
 
 #include <Source/AutoGen/NetworkWeaponsComponent.AutoComponent.h>
+#include <Source/Components/InputActionMap.h>
 #include <Source/Components/NetworkAiComponent.h>
 #include <Source/Weapons/IWeapon.h>
+#include <Source/Weapons/WeaponSimulationLod.h>
 #include <StartingPointInput/InputEventNotificationBus.h>
 
 namespace DebugDraw { class DebugDrawRequests; }
@@ -24,6 +26,17 @@ namespace MultiplayerSample
     const WeaponIndex PrimaryWeaponIndex   = WeaponIndex{ 0 };
     const WeaponIndex SecondaryWeaponIndex = WeaponIndex{ 1 };
 
+    //! Actions the weapons controller performs for its input events.
+    enum class WeaponInputAction : uint8_t
+    {
+        Draw,
+        FirePrimary,
+        FireSecondary
+    };
+
+    //! Returns the map from weapon input events to weapon actions.
+    const InputActionMap<WeaponInputAction>& GetWeaponInputActions();
+
     using OnWeaponActivateEvent = AZ::Event<const WeaponActivationInfo&>;
     using OnWeaponPredictHitEvent = AZ::Event<const WeaponHitInfo&>;
     using OnWeaponConfirmHitEvent = AZ::Event<const WeaponHitInfo&>;
@@ -45,17 +58,28 @@ namespace MultiplayerSample
 
 #if AZ_TRAIT_CLIENT
         void HandleSendConfirmHit(AzNetworking::IConnection* invokingConnection, const WeaponIndex& weaponIndex, const HitEvent& hitEvent) override;
+        void HandleSendConfirmHits(AzNetworking::IConnection* invokingConnection, const HitConfirmBatch& hitConfirmBatch) override;
 #endif
         void ActivateWeaponWithParams(WeaponIndex weaponIndex, WeaponState& weaponState, const FireParams& fireParams, bool validateActivations);
 
         IWeapon* GetWeapon(WeaponIndex weaponIndex) const;
 
+        //! Returns the parameters a weapon is constructed from, the shared definition if one is named and empty parameters otherwise.
+        //! @param weaponIndex the weapon to return the parameters for
+        //! @return the weapon parameters
+        const WeaponParams& GetWeaponDefinition(WeaponIndex weaponIndex) const;
+
         void AddOnWeaponActivateEventHandler(OnWeaponActivateEvent::Handler& handler);
         void AddOnWeaponPredictHitEventHandler(OnWeaponPredictHitEvent::Handler& handler);
         void AddOnWeaponConfirmHitEventHandler(OnWeaponConfirmHitEvent::Handler& handler);
 
         AZ::Vector3 GetCurrentShotStartPosition();
 
+        //! Returns the joint index of a weapon's fire bone, resolved whenever the actor instance changes.
+        //! @param weaponIndex the weapon to return the fire bone for
+        //! @return the joint index of the fire bone, InvalidBoneId if it could not be resolved
+        int32_t GetFireBoneJointId(WeaponIndex weaponIndex) const;
+
     private:
         //! WeaponListener interface
         //! @{
@@ -68,13 +92,29 @@ namespace MultiplayerSample
 
         void OnUpdateActivationCounts(int32_t index, uint8_t value);
         void OnTickSimulatedWeapons(float seconds);
+        void ResolveFireBones();
+
+        //! Picks the level of detail to simulate a weapon's shots with, only remote proxies are ever reduced.
+        //! @param weapon the weapon whose latest fire params are used
+        //! @return the level of detail to simulate the weapon's shots with
+        WeaponSimulationLod GetSimulationLod(const IWeapon& weapon) const;
+
+        //! Queues a confirmed hit event to be sent to clients with every other hit event confirmed this tick.
+        //! @param hitInfo the confirmed hit event
+        void QueueConfirmedHit(const WeaponHitInfo& hitInfo);
+
+        //! Sends every queued confirmed hit event to clients in a single batch.
+        void FlushConfirmedHits();
 
         using WeaponPointer = AZStd::unique_ptr<IWeapon>;
         AZStd::array<WeaponPointer, MaxWeaponsPerComponent> m_weapons;
 
         AZ::Event<int32_t, uint8_t>::Handler m_activationCountHandler;
+        AZ::Event<>::Handler m_actorChangedHandler;
         AZStd::array<WeaponState, MaxWeaponsPerComponent> m_simulatedWeaponStates;
         AZStd::array<int32_t, MaxWeaponsPerComponent> m_fireBoneJointIds;
+        AZStd::array<WeaponDefinitionIndex, MaxWeaponsPerComponent> m_weaponDefinitionIndices;
+        HitConfirmBatch m_confirmedHits;
 
         DebugDraw::DebugDrawRequests* m_debugDraw = nullptr;
 
@@ -86,6 +126,11 @@ namespace MultiplayerSample
         {
             OnTickSimulatedWeapons(AZ::TimeMsToSeconds(m_tickSimulatedWeapons.TimeInQueueMs()));
         }, AZ::Name("TickSimulatedWeapons")};
+
+        AZ::ScheduledEvent m_flushConfirmedHits{[this]()
+        {
+            FlushConfirmedHits();
+        }, AZ::Name("FlushConfirmedHits")};
     };
 
     class NetworkWeaponsComponentController
@@ -114,6 +159,13 @@ namespace MultiplayerSample
         //! @return boolean true on activate, false if the weapon failed to activate
         virtual bool TryStartFire(WeaponIndex weaponIndex, const FireParams& fireParams);
 
+        //! Resolves the shot start and aim target for a firing weapon from the fire bone and a camera raycast.
+        //! @param weaponIndex     the weapon being fired
+        //! @param weaponInput     the input being processed, the shot start position is clamped to the fire bone
+        //! @param cameraTransform the camera transform of the input
+        //! @return the fire params to start firing with
+        FireParams ResolveFireParams(WeaponIndex weaponIndex, NetworkWeaponsComponentNetworkInput& weaponInput, const AZ::Transform& cameraTransform);
+
         //! AZ::InputEventNotificationBus interface
         //! @{
         void OnPressed(float value) override;
@@ -132,5 +184,30 @@ namespace MultiplayerSample
         bool m_weaponDrawn = true;
         bool m_weaponDrawnChanged = false;
         WeaponActivationBitset m_weaponFiring;
+
+        //! Fire params resolved for a single input on the autonomous client, replays of the input reuse them.
+        struct ResolvedAim
+        {
+            Multiplayer::ClientInputId m_clientInputId = Multiplayer::ClientInputId{ 0 };
+            WeaponActivationBitset m_resolvedWeapons; // Weapons with valid entries in m_fireParams
+            AZStd::array<FireParams, MaxWeaponsPerComponent> m_fireParams;
+        };
+        static constexpr uint32_t ResolvedAimHistorySize = 64; // Covers the inputs in flight at roughly one second of latency at 60hz
+        AZStd::array<ResolvedAim, ResolvedAimHistorySize> m_resolvedAimHistory;
+
+        //! Activation counts after a single locally predicted input, replayed inputs that end differently mispredicted a weapon.
+        struct PredictedActivations
+        {
+            Multiplayer::ClientInputId m_clientInputId = Multiplayer::ClientInputId{ 0 };
+            AZStd::array<uint8_t, MaxWeaponsPerComponent> m_activationCounts = {};
+        };
+        static constexpr uint32_t PredictedActivationHistorySize = 64; // Covers the inputs a correction replays at roughly one second of latency at 60hz
+        AZStd::array<PredictedActivations, PredictedActivationHistorySize> m_predictedActivationHistory;
+        bool m_replayDiverged = false; // Set once a replay has reported a weapon misprediction, cleared by the next new input
+
+        //! Records the activation counts for a locally predicted input and reports a weapon misprediction if a replay of it ends differently.
+        //! Each replay reports at most one misprediction however many of its inputs diverged.
+        //! @param clientInputId the id of the input that was just processed
+        void TrackPredictedActivations(Multiplayer::ClientInputId clientInputId);
     };
 }
@@ -5,14 +5,185 @@
  *
  */
 
+#include <AzCore/Console/IConsole.h>
+#include <AzCore/Console/ILogger.h>
 #include <AzCore/Serialization/EditContext.h>
-#include <AzFramework/Visibility/OcclusionBus.h>
+#include <AzCore/std/algorithm.h>
+#include <AzCore/std/chrono/chrono.h>
 #include <Components/OcclusionFilteredEntityComponent.h>
+#include <Source/MultiplayerSampleTypes.h>
 #include <Multiplayer/IMultiplayer.h>
 #include <Multiplayer/Components/NetBindComponent.h>
+#include <Multiplayer/NetworkTime/INetworkTime.h>
 
 namespace MultiplayerSample
 {
+    bool OcclusionBusVisibilityProvider::EnsureOcclusionView(const AZ::Name& viewName)
+    {
+        bool result = false;
+        AzFramework::OcclusionRequestBus::Broadcast([&](AzFramework::OcclusionRequestBus::Events* occlusionHandler) {
+            // Check for a preexisting occlusion view or create one if necessary.
+            if (!occlusionHandler->IsOcclusionViewValid(viewName))
+            {
+                occlusionHandler->CreateOcclusionView(viewName);
+            }
+            result = occlusionHandler->IsOcclusionViewValid(viewName);
+            });
+        return result;
+    }
+
+    AZStd::vector<AzFramework::OcclusionState> OcclusionBusVisibilityProvider::GetEntityToEntityVisibility(
+        const AZ::Name& viewName, AZ::EntityId viewerEntityId, const AZStd::vector<AZ::EntityId>& targetEntityIds)
+    {
+        AZStd::vector<AzFramework::OcclusionState> result;
+        AzFramework::OcclusionRequestBus::Broadcast([&](AzFramework::OcclusionRequestBus::Events* occlusionHandler) {
+            result = occlusionHandler->GetOcclusionViewEntityToEntityVisibility(viewName, viewerEntityId, targetEntityIds);
+            });
+        return result;
+    }
+
+    void OcclusionVisibilityCache::Configure(OcclusionVisibilityProvider* provider, const AZ::Name& viewName)
+    {
+        Clear();
+        m_provider = provider;
+        m_viewName = viewName;
+    }
+
+    bool OcclusionVisibilityCache::IsHidden(AzNetworking::ConnectionId connectionId, AZ::EntityId viewerEntityId, AZ::EntityId entityId, Multiplayer::HostFrameId frameId)
+    {
+        ++m_stats.m_lookupCount;
+        if (frameId != m_frameId)
+        {
+            BeginFrame(frameId);
+        }
+
+        const auto slotIter = m_playerSlots.find(entityId);
+        if (slotIter == m_playerSlots.end())
+        {
+            // Players that joined this frame get a slot next frame, until then they are queried on their own
+            if (AZStd::find(m_newPlayers.begin(), m_newPlayers.end(), entityId) == m_newPlayers.end())
+            {
+                m_newPlayers.push_back(entityId);
+            }
+            return QuerySingle(viewerEntityId, entityId);
+        }
+
+        const uint32_t slot = slotIter->second;
+        m_seenSlots.set(slot);
+
+        ConnectionVisibility& visibility = m_connections[connectionId];
+        if ((visibility.m_frameId != m_frameId) || (visibility.m_viewerEntityId != viewerEntityId))
+        {
+            UpdateConnection(visibility, viewerEntityId);
+        }
+        return visibility.m_hidden.test(slot);
+    }
+
+    void OcclusionVisibilityCache::Clear()
+    {
+        m_connections.clear();
+        m_players.clear();
+        m_playerSlots.clear();
+        m_seenSlots.reset();
+        m_newPlayers.clear();
+        m_frameId = Multiplayer::InvalidHostFrameId;
+        m_viewChecked = false;
+        m_viewValid = false;
+    }
+
+    OcclusionVisibilityCache::Stats& OcclusionVisibilityCache::GetStats()
+    {
+        return m_stats;
+    }
+
+    void OcclusionVisibilityCache::BeginFrame(Multiplayer::HostFrameId frameId)
+    {
+        // Players queried last frame are batched this frame, players that weren't queried for a whole frame give up their slot
+        AZStd::vector<AZ::EntityId> players;
+        players.reserve(m_players.size() + m_newPlayers.size());
+        for (uint32_t slot = 0; slot < m_players.size(); ++slot)
+        {
+            if (m_seenSlots.test(slot))
+            {
+                players.push_back(m_players[slot]);
+            }
+        }
+        for (const AZ::EntityId& entityId : m_newPlayers)
+        {
+            if (players.size() < MaxCachedPlayers)
+            {
+                players.push_back(entityId);
+            }
+        }
+
+        m_players.swap(players);
+        m_playerSlots.clear();
+        for (uint32_t slot = 0; slot < m_players.size(); ++slot)
+        {
+            m_playerSlots.emplace(m_players[slot], slot);
+        }
+        m_seenSlots.reset();
+        m_newPlayers.clear();
+
+        // Connections without a query last frame are dropped, they are rebuilt on their next query
+        for (auto iter = m_connections.begin(); iter != m_connections.end();)
+        {
+            iter = (iter->second.m_frameId != m_frameId) ? m_connections.erase(iter) : AZStd::next(iter);
+        }
+
+        m_frameId = frameId;
+        m_viewChecked = false;
+    }
+
+    bool OcclusionVisibilityCache::EnsureView()
+    {
+        // The view is checked once per frame rather than once per query
+        if (!m_viewChecked)
+        {
+            m_viewValid = (m_provider != nullptr) && m_provider->EnsureOcclusionView(m_viewName);
+            m_viewChecked = true;
+        }
+        return m_viewValid;
+    }
+
+    void OcclusionVisibilityCache::UpdateConnection(ConnectionVisibility& visibility, AZ::EntityId viewerEntityId)
+    {
+        visibility.m_frameId = m_frameId;
+        visibility.m_viewerEntityId = viewerEntityId;
+        visibility.m_hidden.reset();
+
+        if (m_players.empty() || !EnsureView())
+        {
+            return;
+        }
+
+        ++m_stats.m_batchQueryCount;
+        const AZStd::vector<AzFramework::OcclusionState> states = m_provider->GetEntityToEntityVisibility(m_viewName, viewerEntityId, m_players);
+
+        // If the query failed nothing is filtered, matching the unbatched behaviour
+        if (states.size() != m_players.size())
+        {
+            return;
+        }
+
+        for (uint32_t slot = 0; slot < states.size(); ++slot)
+        {
+            visibility.m_hidden.set(slot, states[slot] == AzFramework::OcclusionState::Hidden);
+        }
+    }
+
+    bool OcclusionVisibilityCache::QuerySingle(AZ::EntityId viewerEntityId, AZ::EntityId entityId)
+    {
+        if (!EnsureView())
+        {
+            return false;
+        }
+
+        ++m_stats.m_singleQueryCount;
+        const AZStd::vector<AzFramework::OcclusionState> states = m_provider->GetEntityToEntityVisibility(m_viewName, viewerEntityId, AZStd::vector<AZ::EntityId>{ entityId });
+        return (!states.empty() && (states[0] == AzFramework::OcclusionState::Hidden));
+    }
+
     void OcclusionFilteredEntityComponent::Reflect(AZ::ReflectContext* context)
     {
         AZ::SerializeContext* serializeContext = azrtti_cast<AZ::SerializeContext*>(context);
@@ -34,6 +205,7 @@ namespace MultiplayerSample
 
     void OcclusionFilteredEntityComponent::Activate()
     {
+        m_visibilityCache.Configure(&m_visibilityProvider, m_occlusionViewName);
         AZ::Interface<IFilterEntityManager>::Register(this);
 
         // Create an occlusion view just for performing clear to player visibility tests.
@@ -44,38 +216,170 @@ namespace MultiplayerSample
     {
         AZ::Interface<IFilterEntityManager>::Unregister(this);
         AzFramework::OcclusionRequestBus::Broadcast(&AzFramework::OcclusionRequestBus::Events::DestroyOcclusionView, m_occlusionViewName);
+        m_visibilityCache.Clear();
     }
 
     bool OcclusionFilteredEntityComponent::IsEntityFiltered(
         AZ::Entity* entity,
         Multiplayer::ConstNetworkEntityHandle controllerEntity,
-        [[maybe_unused]] AzNetworking::ConnectionId connectionId)
+        AzNetworking::ConnectionId connectionId)
     {
-        bool result = false;
-
         // If one is available, use the occlusion culling system to filter out players that cannot be seen by the controlled player.
         const auto entityNetBindComponent = entity->FindComponent<Multiplayer::NetBindComponent>();
         const auto entityConnectionId = entityNetBindComponent ? entityNetBindComponent->GetOwningConnectionId() : AzNetworking::InvalidConnectionId;
-        if (entityConnectionId != AzNetworking::InvalidConnectionId)
+        const AZ::Entity* controlledEntity = controllerEntity.GetEntity();
+        if ((entityConnectionId == AzNetworking::InvalidConnectionId) || (controlledEntity == nullptr))
+        {
+            return false;
+        }
+
+        // Visibility of every player is resolved in one query per connection per frame, the rest of the frame reads the cached result
+        const Multiplayer::HostFrameId frameId = Multiplayer::GetNetworkTime()->GetHostFrameId();
+        return m_visibilityCache.IsHidden(connectionId, controlledEntity->GetId(), entity->GetId(), frameId);
+    }
+
+#if MPS_DIAGNOSTICS
+    //! Deterministic occlusion provider for running the visibility cache without the occlusion culling system.
+    //! A target is hidden from a viewer when the pair hashes into the hidden fraction.
+    class StubOcclusionVisibilityProvider final
+        : public OcclusionVisibilityProvider
+    {
+    public:
+        bool EnsureOcclusionView([[maybe_unused]] const AZ::Name& viewName) override
+        {
+            ++m_viewChecks;
+            return true;
+        }
+
+        AZStd::vector<AzFramework::OcclusionState> GetEntityToEntityVisibility(
+            [[maybe_unused]] const AZ::Name& viewName, AZ::EntityId viewerEntityId, const AZStd::vector<AZ::EntityId>& targetEntityIds) override
         {
-            AzFramework::OcclusionRequestBus::Broadcast([&](AzFramework::OcclusionRequestBus::Events* occlusionHandler) {
-                // Check for a preexisting occlusion view or create one if necessary.
-                if (!occlusionHandler->IsOcclusionViewValid(m_occlusionViewName))
+            ++m_queries;
+            AZStd::vector<AzFramework::OcclusionState> states;
+            states.reserve(targetEntityIds.size());
+            for (const AZ::EntityId& targetEntityId : targetEntityIds)
+            {
+                states.push_back(IsHidden(viewerEntityId, targetEntityId) ? AzFramework::OcclusionState::Hidden : AzFramework::OcclusionState::Visible);
+            }
+            return states;
+        }
+
+        static bool IsHidden(AZ::EntityId viewerEntityId, AZ::EntityId targetEntityId)
+        {
+            if (viewerEntityId == targetEntityId)
+            {
+                return false;
+            }
+            const uint64_t hash = (static_cast<AZ::u64>(viewerEntityId) * 2654435761ull) ^ (static_cast<AZ::u64>(targetEntityId) * 40503ull);
+            return (hash % 3) == 0;
+        }
+
+        uint64_t m_viewChecks = 0;
+        uint64_t m_queries = 0;
+    };
+
+    static void sv_OcclusionFilterCheck([[maybe_unused]] const AZ::ConsoleCommandContainer& arguments)
+    {
+        constexpr uint32_t PlayerCount = 16;
+        constexpr uint32_t FrameCount = 4;
+        const AZ::Name viewName("OcclusionFilterCheckView");
+
+        StubOcclusionVisibilityProvider provider;
+        OcclusionVisibilityCache cache;
+        cache.Configure(&provider, viewName);
+
+        // Each player is both a viewer with its own connection and a target, a late player joins on the second frame
+        uint32_t failures = 0;
+        for (uint32_t frame = 0; frame < FrameCount; ++frame)
+        {
+            const uint32_t playerCount = (frame == 0) ? PlayerCount - 1 : PlayerCount;
+            const uint64_t queriesBefore = provider.m_queries;
+            const uint64_t viewChecksBefore = provider.m_viewChecks;
+            for (uint32_t viewer = 0; viewer < playerCount; ++viewer)
+            {
+                const AZ::EntityId viewerEntityId(viewer + 1);
+                for (uint32_t target = 0; target < playerCount; ++target)
                 {
-                    occlusionHandler->CreateOcclusionView(m_occlusionViewName);
+                    const AZ::EntityId targetEntityId(target + 1);
+                    const bool isHidden = cache.IsHidden(AzNetworking::ConnectionId{ viewer + 1 }, viewerEntityId, targetEntityId, Multiplayer::HostFrameId{ frame + 1 });
+                    if (isHidden != StubOcclusionVisibilityProvider::IsHidden(viewerEntityId, targetEntityId))
+                    {
+                        AZLOG_WARN("Occlusion filter check failed: frame %u viewer %u target %u returned %s", frame, viewer, target, isHidden ? "hidden" : "visible");
+                        ++failures;
+                    }
                 }
+            }
+
+            // Once every player has a slot each connection costs exactly one occlusion query per frame
+            if ((frame >= 2) && (provider.m_queries - queriesBefore != playerCount))
+            {
+                AZLOG_WARN("Occlusion filter check failed: frame %u issued %llu queries for %u connections", frame,
+                    static_cast<unsigned long long>(provider.m_queries - queriesBefore), playerCount);
+                ++failures;
+            }
+            if (provider.m_viewChecks - viewChecksBefore != 1)
+            {
+                AZLOG_WARN("Occlusion filter check failed: frame %u checked the occlusion view %llu times", frame,
+                    static_cast<unsigned long long>(provider.m_viewChecks - viewChecksBefore));
+                ++failures;
+            }
+        }
+
+        AZLOG_INFO("Occlusion filter check: %u failures", failures);
+    }
+    AZ_CONSOLEFREEFUNC(sv_OcclusionFilterCheck, AZ::ConsoleFunctorFlags::Null, "Checks the per frame occlusion visibility cache against direct queries using a stub occlusion provider");
 
-                if (occlusionHandler->IsOcclusionViewValid(m_occlusionViewName))
+    static void sv_OcclusionFilterBenchmark(const AZ::ConsoleCommandContainer& arguments)
+    {
+        const uint32_t playerCount = (arguments.size() > 0) ? aznumeric_cast<uint32_t>(AZStd::stoi(AZStd::string(arguments[0]))) : 64;
+        const uint32_t frameCount = (arguments.size() > 1) ? aznumeric_cast<uint32_t>(AZStd::stoi(AZStd::string(arguments[1]))) : 100;
+        const AZ::Name viewName("OcclusionFilterBenchmarkView");
+
+        StubOcclusionVisibilityProvider provider;
+        OcclusionVisibilityCache cache;
+        cache.Configure(&provider, viewName);
+
+        // Unbatched, every connection checks the view and queries every player on its own
+        uint64_t hiddenCount = 0;
+        auto start = AZStd::chrono::steady_clock::now();
+        for (uint32_t frame = 0; frame < frameCount; ++frame)
+        {
+            for (uint32_t viewer = 0; viewer < playerCount; ++viewer)
+            {
+                for (uint32_t target = 0; target < playerCount; ++target)
                 {
-                    // Perform an occlusion query to determine if the controlled entity can see the filtered entity.
-                    const auto visibility = occlusionHandler->GetOcclusionViewEntityToEntityVisibility(
-                        m_occlusionViewName, controllerEntity.GetEntity()->GetId(), AZStd::vector<AZ::EntityId>{ entity->GetId() }
-                    );
-                    // If the query succeeded and the entity cannot be seen then filter it out from network replication.
-                    result = (!visibility.empty() && (visibility[0] == AzFramework::OcclusionState::Hidden));
+                    provider.EnsureOcclusionView(viewName);
+                    const auto states = provider.GetEntityToEntityVisibility(viewName, AZ::EntityId(viewer + 1), AZStd::vector<AZ::EntityId>{ AZ::EntityId(target + 1) });
+                    hiddenCount += (!states.empty() && (states[0] == AzFramework::OcclusionState::Hidden)) ? 1 : 0;
                 }
-                });
+            }
         }
-        return result;
+        const float unbatchedUs = aznumeric_cast<float>(AZStd::chrono::duration_cast<AZStd::chrono::microseconds>(AZStd::chrono::steady_clock::now() - start).count());
+        const uint64_t unbatchedQueries = provider.m_queries;
+
+        provider.m_queries = 0;
+        uint64_t cachedHiddenCount = 0;
+        start = AZStd::chrono::steady_clock::now();
+        for (uint32_t frame = 0; frame < frameCount; ++frame)
+        {
+            for (uint32_t viewer = 0; viewer < playerCount; ++viewer)
+            {
+                for (uint32_t target = 0; target < playerCount; ++target)
+                {
+                    cachedHiddenCount += cache.IsHidden(AzNetworking::ConnectionId{ viewer + 1 }, AZ::EntityId(viewer + 1), AZ::EntityId(target + 1), Multiplayer::HostFrameId{ frame + 1 }) ? 1 : 0;
+                }
+            }
+        }
+        const float cachedUs = aznumeric_cast<float>(AZStd::chrono::duration_cast<AZStd::chrono::microseconds>(AZStd::chrono::steady_clock::now() - start).count());
+
+        const float frames = aznumeric_cast<float>(AZStd::max(frameCount, 1u));
+        AZLOG_INFO("Occlusion filter benchmark, %u players over %u frames: unbatched %.1f us and %llu queries per frame, cached %.1f us and %llu queries per frame, "
+            "%llu unbatched and %llu cached hidden results",
+            playerCount, frameCount,
+            unbatchedUs / frames, static_cast<unsigned long long>(unbatchedQueries / AZStd::max(frameCount, 1u)),
+            cachedUs / frames, static_cast<unsigned long long>(provider.m_queries / AZStd::max(frameCount, 1u)),
+            static_cast<unsigned long long>(hiddenCount), static_cast<unsigned long long>(cachedHiddenCount));
     }
+    AZ_CONSOLEFREEFUNC(sv_OcclusionFilterBenchmark, AZ::ConsoleFunctorFlags::Null, "Times unbatched occlusion queries against the per frame visibility cache using a stub occlusion provider, optionally takes player count and frame count");
+#endif
 }
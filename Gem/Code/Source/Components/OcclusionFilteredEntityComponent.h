@@ -8,10 +8,105 @@
 #pragma once
 
 #include <AzCore/Component/Component.h>
+#include <AzCore/Name/Name.h>
+#include <AzCore/std/containers/bitset.h>
+#include <AzCore/std/containers/unordered_map.h>
+#include <AzCore/std/containers/vector.h>
+#include <AzFramework/Visibility/OcclusionBus.h>
+#include <Multiplayer/MultiplayerTypes.h>
 #include <Multiplayer/NetworkEntity/IFilterEntityManager.h>
 
 namespace MultiplayerSample
 {
+    //! @class OcclusionVisibilityProvider
+    //! @brief Source of entity to entity occlusion queries, allows the visibility cache to run without the occlusion culling system.
+    class OcclusionVisibilityProvider
+    {
+    public:
+        virtual ~OcclusionVisibilityProvider() = default;
+
+        //! Checks for a preexisting occlusion view, creating one if necessary.
+        //! @return true if the view can be queried
+        virtual bool EnsureOcclusionView(const AZ::Name& viewName) = 0;
+
+        //! Queries the visibility of a set of entities from a viewing entity.
+        //! @return one occlusion state per target entity, or an empty vector if the query failed
+        virtual AZStd::vector<AzFramework::OcclusionState> GetEntityToEntityVisibility(
+            const AZ::Name& viewName, AZ::EntityId viewerEntityId, const AZStd::vector<AZ::EntityId>& targetEntityIds) = 0;
+    };
+
+    //! @class OcclusionBusVisibilityProvider
+    //! @brief Forwards occlusion queries to the occlusion culling system over the OcclusionRequestBus.
+    class OcclusionBusVisibilityProvider final
+        : public OcclusionVisibilityProvider
+    {
+    public:
+        bool EnsureOcclusionView(const AZ::Name& viewName) override;
+        AZStd::vector<AzFramework::OcclusionState> GetEntityToEntityVisibility(
+            const AZ::Name& viewName, AZ::EntityId viewerEntityId, const AZStd::vector<AZ::EntityId>& targetEntityIds) override;
+    };
+
+    //! @class OcclusionVisibilityCache
+    //! @brief Caches player visibility per connection for a single host frame.
+    //! The first query for a connection in a frame resolves the visibility of every player seen during the previous frame in one
+    //! batched occlusion query, later queries for the same connection and frame are answered from a bitset indexed by player slot.
+    class OcclusionVisibilityCache
+    {
+    public:
+        static constexpr uint32_t MaxCachedPlayers = 256;
+
+        //! Sets the provider and occlusion view used for queries, the provider must outlive the cache.
+        void Configure(OcclusionVisibilityProvider* provider, const AZ::Name& viewName);
+
+        //! Returns whether a player entity is hidden from a connection's controlled entity.
+        //! @param connectionId   the connection being updated
+        //! @param viewerEntityId the connection's controlled entity
+        //! @param entityId       the player entity being considered
+        //! @param frameId        the host frame of the query, cached visibility is discarded when the frame changes
+        //! @return true if the occlusion query succeeded and the player cannot be seen
+        bool IsHidden(AzNetworking::ConnectionId connectionId, AZ::EntityId viewerEntityId, AZ::EntityId entityId, Multiplayer::HostFrameId frameId);
+
+        //! Drops every cached result and known player.
+        void Clear();
+
+        //! @struct Stats
+        //! @brief Counters accumulated since startup or the last reset.
+        struct Stats
+        {
+            uint64_t m_lookupCount = 0;      // Calls to IsHidden
+            uint64_t m_batchQueryCount = 0;  // Batched occlusion queries issued
+            uint64_t m_singleQueryCount = 0; // Occlusion queries for players not yet in a batch
+        };
+        Stats& GetStats();
+
+    private:
+        using PlayerBits = AZStd::bitset<MaxCachedPlayers>;
+
+        struct ConnectionVisibility
+        {
+            Multiplayer::HostFrameId m_frameId = Multiplayer::InvalidHostFrameId;
+            AZ::EntityId m_viewerEntityId;
+            PlayerBits m_hidden;
+        };
+
+        void BeginFrame(Multiplayer::HostFrameId frameId);
+        bool EnsureView();
+        void UpdateConnection(ConnectionVisibility& visibility, AZ::EntityId viewerEntityId);
+        bool QuerySingle(AZ::EntityId viewerEntityId, AZ::EntityId entityId);
+
+        OcclusionVisibilityProvider* m_provider = nullptr;
+        AZ::Name m_viewName;
+        AZStd::unordered_map<AzNetworking::ConnectionId, ConnectionVisibility> m_connections;
+        AZStd::vector<AZ::EntityId> m_players; // Players batched during the current frame, indexed by slot
+        AZStd::unordered_map<AZ::EntityId, uint32_t> m_playerSlots;
+        PlayerBits m_seenSlots; // Slots queried during the current frame, batched again during the next
+        AZStd::vector<AZ::EntityId> m_newPlayers; // Players without a slot queried during the current frame, batched during the next
+        Multiplayer::HostFrameId m_frameId = Multiplayer::InvalidHostFrameId;
+        bool m_viewChecked = false;
+        bool m_viewValid = false;
+        Stats m_stats;
+    };
+
     //! @class OcclusionFilteredEntityComponent
     //! @brief An example of using IFilterEntityManager that filters occluded player entities out of network replication.
     class OcclusionFilteredEntityComponent final
@@ -36,5 +131,7 @@ namespace MultiplayerSample
 
     private:
         const AZ::Name m_occlusionViewName{ "ExampleFilteredEntityView" };
+        OcclusionBusVisibilityProvider m_visibilityProvider;
+        OcclusionVisibilityCache m_visibilityCache;
     };
 }
@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project. For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+
+#include <Source/Components/PredictionStats.h>
+#include <AzCore/Console/IConsole.h>
+#include <AzCore/Console/ILogger.h>
+#include <AzCore/Interface/Interface.h>
+#include <AzCore/IO/FileIO.h>
+#include <AzCore/IO/GenericStreams.h>
+#include <AzCore/IO/Path/Path.h>
+#include <AzCore/std/limits.h>
+
+namespace MultiplayerSample
+{
+    const char* GetEnumString(CorrectionCause value)
+    {
+        switch (value)
+        {
+        case CorrectionCause::ResetCount:
+            return "ResetCount";
+        case CorrectionCause::VelocityDivergence:
+            return "VelocityDivergence";
+        case CorrectionCause::GroundDivergence:
+            return "GroundDivergence";
+        case CorrectionCause::PositionDivergence:
+            return "PositionDivergence";
+        case CorrectionCause::WeaponDivergence:
+            return "WeaponDivergence";
+        case CorrectionCause::Count:
+            break;
+        }
+        return "Unknown";
+    }
+
+    PredictionStats::PredictionStats()
+    {
+        Reset();
+        AZ::Interface<PredictionStats>::Register(this);
+    }
+
+    PredictionStats::~PredictionStats()
+    {
+        AZ::Interface<PredictionStats>::Unregister(this);
+    }
+
+    void PredictionStats::RecordCorrection(CorrectionCause cause, float positionError)
+    {
+        uint32_t bucket = 0;
+        while ((bucket < PositionErrorBucketBounds.size()) && (positionError > PositionErrorBucketBounds[bucket]))
+        {
+            ++bucket;
+        }
+        ++m_positionErrorHistogram[bucket];
+        m_maxPositionError = AZStd::max(m_maxPositionError, positionError);
+
+        RecordCorrection(cause);
+    }
+
+    void PredictionStats::RecordCorrection(CorrectionCause cause)
+    {
+        ++m_correctionCounts[static_cast<uint32_t>(cause)];
+
+        const AZ::TimeMs currentTimeMs = AZ::GetElapsedTimeMs();
+        if (currentTimeMs - m_windowStartTimeMs >= AZ::TimeMs{ 1000 })
+        {
+            m_lastWindowCorrectionCount = GetLastSecondCorrectionCount();
+            m_windowStartTimeMs = currentTimeMs;
+            m_windowCorrectionCount = 0;
+        }
+        ++m_windowCorrectionCount;
+    }
+
+    void PredictionStats::RecordReplay(uint32_t replayedInputCount)
+    {
+        m_replayedInputCount += replayedInputCount;
+
+        uint32_t bucket = 0;
+        while ((bucket < ReplayCountBucketBounds.size()) && (replayedInputCount > ReplayCountBucketBounds[bucket]))
+        {
+            ++bucket;
+        }
+        ++m_replayCountHistogram[bucket];
+    }
+
+    void PredictionStats::Reset()
+    {
+        m_correctionCounts = {};
+        m_positionErrorHistogram = {};
+        m_replayCountHistogram = {};
+        m_replayedInputCount = 0;
+        m_maxPositionError = 0.0f;
+        m_startTimeMs = AZ::GetElapsedTimeMs();
+        m_windowStartTimeMs = m_startTimeMs;
+        m_windowCorrectionCount = 0;
+        m_lastWindowCorrectionCount = 0;
+    }
+
+    uint32_t PredictionStats::GetLastSecondCorrectionCount() const
+    {
+        // Windows only roll over when a correction is recorded, a window that ended over a second ago was followed by a quiet second
+        const AZ::TimeMs windowAgeMs = AZ::GetElapsedTimeMs() - m_windowStartTimeMs;
+        if (windowAgeMs >= AZ::TimeMs{ 2000 })
+        {
+            return 0;
+        }
+        return (windowAgeMs >= AZ::TimeMs{ 1000 }) ? m_windowCorrectionCount : m_lastWindowCorrectionCount;
+    }
+
+    float PredictionStats::GetElapsedSeconds() const
+    {
+        return AZStd::max(AZ::TimeMsToSeconds(AZ::GetElapsedTimeMs() - m_startTimeMs), 1.0f);
+    }
+
+    void PredictionStats::LogSummary() const
+    {
+        uint64_t correctionCount = 0;
+        for (uint64_t count : m_correctionCounts)
+        {
+            correctionCount += count;
+        }
+
+        AZLOG_INFO("Prediction stats over %.0f seconds: %" PRIu64 " corrections, %.2f per second on average, %u in the last second, max position error %.3f m, %" PRIu64 " inputs replayed",
+            GetElapsedSeconds(), correctionCount, correctionCount / GetElapsedSeconds(), GetLastSecondCorrectionCount(), m_maxPositionError, m_replayedInputCount);
+
+        for (uint32_t cause = 0; cause < m_correctionCounts.size(); ++cause)
+        {
+            AZLOG_INFO("  %s: %" PRIu64, GetEnumString(static_cast<CorrectionCause>(cause)), m_correctionCounts[cause]);
+        }
+
+        for (uint32_t bucket = 0; bucket < PositionErrorBucketCount; ++bucket)
+        {
+            if (bucket < PositionErrorBucketBounds.size())
+            {
+                AZLOG_INFO("  Position error <= %.2f m: %" PRIu64, PositionErrorBucketBounds[bucket], m_positionErrorHistogram[bucket]);
+            }
+            else
+            {
+                AZLOG_INFO("  Position error > %.2f m: %" PRIu64, PositionErrorBucketBounds.back(), m_positionErrorHistogram[bucket]);
+            }
+        }
+
+        for (uint32_t bucket = 0; bucket < ReplayCountBucketCount; ++bucket)
+        {
+            if (bucket < ReplayCountBucketBounds.size())
+            {
+                AZLOG_INFO("  Replays of <= %u inputs: %" PRIu64, ReplayCountBucketBounds[bucket], m_replayCountHistogram[bucket]);
+            }
+            else
+            {
+                AZLOG_INFO("  Replays of > %u inputs: %" PRIu64, ReplayCountBucketBounds.back(), m_replayCountHistogram[bucket]);
+            }
+        }
+    }
+
+    bool PredictionStats::DumpCsv(const AZStd::string& filePath) const
+    {
+        AZStd::string csv = "Metric,Bucket,Value\n";
+        csv += AZStd::string::format("ElapsedSeconds,,%.1f\n", GetElapsedSeconds());
+        csv += AZStd::string::format("LastSecondCorrections,,%u\n", GetLastSecondCorrectionCount());
+        csv += AZStd::string::format("MaxPositionError,,%.4f\n", m_maxPositionError);
+        csv += AZStd::string::format("ReplayedInputs,,%" PRIu64 "\n", m_replayedInputCount);
+        for (uint32_t cause = 0; cause < m_correctionCounts.size(); ++cause)
+        {
+            csv += AZStd::string::format("Corrections,%s,%" PRIu64 "\n", GetEnumString(static_cast<CorrectionCause>(cause)), m_correctionCounts[cause]);
+        }
+        for (uint32_t bucket = 0; bucket < PositionErrorBucketCount; ++bucket)
+        {
+            const float bound = (bucket < PositionErrorBucketBounds.size()) ? PositionErrorBucketBounds[bucket] : AZStd::numeric_limits<float>::max();
+            csv += AZStd::string::format("PositionError,%g,%" PRIu64 "\n", bound, m_positionErrorHistogram[bucket]);
+        }
+        for (uint32_t bucket = 0; bucket < ReplayCountBucketCount; ++bucket)
+        {
+            const uint32_t bound = (bucket < ReplayCountBucketBounds.size()) ? ReplayCountBucketBounds[bucket] : AZStd::numeric_limits<uint32_t>::max();
+            csv += AZStd::string::format("ReplayedInputsPerCorrection,%u,%" PRIu64 "\n", bound, m_replayCountHistogram[bucket]);
+        }
+
+        AZ::IO::FixedMaxPath resolvedPath(filePath);
+        if (AZ::IO::FileIOBase* fileIo = AZ::IO::FileIOBase::GetInstance())
+        {
+            fileIo->ResolvePath(resolvedPath, filePath);
+        }
+
+        constexpr AZ::IO::OpenMode openMode = AZ::IO::OpenMode::ModeWrite | AZ::IO::OpenMode::ModeCreatePath;
+        AZ::IO::SystemFileStream csvStream(resolvedPath.c_str(), openMode);
+        if (!csvStream.IsOpen() || (csvStream.Write(csv.size(), csv.data()) != csv.size()))
+        {
+            AZLOG_WARN("Failed to write prediction stats to %s", resolvedPath.c_str());
+            return false;
+        }
+
+        AZLOG_INFO("Wrote prediction stats to %s", resolvedPath.c_str());
+        return true;
+    }
+
+    PredictionStats* GetPredictionStats()
+    {
+        return AZ::Interface<PredictionStats>::Get();
+    }
+
+    static void bg_PredictionStats([[maybe_unused]] const AZ::ConsoleCommandContainer& arguments)
+    {
+        if (const PredictionStats* predictionStats = GetPredictionStats())
+        {
+            predictionStats->LogSummary();
+        }
+    }
+    AZ_CONSOLEFREEFUNC(bg_PredictionStats, AZ::ConsoleFunctorFlags::Null, "Logs how often and by how much locally predicted players have been corrected");
+
+    static void bg_PredictionStatsReset([[maybe_unused]] const AZ::ConsoleCommandContainer& arguments)
+    {
+        if (PredictionStats* predictionStats = GetPredictionStats())
+        {
+            predictionStats->Reset();
+        }
+    }
+    AZ_CONSOLEFREEFUNC(bg_PredictionStatsReset, AZ::ConsoleFunctorFlags::Null, "Clears the prediction correction counters");
+
+    static void bg_PredictionStatsDumpCsv(const AZ::ConsoleCommandContainer& arguments)
+    {
+        if (const PredictionStats* predictionStats = GetPredictionStats())
+        {
+            predictionStats->DumpCsv(arguments.empty() ? AZStd::string("@user@/PredictionStats.csv") : AZStd::string(arguments.front()));
+        }
+    }
+    AZ_CONSOLEFREEFUNC(bg_PredictionStatsDumpCsv, AZ::ConsoleFunctorFlags::Null, "Writes the prediction correction counters to a csv file, optionally takes the file to write");
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project. For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+
+#pragma once
+
+#include <AzCore/RTTI/RTTI.h>
+#include <AzCore/Time/ITime.h>
+#include <AzCore/std/containers/array.h>
+#include <AzCore/std/string/string.h>
+
+namespace MultiplayerSample
+{
+    //! Reasons a predicted input was found to have diverged from the authoritative simulation.
+    enum class CorrectionCause
+    {
+        ResetCount,         // The player was reset and inputs for the old reset count were discarded
+        VelocityDivergence, // Predicted and corrected velocities differ
+        GroundDivergence,   // Predicted and corrected grounded or jumping states differ
+        PositionDivergence, // Only the predicted and corrected positions or aim differ
+        WeaponDivergence,   // A replayed input activated weapons differently than when it was predicted
+        Count
+    };
+    const char* GetEnumString(CorrectionCause value);
+
+    //! @class PredictionStats
+    //! @brief Counts how often and by how much locally predicted players are corrected, on both clients and servers.
+    //! Fed by the player movement and weapons controllers, reported by the bg_PredictionStats console commands.
+    class PredictionStats
+    {
+    public:
+        AZ_RTTI(PredictionStats, "{8D4F2A61-3C7E-4B95-A0D2-6E19F5B8C374}");
+
+        //! Upper bounds of the position error histogram buckets in meters, the last bucket holds everything larger.
+        static constexpr AZStd::array<float, 6> PositionErrorBucketBounds{ 0.01f, 0.05f, 0.1f, 0.25f, 0.5f, 1.0f };
+        static constexpr uint32_t PositionErrorBucketCount = static_cast<uint32_t>(PositionErrorBucketBounds.size()) + 1;
+
+        //! Upper bounds of the replayed input count histogram buckets, the last bucket holds everything larger.
+        static constexpr AZStd::array<uint32_t, 6> ReplayCountBucketBounds{ 1, 2, 4, 8, 16, 32 };
+        static constexpr uint32_t ReplayCountBucketCount = static_cast<uint32_t>(ReplayCountBucketBounds.size()) + 1;
+
+        PredictionStats();
+        virtual ~PredictionStats();
+
+        //! Records a single correction of the predicted movement state.
+        //! @param cause         the reason the prediction diverged
+        //! @param positionError the distance between the predicted and corrected positions, in meters
+        void RecordCorrection(CorrectionCause cause, float positionError);
+
+        //! Records a single correction that has no position error, such as a weapon divergence or discarded reset inputs.
+        //! These are only counted against their cause and never enter the position error histogram.
+        //! @param cause the reason the prediction diverged
+        void RecordCorrection(CorrectionCause cause);
+
+        //! Records the number of inputs replayed for a single correction.
+        //! @param replayedInputCount the number of inputs replayed
+        void RecordReplay(uint32_t replayedInputCount);
+
+        //! Clears every counter and restarts the rate measurement.
+        void Reset();
+
+        //! Logs a summary of the counters.
+        void LogSummary() const;
+
+        //! Writes the counters to a csv file, one row per counter.
+        //! @param filePath the file to write
+        //! @return false if the file could not be written
+        bool DumpCsv(const AZStd::string& filePath) const;
+
+    private:
+        float GetElapsedSeconds() const;
+        uint32_t GetLastSecondCorrectionCount() const;
+
+        AZStd::array<uint64_t, static_cast<uint32_t>(CorrectionCause::Count)> m_correctionCounts = {};
+        AZStd::array<uint64_t, PositionErrorBucketCount> m_positionErrorHistogram = {};
+        AZStd::array<uint64_t, ReplayCountBucketCount> m_replayCountHistogram = {};
+        uint64_t m_replayedInputCount = 0;
+        float m_maxPositionError = 0.0f;
+        AZ::TimeMs m_startTimeMs = AZ::TimeMs{ 0 };
+
+        // Corrections in the current and last full second, for a live rate alongside the average
+        AZ::TimeMs m_windowStartTimeMs = AZ::TimeMs{ 0 };
+        uint32_t m_windowCorrectionCount = 0;
+        uint32_t m_lastWindowCorrectionCount = 0;
+    };
+
+    //! Returns the prediction stats if they are active.
+    //! @return the prediction stats, or nullptr if none are active
+    PredictionStats* GetPredictionStats();
+}
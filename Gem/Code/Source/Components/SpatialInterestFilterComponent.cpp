@@ -0,0 +1,458 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+
+#include <AzCore/Console/IConsole.h>
+#include <AzCore/Console/ILogger.h>
+#include <AzCore/Math/Random.h>
+#include <AzCore/Serialization/EditContext.h>
+#include <AzCore/std/algorithm.h>
+#include <AzCore/std/chrono/chrono.h>
+#include <AzCore/std/math.h>
+#include <Components/SpatialInterestFilterComponent.h>
+#include <Source/MultiplayerSampleTypes.h>
+#include <Multiplayer/IMultiplayer.h>
+#include <Multiplayer/Components/NetBindComponent.h>
+#include <Multiplayer/NetworkTime/INetworkTime.h>
+
+AZ_CVAR(bool, mps_EnableSpatialInterestFiltering, true, nullptr, AZ::ConsoleFunctorFlags::Null, "If true, enables filtering entities by their distance to each connection's controlled entity");
+
+namespace MultiplayerSample
+{
+    void SpatialInterestGrid::Configure(float cellSize, float radius, float hysteresis)
+    {
+        m_cellSize = AZStd::max(cellSize, 0.01f);
+        m_radius = AZStd::max(radius, 0.0f);
+        m_hysteresis = AZStd::max(hysteresis, 0.0f);
+        m_gatherCells = aznumeric_cast<int32_t>(AZStd::ceil((m_radius + m_hysteresis) / m_cellSize));
+
+        m_cells.clear();
+        for (auto& [netEntityId, entry] : m_entities)
+        {
+            entry.m_cellKey = GetCellKey(entry.m_position);
+            m_cells[entry.m_cellKey].push_back(netEntityId);
+        }
+
+        // Relevant sets are kept for hysteresis, but every connection gathers again with the new distances
+        for (auto& [connectionId, connection] : m_connections)
+        {
+            connection.m_frameId = Multiplayer::InvalidHostFrameId;
+        }
+    }
+
+    void SpatialInterestGrid::UpdateEntity(Multiplayer::NetEntityId netEntityId, const AZ::Vector3& position)
+    {
+        const uint64_t cellKey = GetCellKey(position);
+        auto [iter, inserted] = m_entities.try_emplace(netEntityId);
+        EntityEntry& entry = iter->second;
+        if (inserted)
+        {
+            m_cells[cellKey].push_back(netEntityId);
+        }
+        else if (entry.m_cellKey != cellKey)
+        {
+            RemoveFromCell(entry.m_cellKey, netEntityId);
+            m_cells[cellKey].push_back(netEntityId);
+        }
+        entry.m_position = position;
+        entry.m_cellKey = cellKey;
+    }
+
+    void SpatialInterestGrid::RemoveEntity(Multiplayer::NetEntityId netEntityId)
+    {
+        if (auto iter = m_entities.find(netEntityId); iter != m_entities.end())
+        {
+            RemoveFromCell(iter->second.m_cellKey, netEntityId);
+            m_entities.erase(iter);
+        }
+
+        // A connection's controlled entity is removed when the connection goes away, so its relevant set goes with it
+        for (auto iter = m_connections.begin(); iter != m_connections.end();)
+        {
+            if (iter->second.m_viewerNetEntityId == netEntityId)
+            {
+                iter = m_connections.erase(iter);
+            }
+            else
+            {
+                iter->second.m_relevantEntities.erase(netEntityId);
+                ++iter;
+            }
+        }
+    }
+
+    bool SpatialInterestGrid::IsRelevant(AzNetworking::ConnectionId connectionId, Multiplayer::NetEntityId viewerNetEntityId, Multiplayer::NetEntityId netEntityId, Multiplayer::HostFrameId frameId)
+    {
+        const auto viewerIter = m_entities.find(viewerNetEntityId);
+        if ((viewerIter == m_entities.end()) || (m_entities.find(netEntityId) == m_entities.end()))
+        {
+            return true;
+        }
+
+        ConnectionInterest& connection = m_connections[connectionId];
+        if (connection.m_viewerNetEntityId != viewerNetEntityId)
+        {
+            // The connection controls a different entity, nothing it could see before carries over
+            connection.m_viewerNetEntityId = viewerNetEntityId;
+            connection.m_relevantEntities.clear();
+            connection.m_frameId = Multiplayer::InvalidHostFrameId;
+        }
+
+        if ((connection.m_frameId != frameId) || (frameId == Multiplayer::InvalidHostFrameId))
+        {
+            connection.m_frameId = frameId;
+            GatherRelevantEntities(connection, viewerIter->second.m_position);
+        }
+
+        return connection.m_relevantEntities.find(netEntityId) != connection.m_relevantEntities.end();
+    }
+
+    bool SpatialInterestGrid::ContainsEntity(Multiplayer::NetEntityId netEntityId) const
+    {
+        return m_entities.find(netEntityId) != m_entities.end();
+    }
+
+    uint32_t SpatialInterestGrid::GetConnectionCount() const
+    {
+        return aznumeric_cast<uint32_t>(m_connections.size());
+    }
+
+    void SpatialInterestGrid::Clear()
+    {
+        m_entities.clear();
+        m_cells.clear();
+        m_connections.clear();
+        m_previousRelevantEntities.clear();
+    }
+
+    int32_t SpatialInterestGrid::GetCellCoordinate(float position) const
+    {
+        return aznumeric_cast<int32_t>(AZStd::floor(position / m_cellSize));
+    }
+
+    uint64_t SpatialInterestGrid::GetCellKey(const AZ::Vector3& position) const
+    {
+        // Cells are horizontal columns, the exact distance test handles height
+        return MakeCellKey(GetCellCoordinate(position.GetX()), GetCellCoordinate(position.GetY()));
+    }
+
+    uint64_t SpatialInterestGrid::MakeCellKey(int32_t cellX, int32_t cellY)
+    {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(cellX)) << 32) | static_cast<uint64_t>(static_cast<uint32_t>(cellY));
+    }
+
+    void SpatialInterestGrid::RemoveFromCell(uint64_t cellKey, Multiplayer::NetEntityId netEntityId)
+    {
+        auto cellIter = m_cells.find(cellKey);
+        if (cellIter == m_cells.end())
+        {
+            return;
+        }
+
+        AZStd::vector<Multiplayer::NetEntityId>& cell = cellIter->second;
+        if (auto iter = AZStd::find(cell.begin(), cell.end(), netEntityId); iter != cell.end())
+        {
+            *iter = cell.back();
+            cell.pop_back();
+        }
+
+        if (cell.empty())
+        {
+            m_cells.erase(cellIter);
+        }
+    }
+
+    void SpatialInterestGrid::GatherRelevantEntities(ConnectionInterest& connection, const AZ::Vector3& viewerPosition)
+    {
+        AZStd::swap(connection.m_relevantEntities, m_previousRelevantEntities);
+        connection.m_relevantEntities.clear();
+
+        const float enterDistanceSq = m_radius * m_radius;
+        const float exitDistanceSq = (m_radius + m_hysteresis) * (m_radius + m_hysteresis);
+        const int32_t viewerCellX = GetCellCoordinate(viewerPosition.GetX());
+        const int32_t viewerCellY = GetCellCoordinate(viewerPosition.GetY());
+        for (int32_t cellX = viewerCellX - m_gatherCells; cellX <= viewerCellX + m_gatherCells; ++cellX)
+        {
+            for (int32_t cellY = viewerCellY - m_gatherCells; cellY <= viewerCellY + m_gatherCells; ++cellY)
+            {
+                const auto cellIter = m_cells.find(MakeCellKey(cellX, cellY));
+                if (cellIter == m_cells.end())
+                {
+                    continue;
+                }
+
+                for (const Multiplayer::NetEntityId netEntityId : cellIter->second)
+                {
+                    const float distanceSq = m_entities[netEntityId].m_position.GetDistanceSq(viewerPosition);
+                    const bool wasRelevant = m_previousRelevantEntities.find(netEntityId) != m_previousRelevantEntities.end();
+                    if (distanceSq <= (wasRelevant ? exitDistanceSq : enterDistanceSq))
+                    {
+                        connection.m_relevantEntities.insert(netEntityId);
+                    }
+                }
+            }
+        }
+
+        m_previousRelevantEntities.clear();
+    }
+
+    void SpatialInterestFilterComponent::Reflect(AZ::ReflectContext* context)
+    {
+        AZ::SerializeContext* serializeContext = azrtti_cast<AZ::SerializeContext*>(context);
+        if (serializeContext)
+        {
+            serializeContext->Class<SpatialInterestFilterComponent, AZ::Component>()
+                ->Field("Enabled", &SpatialInterestFilterComponent::m_enabled)
+                ->Field("Players Only", &SpatialInterestFilterComponent::m_playersOnly)
+                ->Field("Cell Size", &SpatialInterestFilterComponent::m_cellSize)
+                ->Field("Radius", &SpatialInterestFilterComponent::m_radius)
+                ->Field("Hysteresis", &SpatialInterestFilterComponent::m_hysteresis)
+                ->Version(1);
+
+            if (AZ::EditContext* editContext = serializeContext->GetEditContext())
+            {
+                using namespace AZ::Edit;
+                editContext->Class<SpatialInterestFilterComponent>("SpatialInterestFilterComponent", "Filters entities outside a radius of each connection's controlled entity out of network replication")
+                    ->ClassElement(ClassElements::EditorData, "")
+                    ->Attribute(AZ::Edit::Attributes::Category, "MultiplayerSample")
+                    ->Attribute(AZ::Edit::Attributes::AppearsInAddComponentMenu, AZ_CRC_CE("Level"))
+                    ->DataElement(nullptr, &SpatialInterestFilterComponent::m_enabled, "Enabled", "enabled if checked")
+                    ->DataElement(nullptr, &SpatialInterestFilterComponent::m_playersOnly, "Players Only",
+                        "if checked, only entities owned by a connection are filtered, other networked entities are always replicated")
+                    ->DataElement(nullptr, &SpatialInterestFilterComponent::m_cellSize, "Cell Size",
+                        "size in meters of a grid cell, cells only narrow down which entities have their distance checked")
+                    ->DataElement(nullptr, &SpatialInterestFilterComponent::m_radius, "Radius",
+                        "entities within this distance in meters of a connection's controlled entity are replicated to it")
+                    ->DataElement(nullptr, &SpatialInterestFilterComponent::m_hysteresis, "Hysteresis",
+                        "extra distance in meters a replicated entity can move away before it stops being replicated")
+                ;
+            }
+        }
+    }
+
+    void SpatialInterestFilterComponent::Activate()
+    {
+        m_grid.Configure(m_cellSize, m_radius, m_hysteresis);
+        AZ::Interface<IFilterEntityManager>::Register(this);
+    }
+
+    void SpatialInterestFilterComponent::Deactivate()
+    {
+        AZ::Interface<IFilterEntityManager>::Unregister(this);
+        AZ::TransformNotificationBus::MultiHandler::BusDisconnect();
+        AZ::EntityBus::MultiHandler::BusDisconnect();
+        m_trackedEntities.clear();
+        m_grid.Clear();
+    }
+
+    bool SpatialInterestFilterComponent::IsEntityFiltered(
+        AZ::Entity* entity,
+        Multiplayer::ConstNetworkEntityHandle controllerEntity,
+        AzNetworking::ConnectionId connectionId)
+    {
+        if (!m_enabled || !mps_EnableSpatialInterestFiltering)
+        {
+            return false;
+        }
+
+        const AZ::Entity* controlledEntity = controllerEntity.GetEntity();
+        if (controlledEntity == nullptr)
+        {
+            return false;
+        }
+
+        if (m_playersOnly)
+        {
+            const auto entityNetBindComponent = entity->FindComponent<Multiplayer::NetBindComponent>();
+            if ((entityNetBindComponent == nullptr) || (entityNetBindComponent->GetOwningConnectionId() == AzNetworking::InvalidConnectionId))
+            {
+                return false;
+            }
+        }
+
+        // Positions are kept up to date by transform notifications, so after a connection's first query of a frame this is a few hash lookups
+        const Multiplayer::NetEntityId viewerNetEntityId = TrackEntity(*controlledEntity);
+        const Multiplayer::NetEntityId netEntityId = TrackEntity(*entity);
+        return !m_grid.IsRelevant(connectionId, viewerNetEntityId, netEntityId, Multiplayer::GetNetworkTime()->GetHostFrameId());
+    }
+
+    void SpatialInterestFilterComponent::OnTransformChanged([[maybe_unused]] const AZ::Transform& local, const AZ::Transform& world)
+    {
+        const AZ::EntityId* entityId = AZ::TransformNotificationBus::GetCurrentBusId();
+        if (entityId == nullptr)
+        {
+            return;
+        }
+
+        if (auto iter = m_trackedEntities.find(*entityId); iter != m_trackedEntities.end())
+        {
+            m_grid.UpdateEntity(iter->second, world.GetTranslation());
+        }
+    }
+
+    void SpatialInterestFilterComponent::OnEntityDeactivated(const AZ::EntityId& entityId)
+    {
+        if (auto iter = m_trackedEntities.find(entityId); iter != m_trackedEntities.end())
+        {
+            m_grid.RemoveEntity(iter->second);
+            m_trackedEntities.erase(iter);
+        }
+        AZ::TransformNotificationBus::MultiHandler::BusDisconnect(entityId);
+        AZ::EntityBus::MultiHandler::BusDisconnect(entityId);
+    }
+
+    Multiplayer::NetEntityId SpatialInterestFilterComponent::TrackEntity(const AZ::Entity& entity)
+    {
+        if (auto iter = m_trackedEntities.find(entity.GetId()); iter != m_trackedEntities.end())
+        {
+            return iter->second;
+        }
+
+        const auto netBindComponent = entity.FindComponent<Multiplayer::NetBindComponent>();
+        if (netBindComponent == nullptr)
+        {
+            return Multiplayer::InvalidNetEntityId;
+        }
+
+        const Multiplayer::NetEntityId netEntityId = netBindComponent->GetNetEntityId();
+        m_trackedEntities.emplace(entity.GetId(), netEntityId);
+        m_grid.UpdateEntity(netEntityId, entity.GetTransform()->GetWorldTranslation());
+        AZ::TransformNotificationBus::MultiHandler::BusConnect(entity.GetId());
+        AZ::EntityBus::MultiHandler::BusConnect(entity.GetId());
+        return netEntityId;
+    }
+
+#if MPS_DIAGNOSTICS
+    static void sv_SpatialInterestCheck([[maybe_unused]] const AZ::ConsoleCommandContainer& arguments)
+    {
+        constexpr float CellSize = 10.0f;
+        constexpr float Radius = 50.0f;
+        constexpr float Hysteresis = 20.0f;
+        const AzNetworking::ConnectionId connectionId{ 1 };
+        const Multiplayer::NetEntityId viewer{ 1 };
+        const Multiplayer::NetEntityId target{ 2 };
+
+        SpatialInterestGrid grid;
+        grid.Configure(CellSize, Radius, Hysteresis);
+        grid.UpdateEntity(viewer, AZ::Vector3(5.0f, 5.0f, 0.0f));
+
+        // Each step moves the target by an offset from the viewer and states whether it should be relevant afterwards
+        struct Step
+        {
+            float m_x;
+            float m_y;
+            bool m_expectRelevant;
+            const char* m_description;
+        };
+        const Step steps[] =
+        {
+            { 100.0f,  0.0f, false, "starts outside the exit distance" },
+            {  60.0f,  0.0f, false, "approaches within the exit distance but outside the enter distance" },
+            {  50.0f,  0.0f, true,  "enters the enter distance" },
+            {  60.0f,  0.0f, true,  "moves back out within the hysteresis band" },
+            {  70.0f,  0.0f, true,  "reaches the edge of the hysteresis band" },
+            {  80.0f,  0.0f, false, "leaves the hysteresis band" },
+            {  60.0f,  0.0f, false, "returns within the hysteresis band without re-entering" },
+            {  50.0f,  0.0f, true,  "re-enters the enter distance" },
+            {  90.0f,  0.0f, false, "leaves again" },
+            {  40.0f, 40.0f, false, "approaches diagonally, within the enter distance on each axis but not in distance" },
+            {  30.0f, 30.0f, true,  "enters the enter distance diagonally" },
+            {  45.0f, 45.0f, true,  "moves back out diagonally within the hysteresis band" },
+            {  52.0f, 52.0f, false, "leaves the hysteresis band diagonally, within the exit distance on each axis" },
+        };
+
+        uint32_t failures = 0;
+        uint32_t frame = 1;
+        for (const Step& step : steps)
+        {
+            grid.UpdateEntity(target, AZ::Vector3(5.0f + step.m_x, 5.0f + step.m_y, 0.0f));
+            const bool isRelevant = grid.IsRelevant(connectionId, viewer, target, Multiplayer::HostFrameId{ frame++ });
+            if (isRelevant != step.m_expectRelevant)
+            {
+                AZLOG_WARN("Spatial interest check failed: target at offset %.0f, %.0f %s, expected %s", step.m_x, step.m_y, step.m_description,
+                    step.m_expectRelevant ? "relevant" : "filtered");
+                ++failures;
+            }
+        }
+
+        // The viewer is always relevant to itself, entities outside the grid are never filtered, and removed entities leave every relevant set
+        failures += grid.IsRelevant(connectionId, viewer, viewer, Multiplayer::HostFrameId{ frame++ }) ? 0 : 1;
+        failures += grid.IsRelevant(connectionId, viewer, Multiplayer::NetEntityId{ 3 }, Multiplayer::HostFrameId{ frame++ }) ? 0 : 1;
+        grid.UpdateEntity(target, AZ::Vector3(45.0f, 5.0f, 0.0f));
+        failures += grid.IsRelevant(connectionId, viewer, target, Multiplayer::HostFrameId{ frame++ }) ? 0 : 1;
+        grid.RemoveEntity(target);
+        grid.UpdateEntity(target, AZ::Vector3(65.0f, 5.0f, 0.0f));
+        failures += grid.IsRelevant(connectionId, viewer, target, Multiplayer::HostFrameId{ frame++ }) ? 1 : 0;
+
+        // Removing a connection's controlled entity drops the connection's relevant set
+        grid.RemoveEntity(viewer);
+        failures += (grid.GetConnectionCount() == 0) ? 0 : 1;
+
+        AZLOG_INFO("Spatial interest check: %u failures", failures);
+    }
+    AZ_CONSOLEFREEFUNC(sv_SpatialInterestCheck, AZ::ConsoleFunctorFlags::Null, "Checks that the spatial interest grid applies its enter radius and exit hysteresis as entities move around a connection's controlled entity, along an axis and diagonally");
+
+    static void sv_SpatialInterestBenchmark(const AZ::ConsoleCommandContainer& arguments)
+    {
+        const uint32_t entityCount = (arguments.size() > 0) ? aznumeric_cast<uint32_t>(AZStd::stoi(AZStd::string(arguments[0]))) : 1000;
+        const uint32_t connectionCount = (arguments.size() > 1) ? aznumeric_cast<uint32_t>(AZStd::stoi(AZStd::string(arguments[1]))) : 64;
+        const uint32_t updateCount = (arguments.size() > 2) ? aznumeric_cast<uint32_t>(AZStd::stoi(AZStd::string(arguments[2]))) : 10;
+        constexpr float ArenaSize = 500.0f;
+        constexpr float MoveDistance = 2.0f;
+
+        if ((entityCount == 0) || (connectionCount > entityCount))
+        {
+            AZLOG_WARN("sv_SpatialInterestBenchmark needs at least as many entities as connections");
+            return;
+        }
+
+        // The first connectionCount entities are the connections' controlled entities
+        AZ::SimpleLcgRandom random(1234);
+        AZStd::vector<AZ::Vector3> positions(entityCount);
+        for (AZ::Vector3& position : positions)
+        {
+            position.Set(random.GetRandomFloat() * ArenaSize, random.GetRandomFloat() * ArenaSize, 0.0f);
+        }
+
+        SpatialInterestGrid grid;
+        grid.Configure(16.0f, 64.0f, 16.0f);
+
+        float moveUs = 0.0f;
+        float queryUs = 0.0f;
+        uint64_t relevantCount = 0;
+        for (uint32_t update = 0; update < updateCount; ++update)
+        {
+            auto start = AZStd::chrono::steady_clock::now();
+            for (uint32_t entity = 0; entity < entityCount; ++entity)
+            {
+                AZ::Vector3& position = positions[entity];
+                position += AZ::Vector3((random.GetRandomFloat() * 2.0f - 1.0f) * MoveDistance, (random.GetRandomFloat() * 2.0f - 1.0f) * MoveDistance, 0.0f);
+                grid.UpdateEntity(Multiplayer::NetEntityId{ entity }, position);
+            }
+            moveUs += aznumeric_cast<float>(AZStd::chrono::duration_cast<AZStd::chrono::microseconds>(AZStd::chrono::steady_clock::now() - start).count());
+
+            start = AZStd::chrono::steady_clock::now();
+            for (uint32_t connection = 0; connection < connectionCount; ++connection)
+            {
+                const AzNetworking::ConnectionId connectionId{ connection + 1 };
+                for (uint32_t entity = 0; entity < entityCount; ++entity)
+                {
+                    relevantCount += grid.IsRelevant(connectionId, Multiplayer::NetEntityId{ connection }, Multiplayer::NetEntityId{ entity }, Multiplayer::HostFrameId{ update + 1 }) ? 1 : 0;
+                }
+            }
+            queryUs += aznumeric_cast<float>(AZStd::chrono::duration_cast<AZStd::chrono::microseconds>(AZStd::chrono::steady_clock::now() - start).count());
+        }
+
+        const float queryCount = aznumeric_cast<float>(AZStd::max(entityCount * connectionCount * updateCount, 1u));
+        AZLOG_INFO("Spatial interest benchmark, %u entities x %u connections over %u updates: %.1f%% relevant, %.1f us per update moving entities, "
+            "%.1f us per update filtering (%.1f ns per query)",
+            entityCount, connectionCount, updateCount, 100.0f * aznumeric_cast<float>(relevantCount) / queryCount,
+            moveUs / aznumeric_cast<float>(AZStd::max(updateCount, 1u)), queryUs / aznumeric_cast<float>(AZStd::max(updateCount, 1u)),
+            1000.0f * queryUs / queryCount);
+    }
+    AZ_CONSOLEFREEFUNC(sv_SpatialInterestBenchmark, AZ::ConsoleFunctorFlags::Null, "Times spatial interest grid updates and relevance queries for synthetic moving entities, optionally takes entity count, connection count and update count");
+#endif
+}
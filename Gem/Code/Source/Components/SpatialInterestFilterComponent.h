@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+
+#pragma once
+
+#include <AzCore/Component/Component.h>
+#include <AzCore/Component/EntityBus.h>
+#include <AzCore/Component/TransformBus.h>
+#include <AzCore/std/containers/unordered_map.h>
+#include <AzCore/std/containers/unordered_set.h>
+#include <AzCore/std/containers/vector.h>
+#include <Multiplayer/MultiplayerTypes.h>
+#include <Multiplayer/NetworkEntity/IFilterEntityManager.h>
+
+namespace MultiplayerSample
+{
+    //! @class SpatialInterestGrid
+    //! @brief Uniform grid of networked entity positions answering whether an entity is relevant to a connection.
+    //! Entities are bucketed by the horizontal grid cell containing them. Once per frame, each connection gathers the entities in the
+    //! cells around its controlled entity and keeps those within the enter radius, or within the enter radius plus the hysteresis
+    //! distance if they were already relevant. Cells are only the broad phase, relevance is decided by the real distance.
+    class SpatialInterestGrid
+    {
+    public:
+        //! Configures the grid, entities already in the grid are moved to their new cells.
+        //! @param cellSize   the size of a grid cell in meters
+        //! @param radius     the distance in meters within which entities become relevant
+        //! @param hysteresis the extra distance in meters relevant entities can move away before they stop being relevant
+        void Configure(float cellSize, float radius, float hysteresis);
+
+        //! Moves an entity to the cell containing a position, adding it to the grid if necessary.
+        //! @param netEntityId the entity to update
+        //! @param position    the entity's current position
+        void UpdateEntity(Multiplayer::NetEntityId netEntityId, const AZ::Vector3& position);
+
+        //! Removes an entity from the grid and from every connection's relevant set, connections it was the controlled entity of are dropped.
+        //! @param netEntityId the entity to remove
+        void RemoveEntity(Multiplayer::NetEntityId netEntityId);
+
+        //! Returns whether an entity is relevant to a connection, gathering the connection's relevant set on its first query of a frame.
+        //! @param connectionId      the connection being updated
+        //! @param viewerNetEntityId the connection's controlled entity
+        //! @param netEntityId       the entity being considered
+        //! @param frameId           the host frame of the query, relevant sets are gathered once per frame
+        //! @return true if the entity is relevant, entities not in the grid are always relevant
+        bool IsRelevant(AzNetworking::ConnectionId connectionId, Multiplayer::NetEntityId viewerNetEntityId, Multiplayer::NetEntityId netEntityId, Multiplayer::HostFrameId frameId);
+
+        //! Returns whether an entity is in the grid.
+        bool ContainsEntity(Multiplayer::NetEntityId netEntityId) const;
+
+        //! Returns the number of connections with a relevant set.
+        uint32_t GetConnectionCount() const;
+
+        //! Drops every entity and connection.
+        void Clear();
+
+    private:
+        struct EntityEntry
+        {
+            AZ::Vector3 m_position = AZ::Vector3::CreateZero();
+            uint64_t m_cellKey = 0;
+        };
+
+        struct ConnectionInterest
+        {
+            Multiplayer::NetEntityId m_viewerNetEntityId = Multiplayer::InvalidNetEntityId;
+            Multiplayer::HostFrameId m_frameId = Multiplayer::InvalidHostFrameId;
+            AZStd::unordered_set<Multiplayer::NetEntityId> m_relevantEntities;
+        };
+
+        int32_t GetCellCoordinate(float position) const;
+        uint64_t GetCellKey(const AZ::Vector3& position) const;
+        static uint64_t MakeCellKey(int32_t cellX, int32_t cellY);
+        void RemoveFromCell(uint64_t cellKey, Multiplayer::NetEntityId netEntityId);
+        void GatherRelevantEntities(ConnectionInterest& connection, const AZ::Vector3& viewerPosition);
+
+        AZStd::unordered_map<Multiplayer::NetEntityId, EntityEntry> m_entities;
+        AZStd::unordered_map<uint64_t, AZStd::vector<Multiplayer::NetEntityId>> m_cells;
+        AZStd::unordered_map<AzNetworking::ConnectionId, ConnectionInterest> m_connections;
+        AZStd::unordered_set<Multiplayer::NetEntityId> m_previousRelevantEntities; // Reused while a connection's relevant set is gathered
+        float m_cellSize = 16.0f;
+        float m_radius = 64.0f;
+        float m_hysteresis = 16.0f;
+        int32_t m_gatherCells = 5; // Cells around the controlled entity's cell that can hold entities within the exit distance
+    };
+
+    //! @class SpatialInterestFilterComponent
+    //! @brief An example of using IFilterEntityManager that filters entities outside a radius of each connection's controlled entity.
+    class SpatialInterestFilterComponent final
+        : public AZ::Component
+        , public Multiplayer::IFilterEntityManager
+        , private AZ::TransformNotificationBus::MultiHandler
+        , private AZ::EntityBus::MultiHandler
+    {
+    public:
+        AZ_COMPONENT(MultiplayerSample::SpatialInterestFilterComponent, "{B6E15C38-2F4D-4A97-9D0E-73A1C5F8E2B9}");
+
+        static void Reflect(AZ::ReflectContext* context);
+
+        //! AZ::Component overrides.
+        //! @{
+        void Activate() override;
+        void Deactivate() override;
+        //! }@
+
+        //! IFilterEntityManager overrides.
+        //! @{
+        bool IsEntityFiltered(AZ::Entity* entity, Multiplayer::ConstNetworkEntityHandle controllerEntity, AzNetworking::ConnectionId connectionId) override;
+        //! }@
+
+    private:
+        //! AZ::TransformNotificationBus overrides.
+        void OnTransformChanged(const AZ::Transform& local, const AZ::Transform& world) override;
+
+        //! AZ::EntityBus overrides.
+        void OnEntityDeactivated(const AZ::EntityId& entityId) override;
+
+        //! Starts tracking an entity's position in the grid if it isn't already tracked.
+        //! @return the entity's net entity id, or InvalidNetEntityId if the entity isn't networked
+        Multiplayer::NetEntityId TrackEntity(const AZ::Entity& entity);
+
+        SpatialInterestGrid m_grid;
+        AZStd::unordered_map<AZ::EntityId, Multiplayer::NetEntityId> m_trackedEntities;
+
+        bool m_enabled = true;
+        bool m_playersOnly = true;
+        float m_cellSize = 16.0f;
+        float m_radius = 64.0f;
+        float m_hysteresis = 16.0f;
+    };
+}
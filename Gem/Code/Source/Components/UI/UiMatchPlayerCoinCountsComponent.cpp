@@ -16,6 +16,7 @@
 #include <LyShine/Bus/UiTextBus.h>
 #include <Multiplayer/Components/NetBindComponent.h>
 
+#include <Source/Components/InputActionMap.h>
 #include <Source/Components/UI/UiMatchPlayerCoinCountsComponent.h>
 
 namespace MultiplayerSample
@@ -24,6 +25,20 @@ namespace MultiplayerSample
     const StartingPointInput::InputEventNotificationId ShowPlayerCoinCountsEventId("show_player_coin_counts");
 #endif
 
+    enum class CoinCountsInputAction : uint8_t
+    {
+        ShowPlayerCoinCounts
+    };
+
+    static const InputActionMap<CoinCountsInputAction>& GetCoinCountsInputActions()
+    {
+        static const InputActionMap<CoinCountsInputAction> coinCountsInputActions
+        {
+            { ShowPlayerCoinCountsEventId, CoinCountsInputAction::ShowPlayerCoinCounts },
+        };
+        return coinCountsInputActions;
+    }
+
     void UiMatchPlayerCoinCountsComponent::Activate()
     {
         m_waitForActiveNetworkMatchComponent.Enqueue(AZ::TimeMs{ 1000 }, true);
@@ -116,14 +131,9 @@ namespace MultiplayerSample
 
     void UiMatchPlayerCoinCountsComponent::OnPressed([[maybe_unused]] float value)
     {
-        const StartingPointInput::InputEventNotificationId* inputId = StartingPointInput::InputEventNotificationBus::GetCurrentBusId();
-
-        if (inputId == nullptr)
-        {
-            return;
-        }
-
-        if (*inputId == ShowPlayerCoinCountsEventId)
+        CoinCountsInputAction action;
+        if (GetCoinCountsInputActions().TryGetAction(StartingPointInput::InputEventNotificationBus::GetCurrentBusId(), action)
+            && (action == CoinCountsInputAction::ShowPlayerCoinCounts))
         {
             EnableUI(true);
         }
@@ -131,14 +141,9 @@ namespace MultiplayerSample
 
     void UiMatchPlayerCoinCountsComponent::OnReleased([[maybe_unused]] float value)
     {
-        const StartingPointInput::InputEventNotificationId* inputId = StartingPointInput::InputEventNotificationBus::GetCurrentBusId();
-
-        if (inputId == nullptr)
-        {
-            return;
-        }
-
-        if (*inputId == ShowPlayerCoinCountsEventId)
+        CoinCountsInputAction action;
+        if (GetCoinCountsInputActions().TryGetAction(StartingPointInput::InputEventNotificationBus::GetCurrentBusId(), action)
+            && (action == CoinCountsInputAction::ShowPlayerCoinCounts))
         {
             EnableUI(false);
         }
@@ -11,6 +11,7 @@
 #include <Components/ExampleFilteredEntityComponent.h>
 #include <Components/OcclusionFilteredEntityComponent.h>
 #include <Components/PerfTest/NetworkPrefabSpawnerComponent.h>
+#include <Components/SpatialInterestFilterComponent.h>
 #include <Components/UI/UiCoinCountComponent.h>
 #include <Components/UI/UiGameOverComponent.h>
 #include <Components/UI/UiPlayerArmorComponent.h>
@@ -46,6 +47,7 @@ namespace MultiplayerSample
                 AttachPlayerWeaponComponent::CreateDescriptor(),
                 ExampleFilteredEntityComponent::CreateDescriptor(),
                 OcclusionFilteredEntityComponent::CreateDescriptor(),
+                SpatialInterestFilterComponent::CreateDescriptor(),
                 NetworkPrefabSpawnerComponent::CreateDescriptor(),
                 UiCoinCountComponent::CreateDescriptor(),
                 BackgroundMusicComponent::CreateDescriptor(),
@@ -18,6 +18,17 @@
 #include <Source/Components/NetworkAiComponent.h>
 #include <Source/Effects/GameEffect.h>
 #include <Source/UserSettings/MultiplayerSampleUserSettings.h>
+#include <Source/Components/BoneIndexCache.h>
+#include <Source/Components/BotMovementBatch.h>
+#include <Source/Components/PredictionStats.h>
+#include <Source/Weapons/ProjectileStore.h>
+#include <Source/Weapons/SceneQueryHitBuffer.h>
+#include <Source/Weapons/SceneQueryShapeCache.h>
+#include <Source/Weapons/SimulatedBodyNetData.h>
+#include <Source/Weapons/SurfaceTypeRegistry.h>
+#include <Source/Weapons/WeaponDefinitionLibrary.h>
+#include <Source/Weapons/WeaponFireRecorder.h>
+#include <Source/Weapons/WeaponQueryBatch.h>
 #include <Multiplayer/Components/NetBindComponent.h>
 
 #include <AzFramework/Scene/Scene.h>
@@ -27,6 +38,10 @@ namespace MultiplayerSample
 {
     using namespace AzNetworking;
 
+    MultiplayerSampleSystemComponent::MultiplayerSampleSystemComponent() = default;
+
+    MultiplayerSampleSystemComponent::~MultiplayerSampleSystemComponent() = default;
+
     void MultiplayerSampleSystemComponent::Reflect(AZ::ReflectContext* context)
     {
         ReflectWeaponEnums(context);
@@ -36,6 +51,8 @@ namespace MultiplayerSample
         HitEvent::Reflect(context);
         WeaponParams::Reflect(context);
         GameEffect::Reflect(context);
+        RecordedWeaponShot::Reflect(context);
+        WeaponFireRecording::Reflect(context);
 
         GemSpawnable::Reflect(context);
         GemWeightChance::Reflect(context);
@@ -108,10 +125,69 @@ namespace MultiplayerSample
         // Tell the user settings that this is the correct point in the boot process to apply the MSAA setting.
         MultiplayerSampleUserSettingsRequestBus::Broadcast(
             &MultiplayerSampleUserSettingsRequestBus::Events::ApplyMsaaSetting);
+
+        if (Multiplayer::IMultiplayer* multiplayer = AZ::Interface<Multiplayer::IMultiplayer>::Get())
+        {
+            multiplayer->AddSessionInitHandler(m_sessionInitHandler);
+        }
     }
 
     void MultiplayerSampleSystemComponent::Deactivate()
     {
+        m_sessionInitHandler.Disconnect();
+
+        m_botMovementBatch.reset();
+        m_projectileStore.reset();
+        m_weaponFireRecorder.reset();
+        m_weaponQueryBatch.reset();
+        m_weaponDefinitionLibrary.reset();
+        m_simulatedBodyNetData.reset();
+        m_surfaceTypeRegistry.reset();
+        m_sceneQueryHitBuffer.reset();
+        m_sceneQueryShapeCache.reset();
+        m_predictionStats.reset();
+        m_boneIndexCache.reset();
+    }
+
+    void MultiplayerSampleSystemComponent::CreateEndpointServices(Multiplayer::MultiplayerAgentType agentType)
+    {
+        // Services outlive the session that created them, entities may still reference them while the session tears down.
+        // A later session in the same process (editor play sessions) only adds what its endpoint type is missing.
+        if (agentType == Multiplayer::MultiplayerAgentType::Uninitialized)
+        {
+            return;
+        }
+
+        // Every simulating endpoint runs weapons and animation, clients predict their own shots and draw remote projectiles
+        if (m_boneIndexCache == nullptr)
+        {
+            m_boneIndexCache = AZStd::make_unique<BoneIndexCache>();
+            m_sceneQueryShapeCache = AZStd::make_unique<SceneQueryShapeCache>();
+            m_sceneQueryHitBuffer = AZStd::make_unique<SceneQueryHitBuffer>();
+            m_surfaceTypeRegistry = AZStd::make_unique<SurfaceTypeRegistry>();
+            m_simulatedBodyNetData = AZStd::make_unique<SimulatedBodyNetData>();
+            m_weaponDefinitionLibrary = AZStd::make_unique<WeaponDefinitionLibrary>();
+            m_projectileStore = AZStd::make_unique<ProjectileStore>();
+        }
+
+#if AZ_TRAIT_SERVER
+        const bool isHost = (agentType == Multiplayer::MultiplayerAgentType::DedicatedServer)
+            || (agentType == Multiplayer::MultiplayerAgentType::ClientServer);
+        if (isHost && (m_weaponQueryBatch == nullptr))
+        {
+            m_weaponQueryBatch = AZStd::make_unique<WeaponQueryBatch>();
+            m_weaponFireRecorder = AZStd::make_unique<WeaponFireRecorder>();
+            m_botMovementBatch = AZStd::make_unique<BotMovementBatch>();
+        }
+#endif
+
+#if AZ_TRAIT_CLIENT
+        // Only a remote client predicts and receives corrections, a client server host is authoritative for its own player
+        if ((agentType == Multiplayer::MultiplayerAgentType::Client) && (m_predictionStats == nullptr))
+        {
+            m_predictionStats = AZStd::make_unique<PredictionStats>();
+        }
+#endif
     }
 
     AZ::Uuid MultiplayerSampleSystemComponent::GetRenderSceneIdByName(const AZStd::string& name)
@@ -8,15 +8,32 @@
 #pragma once
 
 #include <AzCore/Component/Component.h>
+#include <AzCore/std/smart_ptr/unique_ptr.h>
+#include <Multiplayer/IMultiplayer.h>
 
 namespace MultiplayerSample
 {
+    class BoneIndexCache;
+    class BotMovementBatch;
+    class PredictionStats;
+    class ProjectileStore;
+    class SceneQueryHitBuffer;
+    class SceneQueryShapeCache;
+    class SimulatedBodyNetData;
+    class SurfaceTypeRegistry;
+    class WeaponDefinitionLibrary;
+    class WeaponFireRecorder;
+    class WeaponQueryBatch;
+
     class MultiplayerSampleSystemComponent
         : public AZ::Component
     {
     public:
         AZ_COMPONENT(MultiplayerSampleSystemComponent, "{7BF68D79-E870-44B5-853A-BA68FF4F0B90}");
 
+        MultiplayerSampleSystemComponent();
+        ~MultiplayerSampleSystemComponent() override;
+
         static void Reflect(AZ::ReflectContext* context);
 
         static void GetProvidedServices(AZ::ComponentDescriptor::DependencyArrayType& provided);
@@ -32,5 +49,26 @@ namespace MultiplayerSample
         ////////////////////////////////////////////////////////////////////////
 
         static AZ::Uuid GetRenderSceneIdByName(const AZStd::string& name);
+
+        //! Creates the gameplay services used by the endpoint type of the session that just started.
+        //! Services are only created once a session decides what this process is, the editor and menus never pay for them.
+        void CreateEndpointServices(Multiplayer::MultiplayerAgentType agentType);
+
+        Multiplayer::SessionInitEvent::Handler m_sessionInitHandler{ [this]([[maybe_unused]] AzNetworking::INetworkInterface* networkInterface)
+        {
+            CreateEndpointServices(AZ::Interface<Multiplayer::IMultiplayer>::Get()->GetAgentType());
+        } };
+
+        AZStd::unique_ptr<BoneIndexCache> m_boneIndexCache;
+        AZStd::unique_ptr<PredictionStats> m_predictionStats;
+        AZStd::unique_ptr<SceneQueryShapeCache> m_sceneQueryShapeCache;
+        AZStd::unique_ptr<SceneQueryHitBuffer> m_sceneQueryHitBuffer;
+        AZStd::unique_ptr<SurfaceTypeRegistry> m_surfaceTypeRegistry;
+        AZStd::unique_ptr<SimulatedBodyNetData> m_simulatedBodyNetData;
+        AZStd::unique_ptr<WeaponDefinitionLibrary> m_weaponDefinitionLibrary;
+        AZStd::unique_ptr<WeaponQueryBatch> m_weaponQueryBatch;
+        AZStd::unique_ptr<WeaponFireRecorder> m_weaponFireRecorder;
+        AZStd::unique_ptr<ProjectileStore> m_projectileStore;
+        AZStd::unique_ptr<BotMovementBatch> m_botMovementBatch;
     };
 }
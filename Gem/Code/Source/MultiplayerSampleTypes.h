@@ -13,6 +13,16 @@
 #include <AzNetworking/Utilities/QuantizedValues.h>
 #include <Multiplayer/MultiplayerTypes.h>
 
+//! Enables the check, benchmark and stats console commands along with the counters and timers that only feed them.
+//! Off in release builds, define MPS_DIAGNOSTICS to 0 or 1 to override.
+#if !defined(MPS_DIAGNOSTICS)
+#   if defined(AZ_RELEASE_BUILD)
+#       define MPS_DIAGNOSTICS 0
+#   else
+#       define MPS_DIAGNOSTICS 1
+#   endif
+#endif
+
 namespace MultiplayerSample
 {
     constexpr AZStd::string_view WinningCoinCountSetting = "/MultiplayerSample/Settings/WinningCoinCount";
@@ -20,6 +30,9 @@ namespace MultiplayerSample
     constexpr AZStd::string_view EnergyBallSpeedSetting = "/MultiplayerSample/Settings/EnergyBall/Speed";
     constexpr AZStd::string_view EnergyBallArmorDamageSetting = "/MultiplayerSample/Settings/EnergyBall/ArmorDamage";
     constexpr AZStd::string_view EnergyCannonFiringPeriodSetting = "/MultiplayerSample/Settings/EnergyCannon/FiringPeriodMilliseconds";
+    constexpr AZStd::string_view SurfaceTypesSetting = "/MultiplayerSample/Settings/SurfaceTypes";
+    constexpr AZStd::string_view SurfaceMaterialsSetting = "/MultiplayerSample/Settings/SurfaceMaterials";
+    constexpr AZStd::string_view WeaponDefinitionsSetting = "/MultiplayerSample/Settings/WeaponDefinitions";
 
     using StickAxis = AzNetworking::QuantizedValues<1, 1, -1, 1>;
     using MouseAxis = AzNetworking::QuantizedValues<1, 2, -1, 1>;
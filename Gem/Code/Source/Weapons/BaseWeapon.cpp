@@ -9,6 +9,7 @@
 #include <Source/Weapons/TraceWeapon.h>
 #include <Source/Weapons/ProjectileWeapon.h>
 #include <AzCore/Console/ILogger.h>
+#include <Multiplayer/Components/NetBindComponent.h>
 
 namespace MultiplayerSample
 {
@@ -30,6 +31,14 @@ namespace MultiplayerSample
         m_damageEffect.Initialize();
     }
 
+    BaseWeapon::~BaseWeapon()
+    {
+        if (WeaponQueryBatch* weaponQueryBatch = AZ::Interface<WeaponQueryBatch>::Get())
+        {
+            weaponQueryBatch->Cancel(*this);
+        }
+    }
+
     WeaponIndex BaseWeapon::GetWeaponIndex() const
     {
         return m_weaponIndex;
@@ -140,17 +149,94 @@ namespace MultiplayerSample
         return result;
     }
 
-    void BaseWeapon::DispatchHitEvents(const IntersectResults& gatherResults, const ActivateEvent& eventData, const NetEntityIdSet& prefilteredNetEntityIds)
+    void BaseWeapon::TickActiveShotEndpoints(WeaponState& weaponState, float deltaTime)
+    {
+        const GatherParams& gatherParams = m_weaponParams.m_gatherParams;
+
+        // Walk backwards so that swapping in the last element never moves an unvisited shot
+        for (AZStd::size_t i = weaponState.m_activeShots.size(); i > 0; --i)
+        {
+            ActiveShot& activeShot = weaponState.m_activeShots[i - 1];
+            activeShot.m_lifetimeSeconds = LifetimeSec(activeShot.m_lifetimeSeconds + deltaTime);
+
+            const AZ::Vector3 shotStart = activeShot.m_initialTransform.GetTranslation();
+            const AZ::Vector3 shotPath = activeShot.m_targetPosition - shotStart;
+
+            // The aim target is where a fully simulated shot would most likely have hit, so it stands in for the gathers
+            const float endpointDistance = AZStd::min(shotPath.GetLength(), gatherParams.m_castDistance);
+            const float travelledDistance = (gatherParams.m_travelSpeed > 0.0f)
+                ? activeShot.m_lifetimeSeconds * gatherParams.m_travelSpeed
+                : endpointDistance;
+
+            if (travelledDistance >= endpointDistance)
+            {
+                ExecuteImpactEffect(shotStart, shotStart + shotPath.GetNormalizedSafe() * endpointDistance);
+                activeShot = weaponState.m_activeShots.back();
+                weaponState.m_activeShots.pop_back();
+            }
+        }
+    }
+
+    void BaseWeapon::OnWeaponQueryComplete(uint32_t userData, const ActivateEvent& eventData, ShotResult result, const IntersectResults& results)
+    {
+        if (gp_PauseOnWeaponGather && (results.size() > 0))
+        {
+            AZ::Interface<AZ::IConsole>::Get()->PerformCommand("t_simulationTickScale 0");
+        }
+
+        // Instant gathers and projectiles aren't tracked as active shots, dispatch their hits directly
+        if (userData == InstantGatherUserData)
+        {
+            DispatchHitEvents(results, eventData, m_gatheredNetEntityIds);
+            return;
+        }
+
+        // A shot may be gathered more than once per flush if several inputs were processed this tick, only the first termination counts
+        if ((result == ShotResult::ShouldTerminate) && !m_terminatedShots.test(userData))
+        {
+            m_terminatedShots.set(userData);
+            DispatchHitEvents(results, eventData, m_gatheredNetEntityIds);
+        }
+    }
+
+    WeaponQueryBatch* BaseWeapon::GetQueryBatch() const
+    {
+        if (!m_owningEntity.Exists() || !m_owningEntity.GetNetBindComponent()->IsNetEntityRoleAuthority())
+        {
+            return nullptr;
+        }
+        return GetWeaponQueryBatch();
+    }
+
+    void BaseWeapon::RemoveTerminatedShots(WeaponState& weaponState)
     {
-        HitEvent hitEvent
+        if (m_terminatedShots.none())
+        {
+            return;
+        }
+
+        // Walk backwards so that swapping in the last element never moves an unvisited shot
+        for (AZStd::size_t i = weaponState.m_activeShots.size(); i > 0; --i)
         {
-            eventData.m_targetPosition,
-            eventData.m_shooterId,
-            Multiplayer::InvalidNetEntityId,
-            HitEntities()
-        };
+            const AZStd::size_t shotIndex = i - 1;
+            if (m_terminatedShots.test(shotIndex))
+            {
+                weaponState.m_activeShots[shotIndex] = weaponState.m_activeShots.back();
+                weaponState.m_activeShots.pop_back();
+            }
+        }
+        m_terminatedShots.reset();
+    }
+
+    void BaseWeapon::DispatchHitEvents(const IntersectResults& gatherResults, const ActivateEvent& eventData, const NetEntityIdSet& prefilteredNetEntityIds)
+    {
+        // HitEntities is fixed capacity, so the hit event lives entirely on the stack
+        HitEvent hitEvent;
+        hitEvent.m_target = eventData.m_targetPosition;
+        hitEvent.m_shooterNetEntityId = eventData.m_shooterId;
+        hitEvent.m_projectileNetEntityId = Multiplayer::InvalidNetEntityId;
 
-        for (auto gatherResult : gatherResults)
+        for (const IntersectResult& gatherResult : gatherResults)
         {
             if (prefilteredNetEntityIds.size() > 0)
             {
@@ -161,10 +247,10 @@ namespace MultiplayerSample
                 }
             }
 
-            hitEvent.m_hitEntities.emplace_back(HitEntity{ gatherResult.m_position, gatherResult.m_normal, gatherResult.m_netEntityId });
+            hitEvent.m_hitEntities.emplace_back(HitEntity{ gatherResult.m_position, gatherResult.m_normal, gatherResult.m_netEntityId, gatherResult.m_surfaceIndex });
         }
 
-        WeaponHitInfo hitInfo(*this, hitEvent);
+        WeaponHitInfo hitInfo(*this, hitEvent, eventData.m_initialTransform.GetTranslation());
         m_weaponListener.OnWeaponHit(hitInfo);
     }
 
@@ -175,9 +261,10 @@ namespace MultiplayerSample
         ;
     }
 
-    WeaponHitInfo::WeaponHitInfo(const IWeapon& weapon, const HitEvent& hitEvent)
+    WeaponHitInfo::WeaponHitInfo(const IWeapon& weapon, const HitEvent& hitEvent, const AZ::Vector3& shotOrigin)
         : m_weapon(weapon)
         , m_hitEvent(hitEvent)
+        , m_shotOrigin(shotOrigin)
     {
         ;
     }
@@ -9,6 +9,8 @@
 
 #include <Source/Weapons/IWeapon.h>
 #include <Source/Weapons/WeaponGathers.h>
+#include <Source/Weapons/WeaponQueryBatch.h>
+#include <AzCore/std/containers/bitset.h>
 #include <Multiplayer/NetworkEntity/NetworkEntityHandle.h>
 
 namespace MultiplayerSample
@@ -17,7 +19,7 @@ namespace MultiplayerSample
     {
         const Multiplayer::ConstNetworkEntityHandle m_owningEntity; // the owning entity for this weapon
         const WeaponIndex m_weaponIndex;    // the weapon index
-        const WeaponParams& m_weaponParams; // weapon behaviour parameters
+        const WeaponParams& m_weaponParams; // weapon behaviour parameters, must outlive the weapon
         WeaponListener& m_weaponListener;   // the listener for weapon events
     };
 
@@ -25,13 +27,14 @@ namespace MultiplayerSample
     //! @brief Common base weapon class.
     class BaseWeapon
         : public IWeapon
+        , public WeaponQueryListener
     {
     public:
         //! Constructor.
         //! @param constructParams the set of construction params for the weapon instance
         BaseWeapon(const ConstructParams& constructParams);
-        ~BaseWeapon() = default;
-        
+        ~BaseWeapon() override;
+
         //! IWeapon interface
         //! @{
         WeaponIndex GetWeaponIndex() const override;
@@ -41,11 +44,17 @@ namespace MultiplayerSample
         bool TryStartFire(WeaponState& weaponState, const FireParams& fireParams) override;
         const FireParams& GetFireParams() const override;
         void SetFireParams(const FireParams& fireParams) override;
+        void TickActiveShotEndpoints(WeaponState& weaponState, float deltaTime) override;
         void ExecuteActivateEffect(const AZ::Transform& activateTransform, const AZ::Vector3& target) const override;
         void ExecuteImpactEffect(const AZ::Vector3& activatePosition, const AZ::Vector3& hitPosition) const override;
         void ExecuteDamageEffect(const AZ::Vector3& activatePosition, const AZ::Vector3& hitPosition) const override;
         //! @}
 
+        //! WeaponQueryListener interface
+        //! @{
+        void OnWeaponQueryComplete(uint32_t userData, const ActivateEvent& eventData, ShotResult result, const IntersectResults& results) override;
+        //! @}
+
     protected:
 
         //! Performs internal activation logic and weapons book keeping.
@@ -64,6 +73,14 @@ namespace MultiplayerSample
         //! @param outResults reference to the output structure to store gathered entities in
         ShotResult GatherEntitiesMultisegment(float deltaTime, ActiveShot& inOutActiveShot, IntersectResults& outResults);
 
+        //! Returns the weapon query batch this weapon should defer its gathers to.
+        //! @return the weapon query batch, or nullptr if gathers should be performed immediately
+        WeaponQueryBatch* GetQueryBatch() const;
+
+        //! Removes all active shots that were terminated by completed batched gathers.
+        //! @param weaponState the weapon state being updated
+        void RemoveTerminatedShots(WeaponState& weaponState);
+
         //! Dispatches all pending hit callbacks to the weapons listener.
         //! @param gatherResults the structure containing pending hit entities
         //! @param eventData     specific data regarding the weapon activation
@@ -74,7 +91,7 @@ namespace MultiplayerSample
 
         const Multiplayer::ConstNetworkEntityHandle m_owningEntity;
         const WeaponIndex  m_weaponIndex;
-        const WeaponParams m_weaponParams;
+        const WeaponParams& m_weaponParams; // Shared definition or the owning component's parameters, both outlive the weapon
 
         WeaponListener& m_weaponListener;
 
@@ -84,6 +101,9 @@ namespace MultiplayerSample
 
         FireParams m_fireParams;
         NetEntityIdSet m_gatheredNetEntityIds;
+
+        static constexpr uint32_t InstantGatherUserData = AZStd::numeric_limits<uint32_t>::max();
+        AZStd::bitset<MaxActiveShots> m_terminatedShots; // Active shots terminated by batched gathers, removed on the next tick
     };
 
     //! Factory function to create an appropriate IWeapon instance given the provided ConstructParams.
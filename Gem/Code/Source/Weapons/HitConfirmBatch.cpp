@@ -0,0 +1,324 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project. For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+
+#include <Source/Weapons/HitConfirmBatch.h>
+#include <Source/MultiplayerSampleTypes.h>
+#include <AzCore/Console/IConsole.h>
+#include <AzCore/Console/ILogger.h>
+#include <AzCore/Math/MathUtils.h>
+#include <AzNetworking/Serialization/NetworkInputSerializer.h>
+#include <AzNetworking/Serialization/NetworkOutputSerializer.h>
+
+namespace MultiplayerSample
+{
+    static float SignNotZero(float value)
+    {
+        return (value >= 0.0f) ? 1.0f : -1.0f;
+    }
+
+    uint16_t EncodeOctahedralNormal(const AZ::Vector3& normal)
+    {
+        // Project onto the octahedron |x| + |y| + |z| = 1, then fold the lower hemisphere over the upper one
+        const float l1Norm = AZStd::abs(normal.GetX()) + AZStd::abs(normal.GetY()) + AZStd::abs(normal.GetZ());
+        if (l1Norm <= AZ::Constants::FloatEpsilon)
+        {
+            return EncodeOctahedralNormal(AZ::Vector3::CreateAxisZ());
+        }
+
+        float x = normal.GetX() / l1Norm;
+        float y = normal.GetY() / l1Norm;
+        if (normal.GetZ() < 0.0f)
+        {
+            const float foldedX = (1.0f - AZStd::abs(y)) * SignNotZero(x);
+            const float foldedY = (1.0f - AZStd::abs(x)) * SignNotZero(y);
+            x = foldedX;
+            y = foldedY;
+        }
+
+        const uint16_t encodedX = aznumeric_cast<uint16_t>(AZStd::lround(AZ::GetClamp((x * 0.5f + 0.5f) * 255.0f, 0.0f, 255.0f)));
+        const uint16_t encodedY = aznumeric_cast<uint16_t>(AZStd::lround(AZ::GetClamp((y * 0.5f + 0.5f) * 255.0f, 0.0f, 255.0f)));
+        return aznumeric_cast<uint16_t>((encodedX << 8) | encodedY);
+    }
+
+    AZ::Vector3 DecodeOctahedralNormal(uint16_t encodedNormal)
+    {
+        float x = aznumeric_cast<float>(encodedNormal >> 8) / 255.0f * 2.0f - 1.0f;
+        float y = aznumeric_cast<float>(encodedNormal & 0xFF) / 255.0f * 2.0f - 1.0f;
+        const float z = 1.0f - AZStd::abs(x) - AZStd::abs(y);
+        if (z < 0.0f)
+        {
+            const float unfoldedX = (1.0f - AZStd::abs(y)) * SignNotZero(x);
+            const float unfoldedY = (1.0f - AZStd::abs(x)) * SignNotZero(y);
+            x = unfoldedX;
+            y = unfoldedY;
+        }
+        return AZ::Vector3(x, y, z).GetNormalized();
+    }
+
+    static bool IsInOffsetRange(const AZ::Vector3& origin, const AZ::Vector3& position)
+    {
+        const AZ::Vector3 offset = (position - origin).GetAbs();
+        return offset.GetMaxElement() <= aznumeric_cast<float>(HitOffsetRange);
+    }
+
+    static bool IsInOffsetRange(const AZ::Vector3& origin, const HitEvent& hitEvent)
+    {
+        if (!IsInOffsetRange(origin, hitEvent.m_target))
+        {
+            return false;
+        }
+        for (const HitEntity& hitEntity : hitEvent.m_hitEntities)
+        {
+            if (!IsInOffsetRange(origin, hitEntity.m_hitPosition))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool HitConfirmBatch::TryAddHitEvent(WeaponIndex weaponIndex, const AZ::Vector3& shotOrigin, const HitEvent& hitEvent)
+    {
+        if ((m_hitEvents.size() >= m_hitEvents.capacity())
+            || (m_hitEntities.size() + hitEvent.m_hitEntities.size() > m_hitEntities.capacity()))
+        {
+            return false;
+        }
+
+        if (m_hitEvents.empty())
+        {
+            m_batchOrigin = shotOrigin;
+            if (!IsInOffsetRange(m_batchOrigin, hitEvent))
+            {
+                // Long casts can hit further away than the offset range, center the batch on the hits instead
+                AZ::Vector3 minPosition = hitEvent.m_target;
+                AZ::Vector3 maxPosition = hitEvent.m_target;
+                for (const HitEntity& hitEntity : hitEvent.m_hitEntities)
+                {
+                    minPosition = minPosition.GetMin(hitEntity.m_hitPosition);
+                    maxPosition = maxPosition.GetMax(hitEntity.m_hitPosition);
+                }
+                m_batchOrigin = (minPosition + maxPosition) * 0.5f;
+            }
+        }
+        else if (!IsInOffsetRange(m_batchOrigin, hitEvent))
+        {
+            return false;
+        }
+
+        ConfirmedHitEvent& confirmedHitEvent = m_hitEvents.emplace_back();
+        confirmedHitEvent.m_weaponIndex = weaponIndex;
+        confirmedHitEvent.m_target = hitEvent.m_target;
+        confirmedHitEvent.m_projectileNetEntityId = hitEvent.m_projectileNetEntityId;
+        confirmedHitEvent.m_hitCount = aznumeric_cast<uint8_t>(hitEvent.m_hitEntities.size());
+        m_hitEntities.insert(m_hitEntities.end(), hitEvent.m_hitEntities.begin(), hitEvent.m_hitEntities.end());
+        return true;
+    }
+
+    bool HitConfirmBatch::IsEmpty() const
+    {
+        return m_hitEvents.empty();
+    }
+
+    void HitConfirmBatch::Clear()
+    {
+        m_hitEvents.clear();
+        m_hitEntities.clear();
+    }
+
+    bool HitConfirmBatch::Serialize(AzNetworking::ISerializer& serializer)
+    {
+        const bool isReading = (serializer.GetSerializerMode() == AzNetworking::SerializerMode::WriteToObject);
+
+        uint8_t eventCount = aznumeric_cast<uint8_t>(m_hitEvents.size());
+        if (!serializer.Serialize(eventCount, "EventCount") || (eventCount > MaxBatchedHitEvents))
+        {
+            return false;
+        }
+        m_hitEvents.resize(eventCount);
+        if ((eventCount > 0) && !serializer.Serialize(m_batchOrigin, "BatchOrigin"))
+        {
+            return false;
+        }
+
+        size_t hitCount = 0;
+        for (ConfirmedHitEvent& confirmedHitEvent : m_hitEvents)
+        {
+            QuantizedHitOffset targetOffset(confirmedHitEvent.m_target - m_batchOrigin);
+            serializer.Serialize(confirmedHitEvent.m_weaponIndex, "WeaponIndex");
+            serializer.Serialize(targetOffset, "TargetOffset");
+            serializer.Serialize(confirmedHitEvent.m_projectileNetEntityId, "ProjectileNetEntityId");
+            serializer.Serialize(confirmedHitEvent.m_hitCount, "HitCount");
+            if (isReading)
+            {
+                confirmedHitEvent.m_target = m_batchOrigin + static_cast<AZ::Vector3>(targetOffset);
+            }
+            hitCount += confirmedHitEvent.m_hitCount;
+        }
+
+        if (!serializer.IsValid() || (hitCount > MaxHitEntities))
+        {
+            return false;
+        }
+        m_hitEntities.resize(hitCount);
+
+        size_t hitIndex = 0;
+        for (const ConfirmedHitEvent& confirmedHitEvent : m_hitEvents)
+        {
+            for (uint32_t eventHit = 0; eventHit < confirmedHitEvent.m_hitCount; ++eventHit, ++hitIndex)
+            {
+                HitEntity& hitEntity = m_hitEntities[hitIndex];
+                QuantizedHitOffset positionOffset(hitEntity.m_hitPosition - m_batchOrigin);
+                uint16_t encodedNormal = EncodeOctahedralNormal(hitEntity.m_hitNormal);
+                serializer.Serialize(positionOffset, "PositionOffset");
+                serializer.Serialize(encodedNormal, "Normal");
+                serializer.Serialize(hitEntity.m_hitNetEntityId, "HitNetEntityId");
+                serializer.Serialize(hitEntity.m_surfaceIndex, "SurfaceIndex");
+                if (isReading)
+                {
+                    hitEntity.m_hitPosition = m_batchOrigin + static_cast<AZ::Vector3>(positionOffset);
+                    hitEntity.m_hitNormal = DecodeOctahedralNormal(encodedNormal);
+                }
+            }
+        }
+
+        return serializer.IsValid();
+    }
+
+#if MPS_DIAGNOSTICS
+    static HitEvent MakeSyntheticHitEvent(const AZ::Vector3& shotOrigin, uint32_t shotIndex, uint32_t hitsPerShot)
+    {
+        // Deterministic spread of hits and normals so the round trip covers every octant
+        HitEvent hitEvent;
+        const float angle = 2.399963f * shotIndex; // Golden angle
+        const AZ::Vector3 direction = AZ::Vector3(AZStd::cos(angle), AZStd::sin(angle), 0.3f * AZStd::sin(angle * 3.0f)).GetNormalized();
+        hitEvent.m_target = shotOrigin + direction * 150.0f;
+        hitEvent.m_shooterNetEntityId = Multiplayer::NetEntityId{ 1 };
+        for (uint32_t hit = 0; hit < hitsPerShot; ++hit)
+        {
+            const AZ::Vector3 normal = AZ::Vector3(AZStd::sin(angle + hit), AZStd::cos(angle * 2.0f + hit), AZStd::sin(angle * 0.5f - hit)).GetNormalized();
+            hitEvent.m_hitEntities.emplace_back(HitEntity{ shotOrigin + direction * (5.0f + 10.0f * hit + 0.37f * shotIndex),
+                normal, Multiplayer::NetEntityId{ 100 + hit }, aznumeric_cast<SurfaceIndex>(hit % 4) });
+        }
+        return hitEvent;
+    }
+
+    static void sv_HitConfirmBatchCheck(const AZ::ConsoleCommandContainer& arguments)
+    {
+        const uint32_t playerCount = (arguments.size() > 0) ? aznumeric_cast<uint32_t>(AZStd::stoi(AZStd::string(arguments[0]))) : 64;
+        const uint32_t hitEventsPerTick = (arguments.size() > 1) ? aznumeric_cast<uint32_t>(AZStd::stoi(AZStd::string(arguments[1]))) : 2;
+        const uint32_t hitsPerShot = (arguments.size() > 2) ? aznumeric_cast<uint32_t>(AZStd::stoi(AZStd::string(arguments[2]))) : 1;
+        const float tickRate = (arguments.size() > 3) ? AZStd::stof(AZStd::string(arguments[3])) : 30.0f;
+        constexpr uint32_t EstimatedRpcHeaderBytes = 12; // Entity id, component and rpc indices and payload size of each rpc message
+
+        AZStd::array<uint8_t, 4096> buffer;
+        const AZ::Vector3 shotOrigin(812.5f, -371.25f, 42.0f);
+
+        // Round trip a batch and compare against the unquantized hit events
+        HitConfirmBatch batch;
+        AZStd::fixed_vector<HitEvent, MaxBatchedHitEvents> sentHitEvents;
+        for (uint32_t shotIndex = 0; shotIndex < MaxBatchedHitEvents; ++shotIndex)
+        {
+            const HitEvent hitEvent = MakeSyntheticHitEvent(shotOrigin, shotIndex, AZStd::min(hitsPerShot, MaxHitEntities / MaxBatchedHitEvents));
+            if (batch.TryAddHitEvent(WeaponIndex{ shotIndex % MaxWeaponsPerComponent }, shotOrigin, hitEvent))
+            {
+                sentHitEvents.push_back(hitEvent);
+            }
+        }
+
+        AzNetworking::NetworkInputSerializer writer(buffer.data(), aznumeric_cast<uint32_t>(buffer.size()));
+        const bool wrote = batch.Serialize(writer);
+        const uint32_t batchBytes = writer.GetSize();
+
+        HitConfirmBatch receivedBatch;
+        AzNetworking::NetworkOutputSerializer reader(buffer.data(), batchBytes);
+        const bool read = receivedBatch.Serialize(reader);
+
+        float maxPositionError = 0.0f;
+        float minNormalDot = 1.0f;
+        bool matches = wrote && read && (receivedBatch.m_hitEvents.size() == sentHitEvents.size());
+        size_t eventIndex = 0;
+        receivedBatch.VisitHitEvents(Multiplayer::NetEntityId{ 1 }, [&](WeaponIndex, const HitEvent& receivedHitEvent)
+        {
+            if (eventIndex >= sentHitEvents.size())
+            {
+                matches = false;
+                return;
+            }
+
+            const HitEvent& sentHitEvent = sentHitEvents[eventIndex++];
+            maxPositionError = AZStd::max(maxPositionError, sentHitEvent.m_target.GetDistance(receivedHitEvent.m_target));
+            matches = matches && (receivedHitEvent.m_hitEntities.size() == sentHitEvent.m_hitEntities.size());
+            for (size_t hit = 0; matches && (hit < sentHitEvent.m_hitEntities.size()); ++hit)
+            {
+                const HitEntity& sent = sentHitEvent.m_hitEntities[hit];
+                const HitEntity& received = receivedHitEvent.m_hitEntities[hit];
+                maxPositionError = AZStd::max(maxPositionError, sent.m_hitPosition.GetDistance(received.m_hitPosition));
+                minNormalDot = AZStd::min(minNormalDot, sent.m_hitNormal.Dot(received.m_hitNormal));
+                matches = (sent.m_hitNetEntityId == received.m_hitNetEntityId) && (sent.m_surfaceIndex == received.m_surfaceIndex);
+            }
+        });
+
+        // One quantum of the offset range per axis, and an 8 bit octahedral normal stays within about a degree
+        constexpr float maxExpectedPositionError = 2.0f * HitOffsetRange / (1 << 16) * 2.0f;
+        constexpr float minExpectedNormalDot = 0.999f;
+        if (matches && (maxPositionError <= maxExpectedPositionError) && (minNormalDot >= minExpectedNormalDot))
+        {
+            AZLOG_INFO("Hit confirm batch round trip passed, max position error %.6f m, min normal dot %.5f", maxPositionError, minNormalDot);
+        }
+        else
+        {
+            AZLOG_WARN("Hit confirm batch round trip failed, max position error %.6f m, min normal dot %.5f", maxPositionError, minNormalDot);
+        }
+
+        // Bandwidth of one shooter's tick worth of hits, sent once per rpc versus once per batch
+        uint32_t perHitRpcBytes = 0;
+        for (uint32_t shotIndex = 0; shotIndex < hitEventsPerTick; ++shotIndex)
+        {
+            HitEvent hitEvent = MakeSyntheticHitEvent(shotOrigin, shotIndex, AZStd::min(hitsPerShot, MaxHitEntities));
+            WeaponIndex weaponIndex{ 0 };
+            AzNetworking::NetworkInputSerializer hitEventWriter(buffer.data(), aznumeric_cast<uint32_t>(buffer.size()));
+            hitEventWriter.Serialize(weaponIndex, "WeaponIndex");
+            hitEvent.Serialize(hitEventWriter);
+            perHitRpcBytes += hitEventWriter.GetSize() + EstimatedRpcHeaderBytes;
+        }
+
+        // A full batch is flushed early and a new one started, just like on the server
+        uint32_t batchedBytes = 0;
+        uint32_t batchCount = 0;
+        batch.Clear();
+        for (uint32_t shotIndex = 0; shotIndex < hitEventsPerTick; ++shotIndex)
+        {
+            const HitEvent hitEvent = MakeSyntheticHitEvent(shotOrigin, shotIndex, AZStd::min(hitsPerShot, MaxHitEntities));
+            if (!batch.TryAddHitEvent(WeaponIndex{ 0 }, shotOrigin, hitEvent))
+            {
+                AzNetworking::NetworkInputSerializer batchWriter(buffer.data(), aznumeric_cast<uint32_t>(buffer.size()));
+                batch.Serialize(batchWriter);
+                batchedBytes += batchWriter.GetSize() + EstimatedRpcHeaderBytes;
+                ++batchCount;
+                batch.Clear();
+                batch.TryAddHitEvent(WeaponIndex{ 0 }, shotOrigin, hitEvent);
+            }
+        }
+        if (!batch.IsEmpty())
+        {
+            AzNetworking::NetworkInputSerializer batchWriter(buffer.data(), aznumeric_cast<uint32_t>(buffer.size()));
+            batch.Serialize(batchWriter);
+            batchedBytes += batchWriter.GetSize() + EstimatedRpcHeaderBytes;
+            ++batchCount;
+        }
+
+        // Every player receives the confirmed hits of every shooter
+        const float observerScale = aznumeric_cast<float>(playerCount) * aznumeric_cast<float>(playerCount) * tickRate / 1024.0f;
+        AZLOG_INFO("Hit confirm bandwidth, %u players with %u hit events of %u hits per tick at %.0f hz: per hit rpcs %u bytes in %u rpcs (%.1f KiB/s), batched %u bytes in %u rpcs (%.1f KiB/s)",
+            playerCount, hitEventsPerTick, hitsPerShot, tickRate,
+            perHitRpcBytes, hitEventsPerTick, perHitRpcBytes * observerScale,
+            batchedBytes, batchCount, batchedBytes * observerScale);
+    }
+    AZ_CONSOLEFREEFUNC(sv_HitConfirmBatchCheck, AZ::ConsoleFunctorFlags::Null, "Round trips a confirmed hit batch through serialization and compares per hit and batched bandwidth, optionally takes player count, hit events per tick, hits per event and tick rate");
+#endif
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project. For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+
+#pragma once
+
+#include <Source/Weapons/WeaponTypes.h>
+
+namespace MultiplayerSample
+{
+    constexpr uint32_t MaxBatchedHitEvents = 8; // Maximum number of hit events sent in a single confirmed hit batch
+
+    //! Target and hit positions are sent relative to the origin of their batch.
+    //! Two bytes per axis over 2048 meters gives a precision of roughly three centimeters, which is plenty for placing hit effects.
+    constexpr int32_t HitOffsetRange = 1024;
+    using QuantizedHitOffset = AzNetworking::QuantizedValues<3, 2, -HitOffsetRange, HitOffsetRange>;
+
+    //! Encodes a unit normal into 16 bits using an octahedral mapping, 8 bits per axis of the unfolded octahedron.
+    //! @param normal the unit normal to encode
+    //! @return the encoded normal
+    uint16_t EncodeOctahedralNormal(const AZ::Vector3& normal);
+
+    //! Decodes a unit normal encoded by EncodeOctahedralNormal.
+    //! @param encodedNormal the encoded normal
+    //! @return the decoded unit normal
+    AZ::Vector3 DecodeOctahedralNormal(uint16_t encodedNormal);
+
+    //! @struct ConfirmedHitEvent
+    //! @brief Header of a single hit event within a HitConfirmBatch, the hit entities are stored flattened in the batch.
+    struct ConfirmedHitEvent
+    {
+        WeaponIndex m_weaponIndex = WeaponIndex{ 0 };
+        AZ::Vector3 m_target = AZ::Vector3::CreateZero();
+        Multiplayer::NetEntityId m_projectileNetEntityId = Multiplayer::InvalidNetEntityId;
+        uint8_t m_hitCount = 0; // Number of hit entities belonging to this event
+    };
+
+    //! @struct HitConfirmBatch
+    //! @brief All hit events a weapons component confirmed during a tick, sent to clients in a single remote procedure call.
+    //! The batch origin is the only full precision position sent, target and hit positions are quantized relative to it.
+    //! Normals are octahedral encoded and the shooter is implied by the sending entity.
+    struct HitConfirmBatch
+    {
+        //! Adds a hit event to the batch.
+        //! @param weaponIndex index of the weapon that produced the hit event
+        //! @param shotOrigin  origin of the shot that produced the hit event, becomes the batch origin if the batch is empty
+        //! @param hitEvent    the hit event to add
+        //! @return false if the batch does not have room for the hit event or its positions are out of range of the batch origin,
+        //!         the batch is left unmodified. Adding to an empty batch always succeeds
+        bool TryAddHitEvent(WeaponIndex weaponIndex, const AZ::Vector3& shotOrigin, const HitEvent& hitEvent);
+
+        //! Invokes the visitor for every hit event in the batch, in the order they were added.
+        //! @param shooterNetEntityId the entity that sent the batch, assigned to every hit event
+        //! @param visitor            callable taking a WeaponIndex and a const HitEvent&
+        template <typename VISITOR>
+        void VisitHitEvents(Multiplayer::NetEntityId shooterNetEntityId, VISITOR&& visitor) const;
+
+        bool IsEmpty() const;
+        void Clear();
+
+        bool Serialize(AzNetworking::ISerializer& serializer);
+
+        AZ::Vector3 m_batchOrigin = AZ::Vector3::CreateZero(); // Origin that every target and hit position in the batch is encoded relative to
+        AZStd::fixed_vector<ConfirmedHitEvent, MaxBatchedHitEvents> m_hitEvents;
+        HitEntities m_hitEntities; // Hit entities of every event, in event order
+    };
+
+    template <typename VISITOR>
+    void HitConfirmBatch::VisitHitEvents(Multiplayer::NetEntityId shooterNetEntityId, VISITOR&& visitor) const
+    {
+        HitEvent hitEvent;
+        hitEvent.m_shooterNetEntityId = shooterNetEntityId;
+
+        size_t firstHit = 0;
+        for (const ConfirmedHitEvent& confirmedHitEvent : m_hitEvents)
+        {
+            hitEvent.m_target = confirmedHitEvent.m_target;
+            hitEvent.m_projectileNetEntityId = confirmedHitEvent.m_projectileNetEntityId;
+            hitEvent.m_hitEntities.assign(m_hitEntities.begin() + firstHit, m_hitEntities.begin() + firstHit + confirmedHitEvent.m_hitCount);
+            firstHit += confirmedHitEvent.m_hitCount;
+
+            visitor(confirmedHitEvent.m_weaponIndex, static_cast<const HitEvent&>(hitEvent));
+        }
+    }
+}
@@ -89,6 +89,12 @@ namespace MultiplayerSample
         //! @param deltaTime   the amount of time we are ticking over
         virtual void TickActiveShots(WeaponState& weaponState, float deltaTime) = 0;
 
+        //! Ticks the active shots for this weapon without gathering, used for remote shots simulated at reduced detail.
+        //! Shots only play their impact effect at their target once they would have reached it and never dispatch hits.
+        //! @param weaponState reference to the predictive state for this weapon
+        //! @param deltaTime   the amount of time we are ticking over
+        virtual void TickActiveShotEndpoints(WeaponState& weaponState, float deltaTime) = 0;
+
         //! Executes the activation sound effect bound to this weapon instance at the specified location.
         //! @param activateTransform the initial transform corresponding to weapon activation
         //! @param target the point targeted by the activation event
@@ -125,12 +131,14 @@ namespace MultiplayerSample
     struct WeaponHitInfo
     {
         //! Full constructor.
-        //! @param weapon   reference to the weapon instance which produced the hit
-        //! @param hitEvent specific details about the weapon hit event
-        WeaponHitInfo(const IWeapon& weapon, const HitEvent& hitEvent);
-
-        const IWeapon& m_weapon; //< Reference to the weapon instance which produced the hit
-        HitEvent m_hitEvent;     //< Specific details about the weapon hit event
+        //! @param weapon     reference to the weapon instance which produced the hit
+        //! @param hitEvent   specific details about the weapon hit event
+        //! @param shotOrigin origin of the shot which produced the hit, zero for hits confirmed by the server
+        WeaponHitInfo(const IWeapon& weapon, const HitEvent& hitEvent, const AZ::Vector3& shotOrigin = AZ::Vector3::CreateZero());
+
+        const IWeapon& m_weapon;  //< Reference to the weapon instance which produced the hit
+        HitEvent m_hitEvent;      //< Specific details about the weapon hit event
+        AZ::Vector3 m_shotOrigin; //< Origin of the shot which produced the hit
 
         WeaponHitInfo& operator =(const WeaponHitInfo&) = delete; // Don't allow copying, these guys get dispatched under special conditions
     };
@@ -0,0 +1,391 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project. For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+
+#include <Source/Weapons/ProjectileStore.h>
+#include <Source/Weapons/SceneQuery.h>
+#include <Source/MultiplayerSampleTypes.h>
+#include <AzCore/Console/IConsole.h>
+#include <AzCore/Console/ILogger.h>
+#include <AzCore/Interface/Interface.h>
+#include <AzCore/std/chrono/chrono.h>
+#include <AzCore/std/sort.h>
+#include <AzFramework/Physics/PhysicsScene.h>
+#include <Multiplayer/NetworkTime/INetworkTime.h>
+
+namespace MultiplayerSample
+{
+    bool ProjectileStore::RewindOffset::operator==(const RewindOffset& rhs) const
+    {
+        return m_frameOffset == rhs.m_frameOffset
+            && m_timeOffsetMs == rhs.m_timeOffsetMs
+            && m_blendFactor == rhs.m_blendFactor
+            && m_connectionId == rhs.m_connectionId;
+    }
+
+    bool ProjectileStore::RewindOffset::operator!=(const RewindOffset& rhs) const
+    {
+        return !(*this == rhs);
+    }
+
+    bool ProjectileStore::RewindOffset::operator<(const RewindOffset& rhs) const
+    {
+        if (m_connectionId != rhs.m_connectionId)
+        {
+            return m_connectionId < rhs.m_connectionId;
+        }
+        if (m_frameOffset != rhs.m_frameOffset)
+        {
+            return m_frameOffset < rhs.m_frameOffset;
+        }
+        if (m_timeOffsetMs != rhs.m_timeOffsetMs)
+        {
+            return m_timeOffsetMs < rhs.m_timeOffsetMs;
+        }
+        return m_blendFactor < rhs.m_blendFactor;
+    }
+
+    ProjectileStore::ProjectileStore()
+    {
+        AZ::Interface<ProjectileStore>::Register(this);
+        m_tickEvent.Enqueue(AZ::Time::ZeroTimeMs, true);
+    }
+
+    ProjectileStore::~ProjectileStore()
+    {
+        m_tickEvent.RemoveFromQueue();
+        AZ::Interface<ProjectileStore>::Unregister(this);
+    }
+
+    void ProjectileStore::Spawn(const GatherParams& gatherParams, const ActivateEvent& eventData, WeaponQueryListener& listener, uint32_t userData)
+    {
+        if (gatherParams.m_travelSpeed <= 0.0f)
+        {
+            AZ_Assert(false, "Projectiles require a positive, non-zero travel speed.");
+            return;
+        }
+
+        const AZ::Vector3& initialPosition = eventData.m_initialTransform.GetTranslation();
+        const AZ::Vector3 direction = (eventData.m_targetPosition - initialPosition).GetNormalizedSafe();
+
+        RewindOffset rewindOffset;
+        Multiplayer::INetworkTime* networkTime = Multiplayer::GetNetworkTime();
+        if (networkTime->IsTimeRewound() && (m_tickFrameId != Multiplayer::InvalidHostFrameId) && (networkTime->GetHostFrameId() <= m_tickFrameId))
+        {
+            rewindOffset.m_frameOffset = static_cast<uint32_t>(m_tickFrameId) - static_cast<uint32_t>(networkTime->GetHostFrameId());
+            rewindOffset.m_timeOffsetMs = m_tickTimeMs - networkTime->GetHostTimeMs();
+            rewindOffset.m_blendFactor = networkTime->GetHostBlendFactor();
+            rewindOffset.m_connectionId = networkTime->GetRewindingConnectionId();
+        }
+
+        m_positions.push_back(initialPosition);
+        m_velocities.push_back(direction * gatherParams.m_travelSpeed);
+        m_lifetimes.push_back(0.0f);
+        m_ownerIds.push_back(eventData.m_shooterId);
+        m_gatherParams.push_back(&gatherParams);
+        m_listeners.push_back(&listener);
+        m_userData.push_back(userData);
+        m_rewindOffsets.push_back(rewindOffset);
+    }
+
+    void ProjectileStore::Remove(const WeaponQueryListener& listener)
+    {
+        for (uint32_t index = 0; index < m_listeners.size();)
+        {
+            if (m_listeners[index] == &listener)
+            {
+                RemoveAt(index);
+            }
+            else
+            {
+                ++index;
+            }
+        }
+
+        for (WeaponQueryListener*& terminatedListener : m_terminatedListeners)
+        {
+            if (terminatedListener == &listener)
+            {
+                terminatedListener = nullptr;
+            }
+        }
+    }
+
+    void ProjectileStore::Tick(float deltaTime)
+    {
+        if (m_positions.empty() || (deltaTime <= 0.0f))
+        {
+            return;
+        }
+
+        const AzPhysics::SceneHandle sceneHandle = SceneQuery::GetDefaultSceneHandle();
+        if (sceneHandle == AzPhysics::InvalidSceneHandle)
+        {
+            return;
+        }
+
+        const AZ::Vector3 gravity = AZ::Interface<AzPhysics::SceneInterface>::Get()->GetGravity(sceneHandle);
+        const uint32_t projectileCount = aznumeric_cast<uint32_t>(m_positions.size());
+
+        // Sort projectiles so that all projectiles simulated under the same rewind offset are adjacent, ties keep spawn order
+        m_sortedIndices.resize(projectileCount);
+        for (uint32_t index = 0; index < projectileCount; ++index)
+        {
+            m_sortedIndices[index] = index;
+        }
+
+        AZStd::sort(m_sortedIndices.begin(), m_sortedIndices.end(), [this](uint32_t lhs, uint32_t rhs)
+        {
+            const RewindOffset& lhsOffset = m_rewindOffsets[lhs];
+            const RewindOffset& rhsOffset = m_rewindOffsets[rhs];
+            return (lhsOffset != rhsOffset) ? (lhsOffset < rhsOffset) : (lhs < rhs);
+        });
+
+        Multiplayer::INetworkTime* networkTime = Multiplayer::GetNetworkTime();
+        const Multiplayer::HostFrameId hostFrameId = networkTime->GetHostFrameId();
+        const AZ::TimeMs hostTimeMs = networkTime->GetHostTimeMs();
+
+        uint32_t groupStart = 0;
+        while (groupStart < projectileCount)
+        {
+            const RewindOffset& rewindOffset = m_rewindOffsets[m_sortedIndices[groupStart]];
+            uint32_t groupEnd = groupStart + 1;
+            while ((groupEnd < projectileCount) && (m_rewindOffsets[m_sortedIndices[groupEnd]] == rewindOffset))
+            {
+                ++groupEnd;
+            }
+
+            if ((rewindOffset.m_connectionId == AzNetworking::InvalidConnectionId) || (static_cast<uint32_t>(hostFrameId) < rewindOffset.m_frameOffset))
+            {
+                for (uint32_t sortedIndex = groupStart; sortedIndex < groupEnd; ++sortedIndex)
+                {
+                    StepProjectile(m_sortedIndices[sortedIndex], deltaTime, gravity, sceneHandle, nullptr);
+                }
+            }
+            else
+            {
+                // Step under the same offset from the host as the input that fired the projectile
+                const Multiplayer::HostFrameId rewoundFrameId(static_cast<uint32_t>(hostFrameId) - rewindOffset.m_frameOffset);
+                Multiplayer::ScopedAlterTime scopedTime(rewoundFrameId, hostTimeMs - rewindOffset.m_timeOffsetMs, rewindOffset.m_blendFactor, rewindOffset.m_connectionId);
+                RewindSyncScope rewindSyncScope(m_rewindSyncStats);
+                for (uint32_t sortedIndex = groupStart; sortedIndex < groupEnd; ++sortedIndex)
+                {
+                    StepProjectile(m_sortedIndices[sortedIndex], deltaTime, gravity, sceneHandle, &rewindSyncScope);
+                }
+                networkTime->ClearRewoundEntities();
+            }
+
+            groupStart = groupEnd;
+        }
+
+        // Remove from the highest index down so that swap and pop only ever moves projectiles that are still live
+        AZStd::sort(m_terminatedIndices.begin(), m_terminatedIndices.end(), AZStd::greater<uint32_t>());
+        for (const uint32_t index : m_terminatedIndices)
+        {
+            RemoveAt(index);
+        }
+        m_terminatedIndices.clear();
+
+        // Listeners may remove projectiles or destroy themselves in response to hits, so only notify them once stepping is complete
+        const uint32_t terminatedCount = aznumeric_cast<uint32_t>(m_terminatedEvents.size());
+        for (uint32_t terminatedIndex = 0; terminatedIndex < terminatedCount; ++terminatedIndex)
+        {
+            if (WeaponQueryListener* listener = m_terminatedListeners[terminatedIndex])
+            {
+                listener->OnWeaponQueryComplete(m_terminatedUserData[terminatedIndex], m_terminatedEvents[terminatedIndex],
+                    ShotResult::ShouldTerminate, m_terminatedResults[terminatedIndex]);
+            }
+        }
+
+        m_terminatedEvents.clear();
+        m_terminatedListeners.clear();
+        m_terminatedUserData.clear();
+    }
+
+    uint32_t ProjectileStore::GetProjectileCount() const
+    {
+        return aznumeric_cast<uint32_t>(m_positions.size());
+    }
+
+    const RewindSyncScope::Stats& ProjectileStore::GetRewindSyncStats() const
+    {
+        return m_rewindSyncStats;
+    }
+
+    void ProjectileStore::ResetRewindSyncStats()
+    {
+        m_rewindSyncStats = RewindSyncScope::Stats();
+    }
+
+    void ProjectileStore::TickNetworkTime()
+    {
+        // Scheduled events run outside of input processing, so this is always the unaltered host time
+        Multiplayer::INetworkTime* networkTime = Multiplayer::GetNetworkTime();
+        const AZ::TimeMs hostTimeMs = networkTime->GetHostTimeMs();
+        const AZ::TimeMs deltaTimeMs = (m_tickFrameId != Multiplayer::InvalidHostFrameId) ? hostTimeMs - m_tickTimeMs : AZ::Time::ZeroTimeMs;
+        m_tickFrameId = networkTime->GetHostFrameId();
+        m_tickTimeMs = hostTimeMs;
+
+        Tick(AZ::TimeMsToSeconds(deltaTimeMs));
+    }
+
+    bool ProjectileStore::StepProjectile(uint32_t index, float deltaTime, const AZ::Vector3& gravity, AzPhysics::SceneHandle sceneHandle, RewindSyncScope* rewindSyncScope)
+    {
+        const GatherParams& gatherParams = *m_gatherParams[index];
+        const HitMultiple hitMultiple = gatherParams.m_multiHit ? HitMultiple::Yes : HitMultiple::No;
+        const AzPhysics::CollisionGroup collisionGroup = AzPhysics::GetCollisionGroupById(gatherParams.m_collisionGroupId);
+        const AZ::Vector3 acceleration = gatherParams.m_bulletDrop ? gravity : AZ::Vector3::CreateZero();
+        const float maxLifetime = gatherParams.m_castDistance / gatherParams.m_travelSpeed;
+        const uint32_t numSegments = GetMultitraceSegmentCount(deltaTime, acceleration);
+        const float segmentTickSize = deltaTime / numSegments;
+
+        // Projectiles fired by the same owner tend to be adjacent, only rebuild the filter when the owner changes
+        if (m_ownerIds[index] != m_filteredOwnerId)
+        {
+            m_filteredOwnerId = m_ownerIds[index];
+            m_filteredNetEntityIds.clear();
+            m_filteredNetEntityIds.insert(m_filteredOwnerId);
+        }
+
+        AZ::Vector3 position = m_positions[index];
+        AZ::Vector3 velocity = m_velocities[index];
+        float lifetime = m_lifetimes[index];
+        AZ::Vector3 segmentStart = position;
+        bool shouldTerminate = false;
+
+        // Segments only differ by pose and sweep, so a single filter is reused for the whole step
+        IntersectFilter filter(AZ::Transform::CreateIdentity(), AZ::Vector3::CreateZero(), AzPhysics::SceneQuery::QueryType::StaticAndDynamic,
+            hitMultiple, collisionGroup, m_filteredNetEntityIds, gatherParams.GetCurrentShapeConfiguration());
+
+        m_intersectResults.clear();
+        for (uint32_t segment = 0; (segment < numSegments) && !shouldTerminate; ++segment)
+        {
+            // Same constant acceleration model as multitrace shots, stepped from the current state rather than from the muzzle
+            segmentStart = position;
+            position = segmentStart + (velocity * segmentTickSize) + (acceleration * 0.5f * segmentTickSize * segmentTickSize);
+            velocity += acceleration * segmentTickSize;
+            lifetime += segmentTickSize;
+
+            filter.m_initialPose = AZ::Transform::CreateLookAt(segmentStart, position);
+            filter.m_sweep = position - segmentStart;
+            if (rewindSyncScope != nullptr)
+            {
+                rewindSyncScope->SyncEntitiesToRewindState(SceneQuery::GetRewindBounds(filter));
+            }
+            SceneQuery::WorldIntersect(sceneHandle, gatherParams.m_gatherShape, filter, m_intersectResults);
+
+            shouldTerminate = (!m_intersectResults.empty() && !gatherParams.m_multiHit) || (lifetime > maxLifetime);
+        }
+
+        if (!shouldTerminate)
+        {
+            m_positions[index] = position;
+            m_velocities[index] = velocity;
+            m_lifetimes[index] = lifetime;
+            return false;
+        }
+
+        const uint32_t terminatedCount = aznumeric_cast<uint32_t>(m_terminatedEvents.size());
+        if (terminatedCount >= m_terminatedResults.size())
+        {
+            m_terminatedResults.emplace_back();
+        }
+        AZStd::swap(m_terminatedResults[terminatedCount], m_intersectResults);
+        m_terminatedEvents.push_back(ActivateEvent{ AZ::Transform::CreateLookAt(segmentStart, position), position, m_ownerIds[index], Multiplayer::InvalidNetEntityId });
+        m_terminatedListeners.push_back(m_listeners[index]);
+        m_terminatedUserData.push_back(m_userData[index]);
+        m_terminatedIndices.push_back(index);
+        return true;
+    }
+
+    void ProjectileStore::RemoveAt(uint32_t index)
+    {
+        // Swap and pop every buffer, projectile order is not meaningful
+        const uint32_t lastIndex = aznumeric_cast<uint32_t>(m_positions.size() - 1);
+        if (index != lastIndex)
+        {
+            m_positions[index] = m_positions[lastIndex];
+            m_velocities[index] = m_velocities[lastIndex];
+            m_lifetimes[index] = m_lifetimes[lastIndex];
+            m_ownerIds[index] = m_ownerIds[lastIndex];
+            m_gatherParams[index] = m_gatherParams[lastIndex];
+            m_listeners[index] = m_listeners[lastIndex];
+            m_userData[index] = m_userData[lastIndex];
+            m_rewindOffsets[index] = m_rewindOffsets[lastIndex];
+        }
+
+        m_positions.pop_back();
+        m_velocities.pop_back();
+        m_lifetimes.pop_back();
+        m_ownerIds.pop_back();
+        m_gatherParams.pop_back();
+        m_listeners.pop_back();
+        m_userData.pop_back();
+        m_rewindOffsets.pop_back();
+    }
+
+#if MPS_DIAGNOSTICS
+    //! Listener used by the projectile benchmark, which only counts terminations.
+    class BenchmarkProjectileListener final
+        : public WeaponQueryListener
+    {
+    public:
+        void OnWeaponQueryComplete([[maybe_unused]] uint32_t userData, [[maybe_unused]] const ActivateEvent& eventData,
+            [[maybe_unused]] ShotResult result, [[maybe_unused]] const IntersectResults& results) override
+        {
+            ++m_terminatedCount;
+        }
+
+        uint32_t m_terminatedCount = 0;
+    };
+
+    static void sv_ProjectileStoreBenchmark(const AZ::ConsoleCommandContainer& arguments)
+    {
+        ProjectileStore* projectileStore = AZ::Interface<ProjectileStore>::Get();
+        if ((projectileStore == nullptr) || (SceneQuery::GetDefaultSceneHandle() == AzPhysics::InvalidSceneHandle))
+        {
+            AZLOG_WARN("sv_ProjectileStoreBenchmark requires an active projectile store and a loaded level");
+            return;
+        }
+
+        const uint32_t projectileCount = (arguments.size() > 0) ? aznumeric_cast<uint32_t>(AZStd::stoi(AZStd::string(arguments[0]))) : 5000;
+        const uint32_t tickCount = (arguments.size() > 1) ? aznumeric_cast<uint32_t>(AZStd::stoi(AZStd::string(arguments[1]))) : 600;
+        constexpr float tickSeconds = 1.0f / 60.0f;
+        constexpr float spawnRingRadius = 20.0f;
+        constexpr float spawnHeight = 1.5f;
+
+        // Slow, long range projectiles so that most of them stay alive for the whole benchmark
+        GatherParams gatherParams;
+        gatherParams.m_gatherShape = GatherShape::Point;
+        gatherParams.m_travelSpeed = 5.0f;
+        gatherParams.m_castDistance = gatherParams.m_travelSpeed * tickSeconds * (tickCount + 1);
+        gatherParams.m_bulletDrop = false;
+
+        BenchmarkProjectileListener listener;
+        for (uint32_t projectile = 0; projectile < projectileCount; ++projectile)
+        {
+            const float angle = AZ::Constants::TwoPi * projectile / projectileCount;
+            const AZ::Vector3 source(spawnRingRadius * AZStd::cos(angle), spawnRingRadius * AZStd::sin(angle), spawnHeight);
+            const AZ::Vector3 target = source + AZ::Vector3::CreateAxisZ();
+            projectileStore->Spawn(gatherParams, ActivateEvent{ AZ::Transform::CreateTranslation(source), target, Multiplayer::InvalidNetEntityId, Multiplayer::InvalidNetEntityId }, listener, 0);
+        }
+
+        const auto start = AZStd::chrono::steady_clock::now();
+        for (uint32_t tick = 0; tick < tickCount; ++tick)
+        {
+            projectileStore->Tick(tickSeconds);
+        }
+        const auto end = AZStd::chrono::steady_clock::now();
+
+        projectileStore->Remove(listener);
+
+        const float averageTickMs = aznumeric_cast<float>(AZStd::chrono::duration_cast<AZStd::chrono::microseconds>(end - start).count()) / (1000.0f * tickCount);
+        AZLOG_INFO("ProjectileStore benchmark, %u projectiles over %u ticks: %.3f ms per tick (%.3f ms budget at 60 Hz), %u terminated early",
+            projectileCount, tickCount, averageTickMs, tickSeconds * 1000.0f, listener.m_terminatedCount);
+    }
+    AZ_CONSOLEFREEFUNC(sv_ProjectileStoreBenchmark, AZ::ConsoleFunctorFlags::Null, "Steps a set of synthetic projectiles at 60 Hz and reports the average tick cost, optionally takes a projectile count and a tick count");
+#endif
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project. For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+
+#pragma once
+
+#include <Source/Weapons/WeaponQueryBatch.h>
+#include <AzCore/EBus/ScheduledEvent.h>
+#include <AzCore/RTTI/RTTI.h>
+
+namespace MultiplayerSample
+{
+    //! @class ProjectileStore
+    //! @brief Simulates every live projectile in the process in a single loop per tick.
+    //! Projectiles are not entities, they are stored in structure-of-arrays buffers and swept against the world using the same
+    //! segmented ballistic path as multitrace shots. Remote simulations recreate projectiles from replicated weapon activations.
+    //! Projectiles are stepped on network time, those fired by a rewound input stay as far behind the host as that input was
+    //! for their whole flight so they hit what the shooter saw, the same way hitscan weapons are lag compensated.
+    class ProjectileStore
+    {
+    public:
+        AZ_RTTI(ProjectileStore, "{3F6D1B8A-9C42-4E7B-A5D0-6B2E8C1F7A94}");
+
+        ProjectileStore();
+        virtual ~ProjectileStore();
+
+        //! Spawns a new projectile travelling from the activate event's initial transform towards its target position.
+        //! @param gatherParams the gather parameters to sweep the projectile with, must remain valid until the projectile is removed
+        //! @param eventData    details of the activation the projectile was fired by
+        //! @param listener     the listener to notify once the projectile terminates
+        //! @param userData     caller provided value passed back to the listener
+        void Spawn(const GatherParams& gatherParams, const ActivateEvent& eventData, WeaponQueryListener& listener, uint32_t userData);
+
+        //! Removes all projectiles owned by the provided listener, must be called before a listener is destroyed.
+        //! @param listener the listener to remove projectiles for
+        void Remove(const WeaponQueryListener& listener);
+
+        //! Steps all live projectiles and notifies listeners of any projectiles that terminated.
+        //! Projectiles fired by a rewound input are stepped under their rewound time relative to the current host frame.
+        //! @param deltaTime the amount of time to step projectiles by
+        void Tick(float deltaTime);
+
+        //! Returns the number of live projectiles.
+        //! @return the number of live projectiles
+        uint32_t GetProjectileCount() const;
+
+        //! Returns the rewind synchronization counters accumulated by lag compensated projectiles since the store was created.
+        //! @return the rewind synchronization counters
+        const RewindSyncScope::Stats& GetRewindSyncStats() const;
+
+        //! Resets the rewind synchronization counters.
+        void ResetRewindSyncStats();
+
+    private:
+        //! How far behind the host a projectile is simulated, captured from the rewound state of the input that fired it.
+        struct RewindOffset
+        {
+            uint32_t m_frameOffset = 0;
+            AZ::TimeMs m_timeOffsetMs = AZ::Time::ZeroTimeMs;
+            float m_blendFactor = 1.0f;
+            AzNetworking::ConnectionId m_connectionId = AzNetworking::InvalidConnectionId;
+
+            bool operator==(const RewindOffset& rhs) const;
+            bool operator!=(const RewindOffset& rhs) const;
+            bool operator<(const RewindOffset& rhs) const; // Orders by every field operator== compares
+        };
+
+        void TickNetworkTime();
+        bool StepProjectile(uint32_t index, float deltaTime, const AZ::Vector3& gravity, AzPhysics::SceneHandle sceneHandle, RewindSyncScope* rewindSyncScope);
+        void RemoveAt(uint32_t index);
+
+        // Per projectile data
+        AZStd::vector<AZ::Vector3> m_positions;
+        AZStd::vector<AZ::Vector3> m_velocities;
+        AZStd::vector<float> m_lifetimes;
+        AZStd::vector<Multiplayer::NetEntityId> m_ownerIds;
+        AZStd::vector<const GatherParams*> m_gatherParams;
+        AZStd::vector<WeaponQueryListener*> m_listeners;
+        AZStd::vector<uint32_t> m_userData;
+        AZStd::vector<RewindOffset> m_rewindOffsets;
+
+        // Projectiles that terminated this tick, listeners are notified once stepping has completed
+        AZStd::vector<ActivateEvent> m_terminatedEvents;
+        AZStd::vector<WeaponQueryListener*> m_terminatedListeners;
+        AZStd::vector<uint32_t> m_terminatedUserData;
+        AZStd::vector<IntersectResults> m_terminatedResults; // Grows to the high water mark, reused across ticks
+        AZStd::vector<uint32_t> m_terminatedIndices;
+        AZStd::vector<uint32_t> m_sortedIndices;
+
+        IntersectResults m_intersectResults;
+        NetEntityIdSet m_filteredNetEntityIds;
+        Multiplayer::NetEntityId m_filteredOwnerId = Multiplayer::InvalidNetEntityId;
+        RewindSyncScope::Stats m_rewindSyncStats;
+
+        // Unaltered network time of the last scheduled tick, rewind offsets are measured against it
+        Multiplayer::HostFrameId m_tickFrameId = Multiplayer::InvalidHostFrameId;
+        AZ::TimeMs m_tickTimeMs = AZ::Time::ZeroTimeMs;
+
+        AZ::ScheduledEvent m_tickEvent{ [this]()
+        {
+            TickNetworkTime();
+        }, AZ::Name("ProjectileStoreTick") };
+    };
+}
@@ -6,6 +6,9 @@
  */
 
 #include <Source/Weapons/ProjectileWeapon.h>
+#include <Source/Weapons/ProjectileStore.h>
+#include <AzCore/Interface/Interface.h>
+#include <Multiplayer/Components/NetBindComponent.h>
 
 namespace MultiplayerSample
 {
@@ -15,19 +18,59 @@ namespace MultiplayerSample
         ;
     }
 
+    ProjectileWeapon::~ProjectileWeapon()
+    {
+        if (ProjectileStore* projectileStore = AZ::Interface<ProjectileStore>::Get())
+        {
+            projectileStore->Remove(*this);
+        }
+    }
+
     void ProjectileWeapon::Activate
     (
-        [[maybe_unused]] WeaponState& weaponState,
+        WeaponState& weaponState,
         [[maybe_unused]] const Multiplayer::ConstNetworkEntityHandle weaponOwner,
-        [[maybe_unused]] ActivateEvent& eventData,
-        [[maybe_unused]] bool validateActivation
+        ActivateEvent& eventData,
+        bool validateActivation
     )
     {
-        ; // need to port this code
+        if (ActivateInternal(weaponState, validateActivation))
+        {
+            m_weaponListener.OnWeaponActivate(WeaponActivationInfo(*this, eventData));
+
+            // Simulated proxies hold their projectile as an active shot until the next tick, where their level of detail
+            // decides whether it is spawned into the store, reduced to its endpoint or dropped
+            if (m_owningEntity.Exists() && (m_owningEntity.GetNetBindComponent()->GetNetEntityRole() == Multiplayer::NetEntityRole::Client))
+            {
+                if (weaponState.m_activeShots.size() < weaponState.m_activeShots.max_size())
+                {
+                    weaponState.m_activeShots.emplace_back(ActiveShot{ eventData.m_initialTransform, eventData.m_targetPosition, LifetimeSec{ 0.0f } });
+                }
+                return;
+            }
+
+            // The store is not rolled back, so a corrected input that is replayed must not spawn the projectile it already fired a second time
+            const bool isReprocessingInput = m_owningEntity.Exists() && m_owningEntity.GetNetBindComponent()->IsReprocessingInput();
+            ProjectileStore* projectileStore = AZ::Interface<ProjectileStore>::Get();
+            if ((projectileStore != nullptr) && !isReprocessingInput)
+            {
+                projectileStore->Spawn(m_weaponParams.m_gatherParams, eventData, *this, InstantGatherUserData);
+            }
+        }
     }
 
-    void ProjectileWeapon::TickActiveShots([[maybe_unused]] WeaponState& weaponState, [[maybe_unused]] float deltaTime)
+    void ProjectileWeapon::TickActiveShots(WeaponState& weaponState, [[maybe_unused]] float deltaTime)
     {
-        ; // no-op, projectiles spawn as individual entities that tick themselves..  if a game does client steered projectiles then this pattern may need to change
+        // Only simulated proxies hold active shots, fully simulated ones are spawned into the store which steps every projectile together
+        ProjectileStore* projectileStore = AZ::Interface<ProjectileStore>::Get();
+        for (const ActiveShot& activeShot : weaponState.m_activeShots)
+        {
+            if (projectileStore != nullptr)
+            {
+                const ActivateEvent eventData{ activeShot.m_initialTransform, activeShot.m_targetPosition, m_owningEntity.GetNetEntityId(), Multiplayer::InvalidNetEntityId };
+                projectileStore->Spawn(m_weaponParams.m_gatherParams, eventData, *this, InstantGatherUserData);
+            }
+        }
+        weaponState.m_activeShots.clear();
     }
 }
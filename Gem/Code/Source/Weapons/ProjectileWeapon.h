@@ -12,7 +12,7 @@
 namespace MultiplayerSample
 {
     //! @class ProjectileWeapon
-    //! @brief Server-side weapon class for projectile-based weapons.
+    //! @brief Weapon class for projectile-based weapons, projectiles are simulated by the ProjectileStore rather than as entities.
     class ProjectileWeapon final
         : public BaseWeapon
     {
@@ -21,7 +21,7 @@ namespace MultiplayerSample
         //! Constructor.
         //! @param constructParams required construction parameters for the weapon instance
         ProjectileWeapon(const ConstructParams& constructParams);
-        ~ProjectileWeapon() override = default;
+        ~ProjectileWeapon() override;
 
     private:
 
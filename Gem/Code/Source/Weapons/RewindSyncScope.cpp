@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project. For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+
+#include <Source/Weapons/RewindSyncScope.h>
+#include <AzCore/Console/IConsole.h>
+#include <Multiplayer/NetworkTime/INetworkTime.h>
+
+namespace MultiplayerSample
+{
+    AZ_CVAR(bool, sv_RewindSyncCoalescing, true, nullptr, AZ::ConsoleFunctorFlags::Null, "If true, batched weapon queries skip synchronizing bounds that have already been synchronized under the same rewind state");
+
+    RewindSyncScope::RewindSyncScope(Stats& stats)
+        : m_stats(stats)
+    {
+        ;
+    }
+
+    void RewindSyncScope::SyncEntitiesToRewindState(const AZ::Aabb& bounds)
+    {
+        ++m_stats.m_requestedSyncs;
+
+        if (sv_RewindSyncCoalescing)
+        {
+            for (const AZ::Aabb& syncedRegion : m_syncedRegions)
+            {
+                if (syncedRegion.Contains(bounds))
+                {
+                    ++m_stats.m_skippedSyncs;
+                    return;
+                }
+            }
+        }
+
+        // Only the requested bounds are synchronized, regions already synchronized are never synchronized again
+        ++m_stats.m_performedSyncs;
+        Multiplayer::GetNetworkTime()->SyncEntitiesToRewindState(bounds);
+        if (m_syncedRegions.size() < m_syncedRegions.capacity())
+        {
+            m_syncedRegions.push_back(bounds);
+        }
+    }
+}
@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project. For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+
+#pragma once
+
+#include <AzCore/Math/Aabb.h>
+#include <AzCore/std/containers/fixed_vector.h>
+
+namespace MultiplayerSample
+{
+    //! @class RewindSyncScope
+    //! @brief Coalesces rewind synchronization for a group of weapon queries executed under a single rewind state.
+    //! Each synchronized region is tracked on its own, queries whose bounds are already covered by one of them skip
+    //! synchronization entirely and all other queries only synchronize their own bounds. A scope must not outlive the
+    //! rewind state it was opened under.
+    class RewindSyncScope
+    {
+    public:
+        //! Counters describing how many synchronizations were requested and how many were actually performed.
+        struct Stats
+        {
+            uint64_t m_requestedSyncs = 0;
+            uint64_t m_performedSyncs = 0;
+            uint64_t m_skippedSyncs = 0;
+        };
+
+        //! Constructor.
+        //! @param stats the counters to accumulate into, must outlive the scope
+        explicit RewindSyncScope(Stats& stats);
+
+        //! Ensures all rewindable entities within the provided bounds are synchronized to the current rewind state.
+        //! @param bounds the world space bounds that must be synchronized
+        void SyncEntitiesToRewindState(const AZ::Aabb& bounds);
+
+    private:
+        static constexpr uint32_t MaxSyncedRegions = 32;
+
+        // Do not allow copying or assignment
+        RewindSyncScope(const RewindSyncScope&) = delete;
+        RewindSyncScope& operator =(const RewindSyncScope&) = delete;
+
+        AZStd::fixed_vector<AZ::Aabb, MaxSyncedRegions> m_syncedRegions; // Regions are kept separate, their union may cover space that was never synchronized
+        Stats& m_stats;
+    };
+}
@@ -6,6 +6,14 @@
  */
 
 #include <Source/Weapons/SceneQuery.h>
+#include <Source/MultiplayerSampleTypes.h>
+#include <Source/Weapons/SceneQueryHitBuffer.h>
+#include <Source/Weapons/SceneQueryShapeCache.h>
+#include <Source/Weapons/SimulatedBodyNetData.h>
+#include <Source/Weapons/SurfaceTypeRegistry.h>
+#include <AzCore/Console/IConsole.h>
+#include <AzCore/Console/ILogger.h>
+#include <AzCore/std/chrono/chrono.h>
 #include <AzFramework/Physics/Common/PhysicsSimulatedBody.h>
 #include <AzFramework/Physics/ShapeConfiguration.h>
 #include <AzFramework/Physics/PhysicsScene.h>
@@ -21,6 +29,12 @@ namespace MultiplayerSample
     {
         static AZStd::shared_ptr<Physics::ShapeConfiguration> GatherShapeToPhysicsShape(const GatherShape& gatherShape, const IntersectFilter& filter)
         {
+            // Prefer interned shapes, AzPhysics scene queries only read the shape configuration
+            if (SceneQueryShapeCache* shapeCache = GetSceneQueryShapeCache())
+            {
+                return shapeCache->GetShapeConfiguration(gatherShape, filter.m_shapeConfiguration);
+            }
+
             if (gatherShape == GatherShape::Point)
             {
                 // Point shape generally means a raycast, but we fall back to a small sphere in case if Overlap with Point type is requested.
@@ -47,26 +61,75 @@ namespace MultiplayerSample
             return nullptr;
         }
 
-        static void CollectHits(AzPhysics::SceneQueryHits& result, IntersectResults& outResults, const AZ::Vector3& defaultPosition, const AZ::Vector3& defaultNormal)
+        static Multiplayer::NetEntityId GetBodyNetEntityId(AzPhysics::SceneHandle sceneHandle, const AzPhysics::SceneQueryHit& hit,
+            const SimulatedBodyNetData* simulatedBodyNetData, Multiplayer::INetworkEntityManager* networkEntityManager)
+        {
+            BodyNetData bodyNetData;
+            if ((simulatedBodyNetData != nullptr) && simulatedBodyNetData->FindBodyNetData(sceneHandle, hit.m_bodyHandle, bodyNetData))
+            {
+                return bodyNetData.m_netEntityId;
+            }
+            return networkEntityManager->GetNetEntityIdById(hit.m_entityId);
+        }
+
+        static void CollectHits(AzPhysics::SceneHandle sceneHandle, AzPhysics::SceneQueryHits& result, IntersectResults& outResults, const AZ::Vector3& defaultPosition, const AZ::Vector3& defaultNormal)
         {
             auto* networkEntityManager = AZ::Interface<Multiplayer::INetworkEntityManager>::Get();
             AZ_Assert(networkEntityManager, "Multiplayer entity manager must be initialized");
 
+            const SimulatedBodyNetData* simulatedBodyNetData = GetSimulatedBodyNetData();
+            SurfaceTypeRegistry* surfaceTypeRegistry = GetSurfaceTypeRegistry();
+
             for (const AzPhysics::SceneQueryHit& hit : result.m_hits)
             {
-                IntersectResult intersectResult;
+                if (outResults.size() >= outResults.capacity())
+                {
+                    // Results are fixed capacity, additional hits are dropped rather than allocating
+                    break;
+                }
+
+                IntersectResult& intersectResult = outResults.emplace_back();
 
                 // Certain queries may return zero vectors if the hit position and normal can't easily be determined
                 // Use defaults if we detect zero vectors coming out of the scene query results
                 intersectResult.m_position = (hit.m_position.GetLengthSq() > AZ::Constants::Tolerance) ? hit.m_position : defaultPosition;
                 intersectResult.m_normal = (hit.m_normal.GetLengthSq() > AZ::Constants::Tolerance) ? hit.m_normal : defaultNormal;
-                intersectResult.m_materialName = hit.m_physicsMaterialId.ToString<AZStd::string>();
-                intersectResult.m_netEntityId = networkEntityManager->GetNetEntityIdById(hit.m_entityId);
-                outResults.emplace_back(intersectResult);
+                intersectResult.m_surfaceIndex = (surfaceTypeRegistry != nullptr) ? surfaceTypeRegistry->GetSurfaceIndex(hit.m_physicsMaterialId) : DefaultSurfaceIndex;
+                intersectResult.m_netEntityId = GetBodyNetEntityId(sceneHandle, hit, simulatedBodyNetData, networkEntityManager);
+            }
+        }
+
+        AzPhysics::SceneHandle GetDefaultSceneHandle()
+        {
+            if (SceneQueryShapeCache* shapeCache = GetSceneQueryShapeCache())
+            {
+                return shapeCache->GetSceneHandle();
             }
+
+            auto* sceneInterface = AZ::Interface<AzPhysics::SceneInterface>::Get();
+            AZ_Assert(sceneInterface, "Physics system must be initialized");
+            return sceneInterface->GetSceneHandle(AzPhysics::DefaultPhysicsSceneName);
+        }
+
+        AZ::Aabb GetRewindBounds(const IntersectFilter& filter)
+        {
+            const AZ::Vector3 minBound = filter.m_initialPose.GetTranslation().GetMin(filter.m_initialPose.GetTranslation() + filter.m_sweep);
+            const AZ::Vector3 maxBound = filter.m_initialPose.GetTranslation().GetMax(filter.m_initialPose.GetTranslation() + filter.m_sweep);
+            return AZ::Aabb::CreateFromMinMax(minBound, maxBound);
         }
 
         size_t WorldIntersect(const GatherShape& intersectShape, const IntersectFilter& filter, IntersectResults& outResults)
+        {
+            const AzPhysics::SceneHandle sceneHandle = GetDefaultSceneHandle();
+            AZ_Assert(sceneHandle != AzPhysics::InvalidSceneHandle, "Default Physics world must be created");
+
+            // Ensure any entities that we might interact with are properly synchronized to their rewind state
+            Multiplayer::GetNetworkTime()->SyncEntitiesToRewindState(GetRewindBounds(filter));
+
+            return WorldIntersect(sceneHandle, intersectShape, filter, outResults);
+        }
+
+        size_t WorldIntersect(AzPhysics::SceneHandle sceneHandle, const GatherShape& intersectShape, const IntersectFilter& filter, IntersectResults& outResults)
         {
             AZ_Assert(intersectShape == GatherShape::Point || filter.m_shapeConfiguration != nullptr,
                 "Shape configuration must be provided for shape casts and overlap requests");
@@ -74,15 +137,36 @@ namespace MultiplayerSample
             auto* sceneInterface = AZ::Interface<AzPhysics::SceneInterface>::Get();
             AZ_Assert(sceneInterface, "Physics system must be initialized");
 
-            AzPhysics::SceneHandle sceneHandle = sceneInterface->GetSceneHandle(AzPhysics::DefaultPhysicsSceneName);
-            AZ_Assert(sceneHandle != AzPhysics::InvalidSceneHandle, "Default Physics world must be created");
-
             auto* networkEntityManager = AZ::Interface<Multiplayer::INetworkEntityManager>::Get();
             AZ_Assert(networkEntityManager, "Multiplayer entity manager must be initialized");
 
+            const SimulatedBodyNetData* simulatedBodyNetData = GetSimulatedBodyNetData();
+
             auto ignoreEntitiesFilterCallback =
-                [&filter, networkEntityManager](const AzPhysics::SimulatedBody* body, [[maybe_unused]] const Physics::Shape* shape)
+                [&filter, networkEntityManager, simulatedBodyNetData](const AzPhysics::SimulatedBody* body, [[maybe_unused]] const Physics::Shape* shape)
             {
+                if (simulatedBodyNetData != nullptr)
+                {
+                    const BodyNetData bodyNetData = simulatedBodyNetData->GetBodyNetData(*body);
+
+                    // Exclude bodies from another rewind frame, only networked dynamic bodies are ever rewound
+                    if (bodyNetData.m_rewindableHitVolume
+                        && (filter.m_rewindFrameId != Multiplayer::InvalidHostFrameId)
+                        && (body->GetFrameId() != AzPhysics::SimulatedBody::UndefinedFrameId)
+                        && (body->GetFrameId() != static_cast<uint32_t>(filter.m_rewindFrameId)))
+                    {
+                        return AzPhysics::SceneQuery::QueryHitType::None;
+                    }
+
+                    // Ignore the body from the filtered net entities
+                    if ((bodyNetData.m_netEntityId != Multiplayer::InvalidNetEntityId) && (filter.m_filteredNetEntityIds.count(bodyNetData.m_netEntityId) == 1))
+                    {
+                        return AzPhysics::SceneQuery::QueryHitType::None;
+                    }
+
+                    return AzPhysics::SceneQuery::QueryHitType::Touch;
+                }
+
                 // Exclude bodies from another rewind frame
                 if (filter.m_rewindFrameId != Multiplayer::InvalidHostFrameId 
                     && (body->GetFrameId() != AzPhysics::SimulatedBody::UndefinedFrameId)
@@ -105,19 +189,19 @@ namespace MultiplayerSample
                 return AzPhysics::SceneQuery::QueryHitType::Touch;
             };
 
+            // Query into the shared hit buffer so that repeated queries don't allocate their results
+            SceneQueryHitBuffer* hitBuffer = AZ::Interface<SceneQueryHitBuffer>::Get();
+            AzPhysics::SceneQueryHits localHits;
+            AzPhysics::SceneQueryHits& hits = (hitBuffer != nullptr) ? hitBuffer->GetHits() : localHits;
+
             const float maxSweepDistance = filter.m_sweep.GetLength();
             const bool shouldDoOverlap = (maxSweepDistance == 0);
 
-            // Ensure any entities that we might interact with are properly synchronized to their rewind state
-            const AZ::Vector3 minBound = filter.m_initialPose.GetTranslation().GetMin(filter.m_initialPose.GetTranslation() + filter.m_sweep);
-            const AZ::Vector3 maxBound = filter.m_initialPose.GetTranslation().GetMax(filter.m_initialPose.GetTranslation() + filter.m_sweep);
-            const AZ::Aabb rewindBounds = AZ::Aabb::CreateFromMinMax(minBound, maxBound);
-            Multiplayer::GetNetworkTime()->SyncEntitiesToRewindState(rewindBounds);
-
             if (shouldDoOverlap)
             {
                 // Interset queries with 0 length are considered Overlaps
                 AzPhysics::OverlapRequest request;
+                request.m_maxResults = MaxHitEntities;
                 request.m_collisionGroup = filter.m_collisionGroup;
                 request.m_pose = filter.m_initialPose;
                 request.m_shapeConfiguration = GatherShapeToPhysicsShape(intersectShape, filter);
@@ -130,13 +214,14 @@ namespace MultiplayerSample
                     return ignoreEntitiesFilterCallback(body, shape) == AzPhysics::SceneQuery::QueryHitType::None ? false : true;
                 };
 
-                AzPhysics::SceneQueryHits result = sceneInterface->QueryScene(sceneHandle, &request);
-                CollectHits(result, outResults, filter.m_initialPose.GetTranslation(), AZ::Vector3::CreateZero());
+                sceneInterface->QueryScene(sceneHandle, &request, hits);
+                CollectHits(sceneHandle, hits, outResults, filter.m_initialPose.GetTranslation(), AZ::Vector3::CreateZero());
             }
             else if (intersectShape == GatherShape::Point)
             {
                 // Perform raycast
                 AzPhysics::RayCastRequest request;
+                request.m_maxResults = MaxHitEntities;
                 request.m_collisionGroup = filter.m_collisionGroup;
                 request.m_start = filter.m_initialPose.GetTranslation();
                 request.m_direction = filter.m_sweep.GetNormalized();
@@ -145,13 +230,14 @@ namespace MultiplayerSample
                 request.m_filterCallback = AZStd::move(ignoreEntitiesFilterCallback);
                 request.m_reportMultipleHits = (filter.m_intersectMultiple == HitMultiple::Yes);
 
-                AzPhysics::SceneQueryHits result = sceneInterface->QueryScene(sceneHandle, &request);
-                CollectHits(result, outResults, filter.m_initialPose.GetTranslation(), -request.m_direction);
+                sceneInterface->QueryScene(sceneHandle, &request, hits);
+                CollectHits(sceneHandle, hits, outResults, filter.m_initialPose.GetTranslation(), -request.m_direction);
             }
             else
             {
                 // Perform shapecast
                 AzPhysics::ShapeCastRequest request;
+                request.m_maxResults = MaxHitEntities;
                 request.m_collisionGroup = filter.m_collisionGroup;
                 request.m_start = filter.m_initialPose;
                 request.m_direction = filter.m_sweep.GetNormalized();
@@ -161,11 +247,63 @@ namespace MultiplayerSample
                 request.m_filterCallback = AZStd::move(ignoreEntitiesFilterCallback);
                 request.m_reportMultipleHits = (filter.m_intersectMultiple == HitMultiple::Yes);
 
-                AzPhysics::SceneQueryHits result = sceneInterface->QueryScene(sceneHandle, &request);
-                CollectHits(result, outResults, filter.m_initialPose.GetTranslation(), -request.m_direction);
+                sceneInterface->QueryScene(sceneHandle, &request, hits);
+                CollectHits(sceneHandle, hits, outResults, filter.m_initialPose.GetTranslation(), -request.m_direction);
             }
             
             return outResults.size();
         }
+
+#if MPS_DIAGNOSTICS
+        static void sv_CollectHitsBenchmark(const AZ::ConsoleCommandContainer& arguments)
+        {
+            if (AZ::Interface<Multiplayer::INetworkEntityManager>::Get() == nullptr)
+            {
+                AZLOG_WARN("sv_CollectHitsBenchmark requires an active multiplayer entity manager");
+                return;
+            }
+
+            const uint32_t iterationCount = arguments.empty() ? 10000 : aznumeric_cast<uint32_t>(AZStd::stoi(AZStd::string(arguments.front())));
+            constexpr uint32_t materialCount = 4;
+
+            // A full hit buffer spread across a few materials, as a multi-hit shot through a crowded area would return
+            AzPhysics::SceneQueryHits hits;
+            hits.m_hits.resize(MaxHitEntities);
+            for (uint32_t hitIndex = 0; hitIndex < MaxHitEntities; ++hitIndex)
+            {
+                AzPhysics::SceneQueryHit& hit = hits.m_hits[hitIndex];
+                hit.m_position = AZ::Vector3(aznumeric_cast<float>(hitIndex), 0.0f, 0.0f);
+                hit.m_normal = AZ::Vector3::CreateAxisZ();
+                hit.m_physicsMaterialId = (hitIndex < materialCount) ? Physics::MaterialId::Create() : hits.m_hits[hitIndex % materialCount].m_physicsMaterialId;
+            }
+
+            IntersectResults results;
+            const auto start = AZStd::chrono::steady_clock::now();
+            for (uint32_t iteration = 0; iteration < iterationCount; ++iteration)
+            {
+                results.clear();
+                CollectHits(AzPhysics::InvalidSceneHandle, hits, results, AZ::Vector3::CreateZero(), AZ::Vector3::CreateAxisZ());
+            }
+            const auto collectEnd = AZStd::chrono::steady_clock::now();
+
+            // Reference cost of the per-hit material name conversion CollectHits used to perform
+            size_t nameLength = 0;
+            for (uint32_t iteration = 0; iteration < iterationCount; ++iteration)
+            {
+                for (const AzPhysics::SceneQueryHit& hit : hits.m_hits)
+                {
+                    const AZ::Name materialName(hit.m_physicsMaterialId.ToString<AZStd::string>());
+                    nameLength += materialName.GetStringView().size();
+                }
+            }
+            const auto namesEnd = AZStd::chrono::steady_clock::now();
+
+            const float collectUs = aznumeric_cast<float>(AZStd::chrono::duration_cast<AZStd::chrono::microseconds>(collectEnd - start).count());
+            const float namesUs = aznumeric_cast<float>(AZStd::chrono::duration_cast<AZStd::chrono::microseconds>(namesEnd - collectEnd).count());
+            AZLOG_INFO("CollectHits benchmark, %u hits over %u iterations: %.3f us per call, material name conversion alone was %.3f us per call (%zu chars)",
+                MaxHitEntities, iterationCount, collectUs / iterationCount, namesUs / iterationCount, nameLength);
+        }
+        AZ_CONSOLEFREEFUNC(sv_CollectHitsBenchmark, AZ::ConsoleFunctorFlags::Null, "Converts a full buffer of synthetic scene query hits into intersect results and reports the per-call cost, optionally takes an iteration count");
+#endif
     }
 }
@@ -8,6 +8,8 @@
 #pragma once
 
 #include <Source/Weapons/WeaponGathers.h>
+#include <AzCore/Math/Aabb.h>
+#include <AzFramework/Physics/Common/PhysicsTypes.h>
 
 namespace MultiplayerSample
 {
@@ -19,5 +21,23 @@ namespace MultiplayerSample
         //! @param a_OutResults result structure to store all relevant hits
         //! @return the number of hits stored in the result structure
         size_t WorldIntersect(const GatherShape& intersectShape, const IntersectFilter& filter, IntersectResults& outResults);
+
+        //! Performs a world intersection query against an already resolved physics scene.
+        //! Unlike the overload above, this does not synchronize rewindable entities, callers must have already done so using GetRewindBounds.
+        //! @param sceneHandle    the physics scene to query
+        //! @param intersectShape a convex shape to use for the intersection test (point, box, sphere, capsule)
+        //! @param filter parameters controlling whether the query is swept, how many entities to gather, world positions, and filtering information
+        //! @param outResults result structure to store all relevant hits
+        //! @return the number of hits stored in the result structure
+        size_t WorldIntersect(AzPhysics::SceneHandle sceneHandle, const GatherShape& intersectShape, const IntersectFilter& filter, IntersectResults& outResults);
+
+        //! Returns the default physics scene handle, using the cached handle when the scene query shape cache is active.
+        //! @return the default physics scene handle, or InvalidSceneHandle if the default scene does not exist
+        AzPhysics::SceneHandle GetDefaultSceneHandle();
+
+        //! Returns the bounds that must be synchronized to their rewind state prior to performing the provided query.
+        //! @param filter the filter of the query to compute bounds for
+        //! @return the world space bounds of the query sweep
+        AZ::Aabb GetRewindBounds(const IntersectFilter& filter);
     }
 }
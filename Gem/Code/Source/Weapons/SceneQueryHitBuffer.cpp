@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project. For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+
+#include <Source/Weapons/SceneQueryHitBuffer.h>
+#include <Source/Weapons/WeaponTypes.h>
+#include <AzCore/Interface/Interface.h>
+
+namespace MultiplayerSample
+{
+    SceneQueryHitBuffer::SceneQueryHitBuffer()
+    {
+        AZ::Interface<SceneQueryHitBuffer>::Register(this);
+    }
+
+    SceneQueryHitBuffer::~SceneQueryHitBuffer()
+    {
+        AZ::Interface<SceneQueryHitBuffer>::Unregister(this);
+    }
+
+    AzPhysics::SceneQueryHits& SceneQueryHitBuffer::GetHits()
+    {
+        if (m_hits.m_hits.capacity() != m_capacity)
+        {
+            ++m_allocationCount;
+        }
+
+        m_hits.m_hits.clear();
+        if (m_hits.m_hits.capacity() < MaxHitEntities)
+        {
+            m_hits.m_hits.reserve(MaxHitEntities);
+            ++m_allocationCount;
+        }
+        m_capacity = m_hits.m_hits.capacity();
+        return m_hits;
+    }
+
+    uint32_t SceneQueryHitBuffer::GetAllocationCount() const
+    {
+        // Also count a buffer the physics scene grew during the last query
+        return m_allocationCount + ((m_hits.m_hits.capacity() != m_capacity) ? 1 : 0);
+    }
+}
@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project. For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+
+#pragma once
+
+#include <AzCore/RTTI/RTTI.h>
+#include <AzFramework/Physics/Common/PhysicsSceneQueries.h>
+
+namespace MultiplayerSample
+{
+    //! @class SceneQueryHitBuffer
+    //! @brief Owns the hit buffer weapon scene queries write their physics results into, so that repeated queries don't allocate them.
+    //! Weapon scene queries only run on the main thread, the contents of the buffer are only valid until the next query.
+    class SceneQueryHitBuffer
+    {
+    public:
+        AZ_RTTI(SceneQueryHitBuffer, "{C4E2A8F1-7B3D-4E96-8A05-1D6F9B3C2E74}");
+
+        SceneQueryHitBuffer();
+        virtual ~SceneQueryHitBuffer();
+
+        //! Returns the hit buffer, cleared and with room for MaxHitEntities hits.
+        //! @return the cleared hit buffer
+        AzPhysics::SceneQueryHits& GetHits();
+
+        //! Returns the number of times the hit buffer has been allocated or grown since it was created.
+        //! @return the number of hit buffer allocations
+        uint32_t GetAllocationCount() const;
+
+    private:
+        AzPhysics::SceneQueryHits m_hits;
+        size_t m_capacity = 0; // Capacity after the last query, a change means the physics scene grew the buffer
+        uint32_t m_allocationCount = 0;
+    };
+}
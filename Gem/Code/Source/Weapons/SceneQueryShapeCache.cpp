@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project. For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+
+#include <Source/Weapons/SceneQueryShapeCache.h>
+#include <Source/Weapons/SceneQuery.h>
+#include <Source/MultiplayerSampleTypes.h>
+#include <AzCore/Console/IConsole.h>
+#include <AzCore/Console/ILogger.h>
+#include <AzCore/Interface/Interface.h>
+#include <AzCore/std/chrono/chrono.h>
+#include <AzFramework/Physics/PhysicsScene.h>
+#include <AzFramework/Physics/PhysicsSystem.h>
+#include <AzFramework/Physics/ShapeConfiguration.h>
+
+namespace MultiplayerSample
+{
+    AZ_CVAR(bool, bg_SceneQueryShapeCaching, true, nullptr, AZ::ConsoleFunctorFlags::Null, "If true, weapon scene queries reuse interned shape configurations and a cached physics scene handle");
+
+    bool SceneQueryShapeCache::ShapeKey::operator==(const ShapeKey& rhs) const
+    {
+        return m_gatherShape == rhs.m_gatherShape
+            && m_extents.IsClose(rhs.m_extents)
+            && m_scale.IsClose(rhs.m_scale);
+    }
+
+    SceneQueryShapeCache::SceneQueryShapeCache()
+        : m_sceneRemovedHandler([this](AzPhysics::SceneHandle sceneHandle)
+        {
+            if (sceneHandle == m_sceneHandle)
+            {
+                m_sceneHandle = AzPhysics::InvalidSceneHandle;
+            }
+        })
+    {
+        AZ::Interface<SceneQueryShapeCache>::Register(this);
+    }
+
+    SceneQueryShapeCache::~SceneQueryShapeCache()
+    {
+        m_sceneRemovedHandler.Disconnect();
+        AZ::Interface<SceneQueryShapeCache>::Unregister(this);
+    }
+
+    AzPhysics::SceneHandle SceneQueryShapeCache::GetSceneHandle()
+    {
+        if (m_sceneHandle == AzPhysics::InvalidSceneHandle)
+        {
+            auto* sceneInterface = AZ::Interface<AzPhysics::SceneInterface>::Get();
+            AZ_Assert(sceneInterface, "Physics system must be initialized");
+            m_sceneHandle = sceneInterface->GetSceneHandle(AzPhysics::DefaultPhysicsSceneName);
+
+            // The physics system may come up after us, so hook scene removal the first time we resolve a scene
+            auto* physicsSystem = AZ::Interface<AzPhysics::SystemInterface>::Get();
+            if ((m_sceneHandle != AzPhysics::InvalidSceneHandle) && (physicsSystem != nullptr) && !m_sceneRemovedHandler.IsConnected())
+            {
+                physicsSystem->RegisterSceneRemovedEvent(m_sceneRemovedHandler);
+            }
+        }
+        return m_sceneHandle;
+    }
+
+    const AZStd::shared_ptr<Physics::ShapeConfiguration>& SceneQueryShapeCache::GetShapeConfiguration(GatherShape gatherShape, const Physics::ShapeConfiguration* shapeConfiguration)
+    {
+        const ShapeKey shapeKey = MakeShapeKey(gatherShape, shapeConfiguration);
+        for (size_t shapeIndex = 0; shapeIndex < m_shapeKeys.size(); ++shapeIndex)
+        {
+            if (m_shapeKeys[shapeIndex] == shapeKey)
+            {
+                return m_shapes[shapeIndex];
+            }
+        }
+
+        ++m_shapeAllocationCount;
+        m_shapeKeys.push_back(shapeKey);
+        m_shapes.push_back(CreateShapeConfiguration(gatherShape, shapeConfiguration));
+        return m_shapes.back();
+    }
+
+    uint32_t SceneQueryShapeCache::GetShapeAllocationCount() const
+    {
+        return m_shapeAllocationCount;
+    }
+
+    SceneQueryShapeCache::ShapeKey SceneQueryShapeCache::MakeShapeKey(GatherShape gatherShape, const Physics::ShapeConfiguration* shapeConfiguration)
+    {
+        ShapeKey shapeKey;
+        shapeKey.m_gatherShape = gatherShape;
+
+        switch (gatherShape)
+        {
+        case GatherShape::Box:
+            shapeKey.m_extents = static_cast<const Physics::BoxShapeConfiguration*>(shapeConfiguration)->m_dimensions;
+            break;
+        case GatherShape::Sphere:
+            shapeKey.m_extents = AZ::Vector3(static_cast<const Physics::SphereShapeConfiguration*>(shapeConfiguration)->m_radius, 0.0f, 0.0f);
+            break;
+        case GatherShape::Capsule:
+        {
+            const Physics::CapsuleShapeConfiguration* capsule = static_cast<const Physics::CapsuleShapeConfiguration*>(shapeConfiguration);
+            shapeKey.m_extents = AZ::Vector3(capsule->m_height, capsule->m_radius, 0.0f);
+            break;
+        }
+        default:
+            // Points and unsupported shapes carry no extents
+            return shapeKey;
+        }
+
+        shapeKey.m_scale = shapeConfiguration->m_scale;
+        return shapeKey;
+    }
+
+    AZStd::shared_ptr<Physics::ShapeConfiguration> SceneQueryShapeCache::CreateShapeConfiguration(GatherShape gatherShape, const Physics::ShapeConfiguration* shapeConfiguration)
+    {
+        if (gatherShape == GatherShape::Point)
+        {
+            // Point shape generally means a raycast, but we fall back to a small sphere in case if Overlap with Point type is requested.
+            const float pointSphereSize = 0.01f;
+            return AZStd::make_shared<Physics::SphereShapeConfiguration>(pointSphereSize);
+        }
+
+        switch (gatherShape)
+        {
+        case GatherShape::Box:
+            AZ_Assert(shapeConfiguration->GetShapeType() == Physics::ShapeType::Box, "Shape configuration type must be Box");
+            return AZStd::make_shared<Physics::BoxShapeConfiguration>(*(azdynamic_cast<const Physics::BoxShapeConfiguration*>(shapeConfiguration)));
+        case GatherShape::Sphere:
+            AZ_Assert(shapeConfiguration->GetShapeType() == Physics::ShapeType::Sphere, "Shape configuration type must be Sphere");
+            return AZStd::make_shared<Physics::SphereShapeConfiguration>(*(azdynamic_cast<const Physics::SphereShapeConfiguration*>(shapeConfiguration)));
+        case GatherShape::Capsule:
+            AZ_Assert(shapeConfiguration->GetShapeType() == Physics::ShapeType::Capsule, "Shape configuration type must be Capsule");
+            return AZStd::make_shared<Physics::CapsuleShapeConfiguration>(*(azdynamic_cast<const Physics::CapsuleShapeConfiguration*>(shapeConfiguration)));
+        default:
+            AZ_Warning("", false, "Only box, sphere, and capsule conversions are supported.");
+        }
+
+        return nullptr;
+    }
+
+    SceneQueryShapeCache* GetSceneQueryShapeCache()
+    {
+        return bg_SceneQueryShapeCaching ? AZ::Interface<SceneQueryShapeCache>::Get() : nullptr;
+    }
+
+#if MPS_DIAGNOSTICS
+    static void bg_SceneQueryShapeCacheBenchmark(const AZ::ConsoleCommandContainer& arguments)
+    {
+        SceneQueryShapeCache* shapeCache = AZ::Interface<SceneQueryShapeCache>::Get();
+        if ((shapeCache == nullptr) || (shapeCache->GetSceneHandle() == AzPhysics::InvalidSceneHandle))
+        {
+            AZLOG_WARN("bg_SceneQueryShapeCacheBenchmark requires an active shape cache and a loaded level");
+            return;
+        }
+
+        const uint32_t iterationCount = arguments.empty() ? 10000 : aznumeric_cast<uint32_t>(AZStd::stoi(AZStd::string(arguments.front())));
+
+        GatherParams gatherParams;
+        const NetEntityIdSet filteredNetEntityIds;
+        const AZ::Vector3 source(0.0f, 0.0f, 1.5f);
+        const AZ::Vector3 target(0.0f, 50.0f, 1.5f);
+        const AZ::Transform sourceTransform = AZ::Transform::CreateLookAt(source, target);
+        IntersectResults results;
+
+        const bool wasCaching = bg_SceneQueryShapeCaching;
+        for (const GatherShape gatherShape : { GatherShape::Sphere, GatherShape::Box, GatherShape::Capsule })
+        {
+            gatherParams.m_gatherShape = gatherShape;
+            IntersectFilter filter(sourceTransform, target - source, AzPhysics::SceneQuery::QueryType::StaticAndDynamic, HitMultiple::No,
+                AzPhysics::CollisionGroup::All, filteredNetEntityIds, gatherParams.GetCurrentShapeConfiguration());
+
+            float elapsedUs[2] = {};
+            uint32_t steadyStateAllocations = 0;
+            for (const bool caching : { false, true })
+            {
+                bg_SceneQueryShapeCaching = caching;
+
+                // Warm up so that the first use of a shape isn't counted against the steady state
+                results.clear();
+                SceneQuery::WorldIntersect(gatherShape, filter, results);
+
+                const uint32_t allocationsBefore = shapeCache->GetShapeAllocationCount();
+                const auto start = AZStd::chrono::steady_clock::now();
+                for (uint32_t iteration = 0; iteration < iterationCount; ++iteration)
+                {
+                    results.clear();
+                    SceneQuery::WorldIntersect(gatherShape, filter, results);
+                }
+                const auto end = AZStd::chrono::steady_clock::now();
+                elapsedUs[caching] = aznumeric_cast<float>(AZStd::chrono::duration_cast<AZStd::chrono::microseconds>(end - start).count());
+
+                if (caching)
+                {
+                    steadyStateAllocations = shapeCache->GetShapeAllocationCount() - allocationsBefore;
+                }
+            }
+
+            AZLOG_INFO("SceneQueryShapeCache benchmark, %s: uncached %.3f us, cached %.3f us per query, %u steady state shape allocations",
+                GetEnumString(gatherShape), elapsedUs[0] / iterationCount, elapsedUs[1] / iterationCount, steadyStateAllocations);
+        }
+        bg_SceneQueryShapeCaching = wasCaching;
+    }
+    AZ_CONSOLEFREEFUNC(bg_SceneQueryShapeCacheBenchmark, AZ::ConsoleFunctorFlags::Null, "Compares cached and uncached sphere, box and capsule weapon scene queries against the loaded level, optionally takes an iteration count");
+#endif
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project. For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+
+#pragma once
+
+#include <Source/Weapons/WeaponTypes.h>
+#include <AzCore/RTTI/RTTI.h>
+#include <AzCore/std/containers/vector.h>
+#include <AzCore/std/smart_ptr/shared_ptr.h>
+#include <AzFramework/Physics/Common/PhysicsEvents.h>
+#include <AzFramework/Physics/Common/PhysicsTypes.h>
+
+namespace MultiplayerSample
+{
+    //! @class SceneQueryShapeCache
+    //! @brief Interns the shape configurations used by weapon scene queries and caches the default physics scene handle.
+    //! Weapons only ever use a handful of distinct shapes, so after the first query of each shape, scene queries no longer
+    //! allocate shape configurations or look up the physics scene by name. Runs on both clients and servers.
+    //! The uncached fallback still allocates a shape per query.
+    class SceneQueryShapeCache
+    {
+    public:
+        AZ_RTTI(SceneQueryShapeCache, "{8E5A7C2D-3B91-4F6A-9D1E-2C7B0F4A6E53}");
+
+        SceneQueryShapeCache();
+        virtual ~SceneQueryShapeCache();
+
+        //! Returns the default physics scene handle, the handle is resolved once and reset when the scene is removed on level unload.
+        //! @return the default physics scene handle, or InvalidSceneHandle if the default scene does not currently exist
+        AzPhysics::SceneHandle GetSceneHandle();
+
+        //! Returns a shared shape configuration equivalent to the provided gather shape, creating it the first time it's requested.
+        //! @param gatherShape        the gather shape to return a configuration for, points map to a small sphere
+        //! @param shapeConfiguration the configuration to match, ignored for points
+        //! @return the interned shape configuration, or nullptr if the gather shape is unsupported
+        const AZStd::shared_ptr<Physics::ShapeConfiguration>& GetShapeConfiguration(GatherShape gatherShape, const Physics::ShapeConfiguration* shapeConfiguration);
+
+        //! Returns the number of shape configurations allocated by this cache since it was created.
+        //! @return the number of shape configuration allocations
+        uint32_t GetShapeAllocationCount() const;
+
+    private:
+        //! Identifies a unique shape configuration, extents hold the box dimensions, sphere radius or capsule height and radius.
+        struct ShapeKey
+        {
+            GatherShape m_gatherShape = GatherShape::Point;
+            AZ::Vector3 m_extents = AZ::Vector3::CreateZero();
+            AZ::Vector3 m_scale = AZ::Vector3::CreateOne();
+
+            bool operator==(const ShapeKey& rhs) const;
+        };
+
+        static ShapeKey MakeShapeKey(GatherShape gatherShape, const Physics::ShapeConfiguration* shapeConfiguration);
+        static AZStd::shared_ptr<Physics::ShapeConfiguration> CreateShapeConfiguration(GatherShape gatherShape, const Physics::ShapeConfiguration* shapeConfiguration);
+
+        // Interned shapes, m_shapeKeys[N] describes m_shapes[N]
+        AZStd::vector<ShapeKey> m_shapeKeys;
+        AZStd::vector<AZStd::shared_ptr<Physics::ShapeConfiguration>> m_shapes;
+        uint32_t m_shapeAllocationCount = 0;
+
+        AzPhysics::SceneHandle m_sceneHandle = AzPhysics::InvalidSceneHandle;
+        AzPhysics::SystemEvents::OnSceneRemovedEvent::Handler m_sceneRemovedHandler;
+    };
+
+    //! Returns the scene query shape cache if one is active and caching is enabled.
+    //! @return the scene query shape cache, or nullptr if scene queries should create their own shapes
+    SceneQueryShapeCache* GetSceneQueryShapeCache();
+}
@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project. For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+
+#include <Source/Weapons/SimulatedBodyNetData.h>
+#include <Source/Weapons/SceneQuery.h>
+#include <Source/MultiplayerSampleTypes.h>
+#include <AzCore/Console/IConsole.h>
+#include <AzCore/Console/ILogger.h>
+#include <AzCore/Interface/Interface.h>
+#include <AzCore/std/chrono/chrono.h>
+#include <AzFramework/Physics/Common/PhysicsSimulatedBody.h>
+#include <AzFramework/Physics/PhysicsScene.h>
+#include <AzFramework/Physics/PhysicsSystem.h>
+#include <AzFramework/Physics/ShapeConfiguration.h>
+#include <AzFramework/Physics/SimulatedBodies/StaticRigidBody.h>
+#include <Multiplayer/IMultiplayer.h>
+#include <Multiplayer/NetworkEntity/INetworkEntityManager.h>
+
+namespace MultiplayerSample
+{
+    AZ_CVAR(bool, bg_SimulatedBodyNetData, true, nullptr, AZ::ConsoleFunctorFlags::Null, "If true, scene queries read the NetEntityId of physics bodies from an array indexed by body index instead of looking it up per candidate body");
+
+    SimulatedBodyNetData::SimulatedBodyNetData()
+        : m_bodyAddedHandler([this](AzPhysics::SceneHandle sceneHandle, AzPhysics::SimulatedBodyHandle bodyHandle)
+        {
+            OnSimulationBodyAdded(sceneHandle, bodyHandle);
+        })
+        , m_bodyRemovedHandler([this](AzPhysics::SceneHandle sceneHandle, AzPhysics::SimulatedBodyHandle bodyHandle)
+        {
+            OnSimulationBodyRemoved(sceneHandle, bodyHandle);
+        })
+        , m_sceneAddedHandler([this](AzPhysics::SceneHandle sceneHandle)
+        {
+            auto* sceneInterface = AZ::Interface<AzPhysics::SceneInterface>::Get();
+            if ((sceneInterface != nullptr) && (sceneInterface->GetSceneHandle(AzPhysics::DefaultPhysicsSceneName) == sceneHandle))
+            {
+                ConnectToScene(sceneHandle);
+            }
+        })
+        , m_sceneRemovedHandler([this](AzPhysics::SceneHandle sceneHandle)
+        {
+            if (sceneHandle == m_sceneHandle)
+            {
+                m_bodyAddedHandler.Disconnect();
+                m_bodyRemovedHandler.Disconnect();
+                m_sceneHandle = AzPhysics::InvalidSceneHandle;
+                m_bodies.clear();
+                m_bodyCount = 0;
+            }
+        })
+    {
+        AZ::Interface<SimulatedBodyNetData>::Register(this);
+
+        // The default scene is usually created before any session starts, otherwise connect once it's added
+        if (auto* physicsSystem = AZ::Interface<AzPhysics::SystemInterface>::Get())
+        {
+            physicsSystem->RegisterSceneAddedEvent(m_sceneAddedHandler);
+            physicsSystem->RegisterSceneRemovedEvent(m_sceneRemovedHandler);
+        }
+        if (auto* sceneInterface = AZ::Interface<AzPhysics::SceneInterface>::Get())
+        {
+            ConnectToScene(sceneInterface->GetSceneHandle(AzPhysics::DefaultPhysicsSceneName));
+        }
+    }
+
+    SimulatedBodyNetData::~SimulatedBodyNetData()
+    {
+        m_bodyAddedHandler.Disconnect();
+        m_bodyRemovedHandler.Disconnect();
+        m_sceneAddedHandler.Disconnect();
+        m_sceneRemovedHandler.Disconnect();
+        AZ::Interface<SimulatedBodyNetData>::Unregister(this);
+    }
+
+    BodyNetData SimulatedBodyNetData::GetBodyNetData(const AzPhysics::SimulatedBody& body) const
+    {
+        BodyNetData bodyNetData;
+        if (!FindBodyNetData(body.m_sceneOwner, body.m_bodyHandle, bodyNetData))
+        {
+            bodyNetData = LookupBodyNetData(body);
+        }
+        return bodyNetData;
+    }
+
+    bool SimulatedBodyNetData::FindBodyNetData(AzPhysics::SceneHandle sceneHandle, AzPhysics::SimulatedBodyHandle bodyHandle, BodyNetData& outBodyNetData) const
+    {
+        // Body indices are reused by the scene, the full handle tells a recorded body apart from a later body at the same index
+        const AzPhysics::SimulatedBodyIndex bodyIndex = AZStd::get<AzPhysics::HandleTypeIndex::Index>(bodyHandle);
+        if ((sceneHandle != m_sceneHandle) || (bodyIndex >= m_bodies.size()) || (m_bodies[bodyIndex].m_bodyHandle != bodyHandle))
+        {
+            return false;
+        }
+
+        outBodyNetData = m_bodies[bodyIndex].m_bodyNetData;
+        return true;
+    }
+
+    uint32_t SimulatedBodyNetData::GetBodyCount() const
+    {
+        return m_bodyCount;
+    }
+
+    BodyNetData SimulatedBodyNetData::LookupBodyNetData(const AzPhysics::SimulatedBody& body)
+    {
+        BodyNetData bodyNetData;
+        bodyNetData.m_netEntityId = Multiplayer::GetNetworkEntityManager()->GetNetEntityIdById(body.GetEntityId());
+        bodyNetData.m_rewindableHitVolume = (bodyNetData.m_netEntityId != Multiplayer::InvalidNetEntityId)
+            && !azrtti_istypeof<AzPhysics::StaticRigidBody>(&body);
+        return bodyNetData;
+    }
+
+    void SimulatedBodyNetData::ConnectToScene(AzPhysics::SceneHandle sceneHandle)
+    {
+        auto* sceneInterface = AZ::Interface<AzPhysics::SceneInterface>::Get();
+        if ((sceneHandle == m_sceneHandle) || (sceneHandle == AzPhysics::InvalidSceneHandle) || (sceneInterface == nullptr))
+        {
+            return;
+        }
+
+        m_bodyAddedHandler.Disconnect();
+        m_bodyRemovedHandler.Disconnect();
+        m_bodies.clear();
+        m_bodyCount = 0;
+        sceneInterface->RegisterSimulationBodyAddedHandler(sceneHandle, m_bodyAddedHandler);
+        sceneInterface->RegisterSimulationBodyRemovedHandler(sceneHandle, m_bodyRemovedHandler);
+        m_sceneHandle = sceneHandle;
+    }
+
+    void SimulatedBodyNetData::OnSimulationBodyAdded(AzPhysics::SceneHandle sceneHandle, AzPhysics::SimulatedBodyHandle bodyHandle)
+    {
+        const AzPhysics::SimulatedBody* body = AZ::Interface<AzPhysics::SceneInterface>::Get()->GetSimulatedBodyFromHandle(sceneHandle, bodyHandle);
+        if (body == nullptr)
+        {
+            return;
+        }
+
+        const AzPhysics::SimulatedBodyIndex bodyIndex = AZStd::get<AzPhysics::HandleTypeIndex::Index>(bodyHandle);
+        if (bodyIndex >= m_bodies.size())
+        {
+            m_bodies.resize(bodyIndex + 1);
+        }
+
+        BodyEntry& entry = m_bodies[bodyIndex];
+        if (entry.m_bodyHandle == AzPhysics::InvalidSimulatedBodyHandle)
+        {
+            ++m_bodyCount;
+        }
+        entry.m_bodyHandle = bodyHandle;
+        entry.m_bodyNetData = LookupBodyNetData(*body);
+    }
+
+    void SimulatedBodyNetData::OnSimulationBodyRemoved([[maybe_unused]] AzPhysics::SceneHandle sceneHandle, AzPhysics::SimulatedBodyHandle bodyHandle)
+    {
+        const AzPhysics::SimulatedBodyIndex bodyIndex = AZStd::get<AzPhysics::HandleTypeIndex::Index>(bodyHandle);
+        if ((bodyIndex < m_bodies.size()) && (m_bodies[bodyIndex].m_bodyHandle == bodyHandle))
+        {
+            m_bodies[bodyIndex] = BodyEntry();
+            --m_bodyCount;
+        }
+    }
+
+    SimulatedBodyNetData* GetSimulatedBodyNetData()
+    {
+        return bg_SimulatedBodyNetData ? AZ::Interface<SimulatedBodyNetData>::Get() : nullptr;
+    }
+
+#if MPS_DIAGNOSTICS
+    static void sv_SimulatedBodyNetDataBenchmark(const AZ::ConsoleCommandContainer& arguments)
+    {
+        SimulatedBodyNetData* simulatedBodyNetData = AZ::Interface<SimulatedBodyNetData>::Get();
+        if ((simulatedBodyNetData == nullptr) || (SceneQuery::GetDefaultSceneHandle() == AzPhysics::InvalidSceneHandle))
+        {
+            AZLOG_WARN("sv_SimulatedBodyNetDataBenchmark requires active simulated body net data and a loaded level");
+            return;
+        }
+
+        const float radius = (arguments.size() > 0) ? AZStd::stof(AZStd::string(arguments[0])) : 100.0f;
+        const uint32_t iterationCount = (arguments.size() > 1) ? aznumeric_cast<uint32_t>(AZStd::stoi(AZStd::string(arguments[1]))) : 1000;
+
+        // A single large overlap visits every body near the origin, so the filter cost dominates
+        const Physics::SphereShapeConfiguration sphere(radius);
+        const NetEntityIdSet filteredNetEntityIds;
+        IntersectFilter filter(AZ::Transform::CreateIdentity(), AZ::Vector3::CreateZero(), AzPhysics::SceneQuery::QueryType::StaticAndDynamic,
+            HitMultiple::Yes, AzPhysics::CollisionGroup::All, filteredNetEntityIds, &sphere);
+        IntersectResults results;
+
+        const bool wasEnabled = bg_SimulatedBodyNetData;
+        float elapsedUs[2] = {};
+        for (const bool enabled : { false, true })
+        {
+            bg_SimulatedBodyNetData = enabled;
+            const auto start = AZStd::chrono::steady_clock::now();
+            for (uint32_t iteration = 0; iteration < iterationCount; ++iteration)
+            {
+                results.clear();
+                SceneQuery::WorldIntersect(GatherShape::Sphere, filter, results);
+            }
+            elapsedUs[enabled ? 1 : 0] = aznumeric_cast<float>(AZStd::chrono::duration_cast<AZStd::chrono::microseconds>(AZStd::chrono::steady_clock::now() - start).count());
+        }
+        bg_SimulatedBodyNetData = wasEnabled;
+
+        AZLOG_INFO("SimulatedBodyNetData benchmark, %.1f m overlap with %zu hits: lookup %.3f us per query, body array %.3f us per query (%u bodies recorded)",
+            radius, results.size(), elapsedUs[0] / iterationCount, elapsedUs[1] / iterationCount, simulatedBodyNetData->GetBodyCount());
+    }
+    AZ_CONSOLEFREEFUNC(sv_SimulatedBodyNetDataBenchmark, AZ::ConsoleFunctorFlags::Null, "Times large overlap queries with and without reading NetEntityIds from the body array, optionally takes a radius and an iteration count");
+#endif
+}
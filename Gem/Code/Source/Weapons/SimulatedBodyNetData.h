@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project. For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+
+#pragma once
+
+#include <AzCore/RTTI/RTTI.h>
+#include <AzCore/std/containers/vector.h>
+#include <AzFramework/Physics/Common/PhysicsEvents.h>
+#include <AzFramework/Physics/Common/PhysicsTypes.h>
+#include <Multiplayer/MultiplayerTypes.h>
+
+namespace AzPhysics
+{
+    struct SimulatedBody;
+}
+
+namespace MultiplayerSample
+{
+    //! @struct BodyNetData
+    //! @brief Network details of a physics body that scene query filters need for every candidate body.
+    struct BodyNetData
+    {
+        Multiplayer::NetEntityId m_netEntityId = Multiplayer::InvalidNetEntityId; // Owning network entity, InvalidNetEntityId for non-networked bodies
+        bool m_rewindableHitVolume = false; // True for non-static bodies of networked entities, which are the only bodies rewind can move
+    };
+
+    //! @class SimulatedBodyNetData
+    //! @brief Records the network details of every body in the default physics scene in a flat array indexed by body index.
+    //! Entries are written when a body is added to the scene and cleared when it's removed, so scene query filters read them with an
+    //! index and a handle compare instead of an entity lookup per candidate body. NetBindComponent binds the NetEntityId before any
+    //! component activates, so it's already valid when a networked entity's bodies are added. Reads never modify the array, bodies
+    //! added before the default scene was connected are looked up directly instead.
+    class SimulatedBodyNetData
+    {
+    public:
+        AZ_RTTI(SimulatedBodyNetData, "{2D7F4C95-81B3-4E6A-A0C8-5F1E93B7D264}");
+
+        SimulatedBodyNetData();
+        virtual ~SimulatedBodyNetData();
+
+        //! Returns the network details of a body, looking them up directly if the body was not recorded.
+        //! @param body the body to return network details for
+        //! @return the network details of the body
+        BodyNetData GetBodyNetData(const AzPhysics::SimulatedBody& body) const;
+
+        //! Returns the network details of a recorded body.
+        //! @param sceneHandle the scene the body belongs to
+        //! @param bodyHandle  the body to return network details for
+        //! @param outBodyNetData the network details of the body, only written if the body was recorded
+        //! @return true if the body was recorded
+        bool FindBodyNetData(AzPhysics::SceneHandle sceneHandle, AzPhysics::SimulatedBodyHandle bodyHandle, BodyNetData& outBodyNetData) const;
+
+        //! Returns the number of bodies currently recorded.
+        //! @return the number of recorded bodies
+        uint32_t GetBodyCount() const;
+
+    private:
+        struct BodyEntry
+        {
+            AzPhysics::SimulatedBodyHandle m_bodyHandle = AzPhysics::InvalidSimulatedBodyHandle; // Invalid for unused indices
+            BodyNetData m_bodyNetData;
+        };
+
+        static BodyNetData LookupBodyNetData(const AzPhysics::SimulatedBody& body);
+
+        void ConnectToScene(AzPhysics::SceneHandle sceneHandle);
+        void OnSimulationBodyAdded(AzPhysics::SceneHandle sceneHandle, AzPhysics::SimulatedBodyHandle bodyHandle);
+        void OnSimulationBodyRemoved(AzPhysics::SceneHandle sceneHandle, AzPhysics::SimulatedBodyHandle bodyHandle);
+
+        AZStd::vector<BodyEntry> m_bodies; // Bodies of the connected scene, m_bodies[N] is the body with index N
+        uint32_t m_bodyCount = 0;
+
+        AzPhysics::SceneHandle m_sceneHandle = AzPhysics::InvalidSceneHandle;
+        AzPhysics::SceneEvents::OnSimulationBodyAdded::Handler m_bodyAddedHandler;
+        AzPhysics::SceneEvents::OnSimulationBodyRemoved::Handler m_bodyRemovedHandler;
+        AzPhysics::SystemEvents::OnSceneAddedEvent::Handler m_sceneAddedHandler;
+        AzPhysics::SystemEvents::OnSceneRemovedEvent::Handler m_sceneRemovedHandler;
+    };
+
+    //! Returns the simulated body net data if one is active and the body array is enabled.
+    //! @return the simulated body net data, or nullptr if scene queries should look up network entities directly
+    SimulatedBodyNetData* GetSimulatedBodyNetData();
+}
@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project. For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+
+#include <Source/Weapons/SurfaceTypeRegistry.h>
+#include <Source/MultiplayerSampleTypes.h>
+#include <AzCore/Console/IConsole.h>
+#include <AzCore/Console/ILogger.h>
+#include <AzCore/Interface/Interface.h>
+#include <AzCore/Settings/SettingsRegistry.h>
+#include <AzFramework/Physics/Material/PhysicsMaterial.h>
+#include <AzFramework/Physics/Material/PhysicsMaterialManager.h>
+#include <AzFramework/Physics/PhysicsSystem.h>
+
+namespace MultiplayerSample
+{
+    SurfaceTypeRegistry::SurfaceTypeRegistry()
+        : m_sceneRemovedHandler([this]([[maybe_unused]] AzPhysics::SceneHandle sceneHandle)
+        {
+            // Physics materials are level assets, so resolve them again once the next level has loaded
+            m_materialIds.clear();
+            m_materialSurfaceIndices.clear();
+        })
+    {
+        LoadSurfaceTypes();
+        AZ::Interface<SurfaceTypeRegistry>::Register(this);
+    }
+
+    SurfaceTypeRegistry::~SurfaceTypeRegistry()
+    {
+        m_sceneRemovedHandler.Disconnect();
+        AZ::Interface<SurfaceTypeRegistry>::Unregister(this);
+    }
+
+    SurfaceIndex SurfaceTypeRegistry::GetSurfaceIndex(const Physics::MaterialId& materialId)
+    {
+        const AZ::Uuid& materialUuid = materialId.GetUuid();
+        for (size_t materialIndex = 0; materialIndex < m_materialIds.size(); ++materialIndex)
+        {
+            if (m_materialIds[materialIndex] == materialUuid)
+            {
+                return m_materialSurfaceIndices[materialIndex];
+            }
+        }
+
+        // The physics system may come up after us, so hook scene removal the first time we resolve a material
+        auto* physicsSystem = AZ::Interface<AzPhysics::SystemInterface>::Get();
+        if ((physicsSystem != nullptr) && !m_sceneRemovedHandler.IsConnected())
+        {
+            physicsSystem->RegisterSceneRemovedEvent(m_sceneRemovedHandler);
+        }
+
+        const SurfaceIndex surfaceIndex = ResolveSurfaceIndex(materialId);
+        m_materialIds.push_back(materialUuid);
+        m_materialSurfaceIndices.push_back(surfaceIndex);
+        return surfaceIndex;
+    }
+
+    SurfaceIndex SurfaceTypeRegistry::FindSurfaceIndex(const AZ::Name& surfaceName) const
+    {
+        for (size_t surfaceIndex = 0; surfaceIndex < m_surfaceNames.size(); ++surfaceIndex)
+        {
+            if (m_surfaceNames[surfaceIndex] == surfaceName)
+            {
+                return aznumeric_cast<SurfaceIndex>(surfaceIndex);
+            }
+        }
+        return DefaultSurfaceIndex;
+    }
+
+    const AZ::Name& SurfaceTypeRegistry::GetSurfaceName(SurfaceIndex surfaceIndex) const
+    {
+        return (surfaceIndex < m_surfaceNames.size()) ? m_surfaceNames[surfaceIndex] : m_surfaceNames[DefaultSurfaceIndex];
+    }
+
+    uint32_t SurfaceTypeRegistry::GetSurfaceTypeCount() const
+    {
+        return aznumeric_cast<uint32_t>(m_surfaceNames.size());
+    }
+
+    uint32_t SurfaceTypeRegistry::GetResolvedMaterialCount() const
+    {
+        return aznumeric_cast<uint32_t>(m_materialIds.size());
+    }
+
+    void SurfaceTypeRegistry::LoadSurfaceTypes()
+    {
+        const auto registry = AZ::SettingsRegistry::Get();
+        AZStd::vector<AZStd::string> surfaceNames;
+        if (registry != nullptr)
+        {
+            registry->GetObject(surfaceNames, SurfaceTypesSetting);
+        }
+
+        // Index 0 is reserved for materials that aren't listed under any surface type
+        m_surfaceNames.clear();
+        m_materialAssetGuids.clear();
+        m_materialAssetSurfaceIndices.clear();
+        m_surfaceNames.push_back(AZ::Name("Default"));
+
+        for (const AZStd::string& surfaceName : surfaceNames)
+        {
+            if (m_surfaceNames.size() > MaxSurfaceIndex)
+            {
+                AZLOG_WARN("Too many surface types listed in %.*s, only the first %u will be used",
+                    AZ_STRING_ARG(SurfaceTypesSetting), aznumeric_cast<uint32_t>(MaxSurfaceIndex));
+                break;
+            }
+
+            if (surfaceName.empty() || (AZ::Name(surfaceName) == m_surfaceNames[DefaultSurfaceIndex]))
+            {
+                continue;
+            }
+
+            const SurfaceIndex surfaceIndex = aznumeric_cast<SurfaceIndex>(m_surfaceNames.size());
+            m_surfaceNames.push_back(AZ::Name(surfaceName));
+
+            AZStd::vector<AZStd::string> materialAssetGuids;
+            if (registry != nullptr)
+            {
+                registry->GetObject(materialAssetGuids, AZStd::string::format("%.*s/%s", AZ_STRING_ARG(SurfaceMaterialsSetting), surfaceName.c_str()));
+            }
+
+            for (const AZStd::string& materialAssetGuid : materialAssetGuids)
+            {
+                const AZ::Uuid guid = AZ::Uuid::CreateString(materialAssetGuid.c_str(), materialAssetGuid.size());
+                if (guid.IsNull())
+                {
+                    AZLOG_WARN("Surface type %s lists an invalid physics material asset guid %s", surfaceName.c_str(), materialAssetGuid.c_str());
+                    continue;
+                }
+                m_materialAssetGuids.push_back(guid);
+                m_materialAssetSurfaceIndices.push_back(surfaceIndex);
+            }
+        }
+    }
+
+    SurfaceIndex SurfaceTypeRegistry::ResolveSurfaceIndex(const Physics::MaterialId& materialId) const
+    {
+        auto* materialManager = AZ::Interface<Physics::MaterialManager>::Get();
+        if ((materialManager == nullptr) || !materialId.IsValid())
+        {
+            return DefaultSurfaceIndex;
+        }
+
+        const AZStd::shared_ptr<Physics::Material> material = materialManager->GetMaterial(materialId);
+        if (material == nullptr)
+        {
+            return DefaultSurfaceIndex;
+        }
+
+        const AZ::Uuid& assetGuid = material->GetMaterialAsset().GetId().m_guid;
+        for (size_t listIndex = 0; listIndex < m_materialAssetGuids.size(); ++listIndex)
+        {
+            if (m_materialAssetGuids[listIndex] == assetGuid)
+            {
+                return m_materialAssetSurfaceIndices[listIndex];
+            }
+        }
+
+        return DefaultSurfaceIndex;
+    }
+
+    SurfaceTypeRegistry* GetSurfaceTypeRegistry()
+    {
+        return AZ::Interface<SurfaceTypeRegistry>::Get();
+    }
+
+#if MPS_DIAGNOSTICS
+    static void sv_SurfaceTypes([[maybe_unused]] const AZ::ConsoleCommandContainer& arguments)
+    {
+        SurfaceTypeRegistry* surfaceTypeRegistry = GetSurfaceTypeRegistry();
+        if (surfaceTypeRegistry == nullptr)
+        {
+            AZLOG_WARN("sv_SurfaceTypes requires an active surface type registry");
+            return;
+        }
+
+        for (uint32_t surfaceIndex = 0; surfaceIndex < surfaceTypeRegistry->GetSurfaceTypeCount(); ++surfaceIndex)
+        {
+            const AZ::Name& surfaceName = surfaceTypeRegistry->GetSurfaceName(aznumeric_cast<SurfaceIndex>(surfaceIndex));
+            AZLOG_INFO("Surface type %u: %s", surfaceIndex, surfaceName.GetCStr());
+        }
+        AZLOG_INFO("%u physics materials resolved since the last level load", surfaceTypeRegistry->GetResolvedMaterialCount());
+    }
+    AZ_CONSOLEFREEFUNC(sv_SurfaceTypes, AZ::ConsoleFunctorFlags::Null, "Logs every surface type index and the number of physics materials resolved to a surface type");
+#endif
+}
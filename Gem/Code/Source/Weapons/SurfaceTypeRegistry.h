@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project. For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+
+#pragma once
+
+#include <Source/Weapons/WeaponTypes.h>
+#include <AzCore/Math/Uuid.h>
+#include <AzCore/Name/Name.h>
+#include <AzCore/RTTI/RTTI.h>
+#include <AzCore/std/containers/vector.h>
+#include <AzFramework/Physics/Common/PhysicsEvents.h>
+#include <AzFramework/Physics/Material/PhysicsMaterialId.h>
+
+namespace MultiplayerSample
+{
+    //! @class SurfaceTypeRegistry
+    //! @brief Maps physics material ids to compact surface indices that weapon hits carry instead of material names.
+    //! Surface types are listed in the settings registry, so indices match between the server and every client.
+    //! The settings registry also lists the physics material assets of each surface type by asset guid, any other material is the default surface.
+    //! Each physics material is resolved to a surface type the first time it's hit, mappings are dropped when the level unloads.
+    class SurfaceTypeRegistry
+    {
+    public:
+        AZ_RTTI(SurfaceTypeRegistry, "{5C0E8B71-2A9D-4F36-B1E4-7D93A6C2F085}");
+
+        SurfaceTypeRegistry();
+        virtual ~SurfaceTypeRegistry();
+
+        //! Returns the surface index for a physics material.
+        //! @param materialId the physics material to return the surface index for
+        //! @return the surface index of the material, DefaultSurfaceIndex if the material does not match any surface type
+        SurfaceIndex GetSurfaceIndex(const Physics::MaterialId& materialId);
+
+        //! Returns the surface index with the provided name.
+        //! @param surfaceName the name of the surface type to find
+        //! @return the surface index, DefaultSurfaceIndex if no surface type has that name
+        SurfaceIndex FindSurfaceIndex(const AZ::Name& surfaceName) const;
+
+        //! Returns the name of a surface type.
+        //! @param surfaceIndex the surface index to return the name of
+        //! @return the surface type name, the default surface name if the index is out of range
+        const AZ::Name& GetSurfaceName(SurfaceIndex surfaceIndex) const;
+
+        //! Returns the number of surface types, including the default surface.
+        //! @return the number of surface types
+        uint32_t GetSurfaceTypeCount() const;
+
+        //! Returns the number of physics materials resolved to a surface type since the last level load.
+        //! @return the number of resolved physics materials
+        uint32_t GetResolvedMaterialCount() const;
+
+    private:
+        void LoadSurfaceTypes();
+        SurfaceIndex ResolveSurfaceIndex(const Physics::MaterialId& materialId) const;
+
+        // Surface types, m_surfaceNames[N] is the name of surface index N, index 0 is always the default surface
+        AZStd::vector<AZ::Name> m_surfaceNames;
+
+        // Listed physics material assets, m_materialAssetGuids[N] is a material of surface index m_materialAssetSurfaceIndices[N]
+        AZStd::vector<AZ::Uuid> m_materialAssetGuids;
+        AZStd::vector<SurfaceIndex> m_materialAssetSurfaceIndices;
+
+        // Resolved materials, m_materialIds[N] maps to m_materialSurfaceIndices[N]
+        AZStd::vector<AZ::Uuid> m_materialIds;
+        AZStd::vector<SurfaceIndex> m_materialSurfaceIndices;
+
+        AzPhysics::SystemEvents::OnSceneRemovedEvent::Handler m_sceneRemovedHandler;
+    };
+
+    //! Returns the surface type registry if one is active.
+    //! @return the surface type registry, or nullptr if none is active
+    SurfaceTypeRegistry* GetSurfaceTypeRegistry();
+}
@@ -42,6 +42,10 @@ namespace MultiplayerSample
                     AZ_Assert(false, "Attempting to add too many active shots to the TraceWeapon.");
                 }
             }
+            else if (WeaponQueryBatch* weaponQueryBatch = GetQueryBatch())
+            {
+                weaponQueryBatch->EnqueueGather(m_weaponParams.m_gatherParams, eventData, m_gatheredNetEntityIds, *this, InstantGatherUserData);
+            }
             else if (GatherEntities(eventData, gatherResults))
             {
                 DispatchHitEvents(gatherResults, eventData, m_gatheredNetEntityIds);
@@ -51,6 +55,18 @@ namespace MultiplayerSample
 
     void TraceWeapon::TickActiveShots(WeaponState& weaponState, float deltaTime)
     {
+        if (WeaponQueryBatch* weaponQueryBatch = GetQueryBatch())
+        {
+            // Hits are dispatched from OnWeaponQueryComplete, shots that terminated last flush are removed here
+            RemoveTerminatedShots(weaponState);
+            for (AZStd::size_t i = 0; i < weaponState.m_activeShots.size(); ++i)
+            {
+                weaponQueryBatch->EnqueueGatherMultisegment(m_weaponParams.m_gatherParams, m_gatheredNetEntityIds, deltaTime,
+                    weaponState.m_activeShots[i], *this, aznumeric_cast<uint32_t>(i));
+            }
+            return;
+        }
+
         AZStd::size_t numActiveShots = weaponState.m_activeShots.size();
         for (AZStd::size_t i = 0; i < numActiveShots; ++i)
         {
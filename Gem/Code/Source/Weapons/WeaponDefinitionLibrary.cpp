@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project. For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+
+#include <Source/Weapons/WeaponDefinitionLibrary.h>
+#include <Source/MultiplayerSampleTypes.h>
+#include <AzCore/Console/IConsole.h>
+#include <AzCore/Console/ILogger.h>
+#include <AzCore/Interface/Interface.h>
+#include <AzCore/Settings/SettingsRegistry.h>
+#include <AzCore/Settings/SettingsRegistryVisitorUtils.h>
+#include <AzCore/std/algorithm.h>
+#include <AzCore/std/sort.h>
+
+namespace MultiplayerSample
+{
+    WeaponDefinitionLibrary::WeaponDefinitionLibrary()
+    {
+        LoadDefinitions();
+        AZ::Interface<WeaponDefinitionLibrary>::Register(this);
+    }
+
+    WeaponDefinitionLibrary::~WeaponDefinitionLibrary()
+    {
+        AZ::Interface<WeaponDefinitionLibrary>::Unregister(this);
+    }
+
+    WeaponDefinitionIndex WeaponDefinitionLibrary::FindDefinitionIndex(const AZ::Name& definitionName) const
+    {
+        // Names are sorted on load, so this is a binary search over the name strings
+        const auto found = AZStd::lower_bound(m_definitionNames.begin(), m_definitionNames.end(), definitionName.GetStringView(),
+            [](const AZ::Name& lhs, AZStd::string_view rhs) { return lhs.GetStringView() < rhs; });
+        if ((found == m_definitionNames.end()) || (*found != definitionName))
+        {
+            return InvalidWeaponDefinitionIndex;
+        }
+        return aznumeric_cast<WeaponDefinitionIndex>(found - m_definitionNames.begin());
+    }
+
+    const WeaponParams* WeaponDefinitionLibrary::GetDefinition(WeaponDefinitionIndex definitionIndex) const
+    {
+        return (definitionIndex < m_definitions.size()) ? &m_definitions[definitionIndex] : nullptr;
+    }
+
+    const AZ::Name& WeaponDefinitionLibrary::GetDefinitionName(WeaponDefinitionIndex definitionIndex) const
+    {
+        return m_definitionNames[definitionIndex];
+    }
+
+    uint32_t WeaponDefinitionLibrary::GetDefinitionCount() const
+    {
+        return aznumeric_cast<uint32_t>(m_definitions.size());
+    }
+
+    bool WeaponDefinitionLibrary::ValidateDefinition(const AZ::Name& definitionName, const WeaponParams& weaponParams)
+    {
+        const GatherParams& gatherParams = weaponParams.m_gatherParams;
+        bool isValid = true;
+
+        if (gatherParams.m_castDistance <= 0.0f)
+        {
+            AZLOG_WARN("Weapon definition %s has a cast distance of %f, it must be positive", definitionName.GetCStr(), gatherParams.m_castDistance);
+            isValid = false;
+        }
+
+        if (gatherParams.m_travelSpeed < 0.0f)
+        {
+            AZLOG_WARN("Weapon definition %s has a negative travel speed", definitionName.GetCStr());
+            isValid = false;
+        }
+
+        if ((weaponParams.m_weaponType == WeaponType::Projectile) && (gatherParams.m_travelSpeed <= 0.0f))
+        {
+            AZLOG_WARN("Weapon definition %s is a projectile weapon without a travel speed", definitionName.GetCStr());
+            isValid = false;
+        }
+
+        return isValid;
+    }
+
+    void WeaponDefinitionLibrary::LoadDefinitions()
+    {
+        auto* registry = AZ::SettingsRegistry::Get();
+        if (registry == nullptr)
+        {
+            return;
+        }
+
+        AZStd::vector<AZStd::string> definitionNames;
+        AZ::SettingsRegistryVisitorUtils::VisitObject(*registry, [&definitionNames](const AZ::SettingsRegistryInterface::VisitArgs& visitArgs)
+        {
+            definitionNames.emplace_back(visitArgs.m_fieldName);
+            return AZ::SettingsRegistryInterface::VisitResponse::Skip;
+        }, WeaponDefinitionsSetting);
+
+        // Registry order depends on merge order, sorting keeps indices identical on every endpoint
+        AZStd::sort(definitionNames.begin(), definitionNames.end());
+
+        for (const AZStd::string& definitionName : definitionNames)
+        {
+            if (m_definitions.size() >= InvalidWeaponDefinitionIndex)
+            {
+                AZLOG_WARN("Too many weapon definitions listed in %.*s, only the first %u will be used",
+                    AZ_STRING_ARG(WeaponDefinitionsSetting), aznumeric_cast<uint32_t>(InvalidWeaponDefinitionIndex));
+                break;
+            }
+
+            const AZ::Name name(definitionName);
+            const AZStd::string path = AZStd::string::format("%.*s/%s", AZ_STRING_ARG(WeaponDefinitionsSetting), definitionName.c_str());
+            WeaponParams weaponParams;
+            if (!registry->GetObject(weaponParams, path))
+            {
+                AZLOG_WARN("Failed to load weapon definition %s", definitionName.c_str());
+                continue;
+            }
+
+            if (ValidateDefinition(name, weaponParams))
+            {
+                m_definitionNames.push_back(name);
+                m_definitions.push_back(AZStd::move(weaponParams));
+            }
+        }
+    }
+
+    WeaponDefinitionLibrary* GetWeaponDefinitionLibrary()
+    {
+        return AZ::Interface<WeaponDefinitionLibrary>::Get();
+    }
+
+#if MPS_DIAGNOSTICS
+    static void bg_WeaponDefinitions(const AZ::ConsoleCommandContainer& arguments)
+    {
+        WeaponDefinitionLibrary* library = GetWeaponDefinitionLibrary();
+        if (library == nullptr)
+        {
+            AZLOG_WARN("bg_WeaponDefinitions requires an active weapon definition library");
+            return;
+        }
+
+        bool allValid = true;
+        for (uint32_t definitionIndex = 0; definitionIndex < library->GetDefinitionCount(); ++definitionIndex)
+        {
+            const WeaponDefinitionIndex index = aznumeric_cast<WeaponDefinitionIndex>(definitionIndex);
+            const AZ::Name& definitionName = library->GetDefinitionName(index);
+            const WeaponParams& weaponParams = *library->GetDefinition(index);
+            const bool isValid = WeaponDefinitionLibrary::ValidateDefinition(definitionName, weaponParams)
+                && (library->FindDefinitionIndex(definitionName) == index);
+            allValid = allValid && isValid;
+            AZLOG_INFO("Weapon definition %u: %s, %s weapon, cast distance %.1f, travel speed %.1f%s", definitionIndex, definitionName.GetCStr(),
+                GetEnumString(weaponParams.m_weaponType), weaponParams.m_gatherParams.m_castDistance, weaponParams.m_gatherParams.m_travelSpeed,
+                isValid ? "" : " (invalid)");
+        }
+        AZLOG_INFO("%u weapon definitions loaded from %.*s%s", library->GetDefinitionCount(), AZ_STRING_ARG(WeaponDefinitionsSetting),
+            allValid ? "" : ", some definitions failed validation");
+
+        // Compare the copy of the parameters every weapon slot of every NetworkWeaponsComponent used to hold against the shared definitions
+        const uint32_t entityCount = (arguments.size() > 0) ? aznumeric_cast<uint32_t>(AZStd::stoi(AZStd::string(arguments[0]))) : 200;
+        const size_t weaponCount = size_t(entityCount) * MaxWeaponsPerComponent;
+        const size_t copiedBytes = weaponCount * sizeof(WeaponParams);
+        const size_t sharedBytes = library->GetDefinitionCount() * sizeof(WeaponParams) + weaponCount * sizeof(const WeaponParams*);
+        AZLOG_INFO("Weapon parameter footprint for %u armed entities: %zu bytes as per component copies, %zu bytes shared (%zu bytes per copy, excluding heap strings)",
+            entityCount, copiedBytes, sharedBytes, sizeof(WeaponParams));
+    }
+    AZ_CONSOLEFREEFUNC(bg_WeaponDefinitions, AZ::ConsoleFunctorFlags::Null, "Validates and logs every loaded weapon definition and compares per weapon and shared parameter memory, optionally takes an armed entity count");
+#endif
+}
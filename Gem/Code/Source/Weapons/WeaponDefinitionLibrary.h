@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project. For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+
+#pragma once
+
+#include <Source/Weapons/WeaponTypes.h>
+#include <AzCore/Name/Name.h>
+#include <AzCore/RTTI/RTTI.h>
+#include <AzCore/std/containers/vector.h>
+
+namespace MultiplayerSample
+{
+    //! @class WeaponDefinitionLibrary
+    //! @brief Immutable weapon parameters shared by every weapon that references them by name or by compact index.
+    //! Definitions are loaded once from the settings registry and sorted by name, so indices match between the server and every client.
+    //! Definitions are never modified or reallocated after loading, weapons hold references to them for their whole lifetime.
+    //! A definition without a weapon type keeps its parameters but no weapon is constructed from it.
+    class WeaponDefinitionLibrary
+    {
+    public:
+        AZ_RTTI(WeaponDefinitionLibrary, "{C3A84E17-5B92-4D0F-9E61-2F7B08D4A5C3}");
+
+        WeaponDefinitionLibrary();
+        virtual ~WeaponDefinitionLibrary();
+
+        //! Returns the index of the definition with the provided name, weapons resolve their definition once on activation.
+        //! @param definitionName the name of the definition to find
+        //! @return the definition index, InvalidWeaponDefinitionIndex if no definition has that name
+        WeaponDefinitionIndex FindDefinitionIndex(const AZ::Name& definitionName) const;
+
+        //! Returns the parameters of a definition.
+        //! @param definitionIndex the index of the definition
+        //! @return the weapon parameters, nullptr if the index is out of range
+        const WeaponParams* GetDefinition(WeaponDefinitionIndex definitionIndex) const;
+
+        //! Returns the name of a definition.
+        //! @param definitionIndex the index of the definition, must be in range
+        //! @return the definition name
+        const AZ::Name& GetDefinitionName(WeaponDefinitionIndex definitionIndex) const;
+
+        //! Returns the number of loaded definitions.
+        //! @return the number of definitions
+        uint32_t GetDefinitionCount() const;
+
+        //! Checks a set of weapon parameters for values that would break gathers or activations.
+        //! @param definitionName the name to report problems against
+        //! @param weaponParams   the parameters to validate
+        //! @return true if the parameters are usable
+        static bool ValidateDefinition(const AZ::Name& definitionName, const WeaponParams& weaponParams);
+
+    private:
+        void LoadDefinitions();
+
+        // Definitions sorted by name, m_definitionNames[N] is the name of m_definitions[N]
+        AZStd::vector<AZ::Name> m_definitionNames;
+        AZStd::vector<WeaponParams> m_definitions;
+    };
+
+    //! Returns the weapon definition library if one is active.
+    //! @return the weapon definition library, or nullptr if none is active
+    WeaponDefinitionLibrary* GetWeaponDefinitionLibrary();
+}
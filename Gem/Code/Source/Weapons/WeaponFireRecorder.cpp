@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project. For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+
+#include <Source/Weapons/WeaponFireRecorder.h>
+#include <AzCore/Console/IConsole.h>
+#include <AzCore/Console/ILogger.h>
+#include <AzCore/Interface/Interface.h>
+#include <AzCore/IO/FileIO.h>
+#include <AzCore/IO/Path/Path.h>
+#include <AzCore/Serialization/SerializeContext.h>
+#include <AzCore/Serialization/Utils.h>
+#include <Multiplayer/NetworkTime/INetworkTime.h>
+
+namespace MultiplayerSample
+{
+    AZ_CVAR(uint32_t, sv_WeaponFireRecordMaxShots, 100000, nullptr, AZ::ConsoleFunctorFlags::Null, "The maximum number of shots kept in memory by a weapon fire recording, later shots are dropped until recording is stopped");
+
+    constexpr AZStd::string_view DefaultRecordingPath = "@user@/WeaponFire.rec";
+
+    void RecordedWeaponShot::Reflect(AZ::ReflectContext* context)
+    {
+        if (AZ::SerializeContext* serializeContext = azrtti_cast<AZ::SerializeContext*>(context))
+        {
+            serializeContext->Class<RecordedWeaponShot>()
+                ->Version(1)
+                ->Field("HostFrameId", &RecordedWeaponShot::m_hostFrameId)
+                ->Field("WasRewound", &RecordedWeaponShot::m_wasRewound)
+                ->Field("ShooterNetEntityId", &RecordedWeaponShot::m_shooterNetEntityId)
+                ->Field("InitialTransform", &RecordedWeaponShot::m_initialTransform)
+                ->Field("TargetPosition", &RecordedWeaponShot::m_targetPosition)
+                ->Field("GatherParams", &RecordedWeaponShot::m_gatherParams)
+            ;
+        }
+    }
+
+    void WeaponFireRecording::Reflect(AZ::ReflectContext* context)
+    {
+        if (AZ::SerializeContext* serializeContext = azrtti_cast<AZ::SerializeContext*>(context))
+        {
+            serializeContext->Class<WeaponFireRecording>()
+                ->Version(1)
+                ->Field("Shots", &WeaponFireRecording::m_shots)
+            ;
+        }
+    }
+
+    WeaponFireRecorder::WeaponFireRecorder()
+    {
+        AZ::Interface<WeaponFireRecorder>::Register(this);
+    }
+
+    WeaponFireRecorder::~WeaponFireRecorder()
+    {
+        // Recordings still running at shutdown are written rather than lost
+        StopRecording();
+        AZ::Interface<WeaponFireRecorder>::Unregister(this);
+    }
+
+    void WeaponFireRecorder::StartRecording(const AZStd::string& filePath)
+    {
+        m_filePath = filePath;
+        m_recording.m_shots.clear();
+        m_isRecording = true;
+        m_warnedShotCap = false;
+    }
+
+    bool WeaponFireRecorder::StopRecording()
+    {
+        if (!m_isRecording)
+        {
+            return false;
+        }
+        m_isRecording = false;
+
+        if (!AZ::Utils::SaveObjectToFile(m_filePath, AZ::DataStream::ST_BINARY, &m_recording))
+        {
+            AZLOG_WARN("Failed to write weapon fire recording to %s", m_filePath.c_str());
+            return false;
+        }
+
+        AZLOG_INFO("Wrote %u recorded weapon shots to %s", aznumeric_cast<uint32_t>(m_recording.m_shots.size()), m_filePath.c_str());
+        m_recording.m_shots.clear();
+        return true;
+    }
+
+    bool WeaponFireRecorder::IsRecording() const
+    {
+        return m_isRecording;
+    }
+
+    void WeaponFireRecorder::RecordShot(const GatherParams& gatherParams, const ActivateEvent& eventData)
+    {
+        if (!m_isRecording)
+        {
+            return;
+        }
+
+        if (m_recording.m_shots.size() >= sv_WeaponFireRecordMaxShots)
+        {
+            if (!m_warnedShotCap)
+            {
+                AZLOG_WARN("Weapon fire recording reached %u shots, later shots are dropped", static_cast<uint32_t>(sv_WeaponFireRecordMaxShots));
+                m_warnedShotCap = true;
+            }
+            return;
+        }
+
+        RecordedWeaponShot& shot = m_recording.m_shots.emplace_back();
+        Multiplayer::INetworkTime* networkTime = Multiplayer::GetNetworkTime();
+        shot.m_hostFrameId = static_cast<uint32_t>(networkTime->GetHostFrameId());
+        shot.m_wasRewound = networkTime->IsTimeRewound();
+        shot.m_shooterNetEntityId = static_cast<uint64_t>(eventData.m_shooterId);
+        shot.m_initialTransform = eventData.m_initialTransform;
+        shot.m_targetPosition = eventData.m_targetPosition;
+        shot.m_gatherParams = gatherParams;
+    }
+
+    //! Resolves file aliases such as @user@ in a recording path.
+    static AZStd::string ResolveRecordingPath(AZStd::string_view filePath)
+    {
+        AZ::IO::FixedMaxPath resolvedPath;
+        if (AZ::IO::FileIOBase* fileIo = AZ::IO::FileIOBase::GetInstance(); (fileIo != nullptr) && fileIo->ResolvePath(resolvedPath, filePath))
+        {
+            return resolvedPath.String();
+        }
+        return AZStd::string(filePath);
+    }
+
+    WeaponFireRecorder* GetWeaponFireRecorder()
+    {
+        return AZ::Interface<WeaponFireRecorder>::Get();
+    }
+
+    static void sv_WeaponFireRecordStart(const AZ::ConsoleCommandContainer& arguments)
+    {
+        WeaponFireRecorder* weaponFireRecorder = GetWeaponFireRecorder();
+        if (weaponFireRecorder == nullptr)
+        {
+            AZLOG_WARN("sv_WeaponFireRecordStart is only available on servers");
+            return;
+        }
+
+        const AZStd::string filePath = ResolveRecordingPath(arguments.empty() ? DefaultRecordingPath : arguments.front());
+        weaponFireRecorder->StartRecording(filePath);
+        AZLOG_INFO("Recording weapon shots to %s", filePath.c_str());
+    }
+    AZ_CONSOLEFREEFUNC(sv_WeaponFireRecordStart, AZ::ConsoleFunctorFlags::Null, "Starts recording authoritative weapon shots, optionally takes the file to write the recording to");
+
+    static void sv_WeaponFireRecordStop([[maybe_unused]] const AZ::ConsoleCommandContainer& arguments)
+    {
+        if (WeaponFireRecorder* weaponFireRecorder = GetWeaponFireRecorder())
+        {
+            weaponFireRecorder->StopRecording();
+        }
+    }
+    AZ_CONSOLEFREEFUNC(sv_WeaponFireRecordStop, AZ::ConsoleFunctorFlags::Null, "Stops recording authoritative weapon shots and writes the recording");
+}
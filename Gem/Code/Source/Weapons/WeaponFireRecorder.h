@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project. For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+
+#pragma once
+
+#include <Source/Weapons/WeaponTypes.h>
+#include <AzCore/RTTI/RTTI.h>
+#include <AzCore/std/containers/vector.h>
+#include <AzCore/std/string/string.h>
+
+namespace MultiplayerSample
+{
+    //! @struct RecordedWeaponShot
+    //! @brief A single authoritative weapon activation, with the parameters and frame its gathers were performed with.
+    struct RecordedWeaponShot
+    {
+        AZ_TYPE_INFO(RecordedWeaponShot, "{5E0B7D42-19C3-4A8E-B6F5-3D27C8E90A14}");
+
+        uint32_t m_hostFrameId = 0; // Host frame the shot was activated on
+        bool m_wasRewound = false;  // True if the shot was gathered against rewound entities, m_hostFrameId is then the rewound frame
+        uint64_t m_shooterNetEntityId = 0; // Filtered out of the shot's gathers, the same as the weapon does
+        AZ::Transform m_initialTransform = AZ::Transform::CreateIdentity();
+        AZ::Vector3 m_targetPosition = AZ::Vector3::CreateZero();
+        GatherParams m_gatherParams;
+
+        static void Reflect(AZ::ReflectContext* context);
+    };
+
+    //! @struct WeaponFireRecording
+    //! @brief Every shot recorded by the WeaponFireRecorder, in activation order.
+    //! Recorded shots are only meaningful against the static geometry of the level they were recorded in.
+    struct WeaponFireRecording
+    {
+        AZ_TYPE_INFO(WeaponFireRecording, "{A1C64F93-7E28-4B0D-8D53-E96F02B7C5D8}");
+
+        AZStd::vector<RecordedWeaponShot> m_shots;
+
+        static void Reflect(AZ::ReflectContext* context);
+    };
+
+    //! @class WeaponFireRecorder
+    //! @brief Records authoritative trace weapon activations to a binary file for offline analysis of the shots fired during play.
+    //! Recording is driven by the sv_WeaponFireRecordStart and sv_WeaponFireRecordStop console commands.
+    //! Recordings are capped at sv_WeaponFireRecordMaxShots shots, later shots are dropped until recording is stopped.
+    class WeaponFireRecorder
+    {
+    public:
+        AZ_RTTI(WeaponFireRecorder, "{3F9D1E75-C04A-4B62-9A8E-71B5D6C2E0F9}");
+
+        WeaponFireRecorder();
+        virtual ~WeaponFireRecorder();
+
+        //! Starts recording shots, any recording in progress is discarded.
+        //! @param filePath the file the recording is written to once stopped
+        void StartRecording(const AZStd::string& filePath);
+
+        //! Stops recording and writes the recorded shots.
+        //! @return false if nothing was being recorded or the file could not be written
+        bool StopRecording();
+
+        //! Returns whether shots are currently being recorded.
+        //! @return true if recording
+        bool IsRecording() const;
+
+        //! Records a single authoritative activation, ignored unless recording and below the shot cap.
+        //! @param gatherParams the gather parameters of the activated weapon
+        //! @param eventData    the activation event
+        void RecordShot(const GatherParams& gatherParams, const ActivateEvent& eventData);
+
+    private:
+        AZStd::string m_filePath;
+        WeaponFireRecording m_recording;
+        bool m_isRecording = false;
+        bool m_warnedShotCap = false;
+    };
+
+    //! Returns the weapon fire recorder if one is active.
+    //! @return the weapon fire recorder, or nullptr if none is active
+    WeaponFireRecorder* GetWeaponFireRecorder();
+}
@@ -6,11 +6,16 @@
  */
 
 #include <Source/Weapons/WeaponGathers.h>
+#include <Source/MultiplayerSampleTypes.h>
 #include <Multiplayer/NetworkTime/INetworkTime.h>
 #include <AzFramework/Physics/PhysicsScene.h>
 #include <AzCore/Component/Component.h>
+#include <AzCore/Console/IConsole.h>
 #include <AzCore/Console/ILogger.h>
+#include <AzCore/std/chrono/chrono.h>
 #include <Source/Weapons/SceneQuery.h>
+#include <Source/Weapons/SceneQueryHitBuffer.h>
+#include <Source/Weapons/SceneQueryShapeCache.h>
 
 #if AZ_TRAIT_CLIENT
 #   include <DebugDraw/DebugDrawBus.h>
@@ -18,7 +23,9 @@
 
 namespace MultiplayerSample
 {
-    AZ_CVAR(uint32_t, bg_MultitraceNumTraceSegments, 3, nullptr, AZ::ConsoleFunctorFlags::Null, "The number of segments to use when performing multitrace casts");
+    AZ_CVAR(uint32_t, bg_MultitraceNumTraceSegments, 3, nullptr, AZ::ConsoleFunctorFlags::Null, "The number of segments to use when performing multitrace casts with adaptive segments disabled");
+    AZ_CVAR(bool, bg_MultitraceAdaptiveSegments, true, nullptr, AZ::ConsoleFunctorFlags::Null, "If true, multitrace casts pick their segment count from how far the arc deviates from a straight line");
+    AZ_CVAR(float, bg_MultitraceChordTolerance, 0.05f, nullptr, AZ::ConsoleFunctorFlags::Null, "The maximum distance in meters an adaptive multitrace segment may deviate from the true ballistic arc");
     AZ_CVAR(bool, bg_DrawPhysicsRaycasts, false, nullptr, AZ::ConsoleFunctorFlags::Null, "If enabled, will debug draw physics raycasts");
 
     IntersectFilter::IntersectFilter
@@ -81,50 +88,101 @@ namespace MultiplayerSample
         return true;
     }
 
-    ShotResult GatherEntitiesMultisegment
-    (
-        const GatherParams& gatherParams, 
-        const NetEntityIdSet& filteredNetEntityIds, 
-        float deltaTime, 
-        ActiveShot& inOutActiveShot, 
-        IntersectResults& outResults
-    )
+    uint32_t GetMultitraceSegmentCount(float deltaTime, const AZ::Vector3& acceleration)
     {
-        // This only works when our cast is not instantaneous (it requires some positive, non-zero travel speed)
-        AZ_Assert(gatherParams.m_travelSpeed > 0.0f, "GatherEntitiesMultiSegment called with an invalid travel speed! This will fail, use the non-segmented gather path instead.");
+        if (!bg_MultitraceAdaptiveSegments)
+        {
+            return AZStd::clamp<uint32_t>(bg_MultitraceNumTraceSegments, 1, MaxMultitraceSegments);
+        }
+
+        // A chord spanning t seconds of a constant acceleration arc deviates from the arc by at most |a| * t^2 / 8,
+        // splitting the arc into N equal segments divides that deviation by N^2
+        const float tolerance = AZStd::max<float>(bg_MultitraceChordTolerance, AZ::Constants::Tolerance);
+        const float maxDeviation = acceleration.GetLength() * deltaTime * deltaTime * 0.125f;
+        if (maxDeviation <= tolerance)
+        {
+            return 1;
+        }
 
-        ShotResult result = ShotResult::DoNotTerminate;
+        const float segmentCount = AZStd::ceil(AZStd::sqrt(maxDeviation / tolerance));
+        return AZStd::clamp<uint32_t>(aznumeric_cast<uint32_t>(segmentCount), 1, MaxMultitraceSegments);
+    }
 
-        const AZ::Transform& startTransform = inOutActiveShot.m_initialTransform;
-        const AZ::Vector3 sweep = (inOutActiveShot.m_targetPosition - startTransform.GetTranslation()).GetNormalized();
+    void ComputeMultisegmentPath
+    (
+        const GatherParams& gatherParams,
+        float deltaTime,
+        const ActiveShot& activeShot,
+        MultisegmentPath& outPath
+    )
+    {
+        const AZ::Transform& startTransform = activeShot.m_initialTransform;
+        const AZ::Vector3 sweep = (activeShot.m_targetPosition - startTransform.GetTranslation()).GetNormalized();
 
         // World gravity for our current location (making the currently safe assumption that it's constant over the duration of our trace)
         AzPhysics::SceneInterface* sceneInterface = AZ::Interface<AzPhysics::SceneInterface>::Get();
-        AzPhysics::SceneHandle sceneHandle = sceneInterface->GetSceneHandle(AzPhysics::DefaultPhysicsSceneName);
+        AzPhysics::SceneHandle sceneHandle = SceneQuery::GetDefaultSceneHandle();
         const AZ::Vector3& gravity = gatherParams.m_bulletDrop ? sceneInterface->GetGravity(sceneHandle) : AZ::Vector3::CreateZero();
-        const float segmentTickSize = deltaTime / bg_MultitraceNumTraceSegments; // Duration in seconds of each cast segment
+        const uint32_t numSegments = GetMultitraceSegmentCount(deltaTime, gravity);
+        const float segmentTickSize = deltaTime / numSegments; // Duration in seconds of each cast segment
         const AZ::Vector3 segmentStepOffset = sweep * gatherParams.m_travelSpeed; // Displacement (disregarding gravity) of our bullet over one second
         const float maxTravelDistanceSq = gatherParams.m_castDistance * gatherParams.m_castDistance;
 
         // We're not doing any lift or drift computations due to the magnus effects a bullet is subject to
         // Any such adjustments, estimates for how fast the bullet is spinning due to muzzle exit velocity and the rifling of the gun, air density, temperature, etc...
 
+        outPath.m_points.clear();
+        outPath.m_result = ShotResult::DoNotTerminate;
+
+        float currSegmentStartTime = activeShot.m_lifetimeSeconds;
+        outPath.m_points.push_back(startTransform.GetTranslation() + (segmentStepOffset * currSegmentStartTime) + (gravity * 0.5f * currSegmentStartTime * currSegmentStartTime));
+        for (uint32_t segment = 0; segment < numSegments; ++segment)
+        {
+            const float nextSegmentStartTime = currSegmentStartTime + segmentTickSize;
+            const AZ::Vector3 travelDistance = (segmentStepOffset * nextSegmentStartTime); // Total distance our shot has traveled as of this cast, ignoring arc-length due to gravity
+            outPath.m_points.push_back(startTransform.GetTranslation() + travelDistance + (gravity * 0.5f * nextSegmentStartTime * nextSegmentStartTime));
+
+            // Terminate the path once the shot has exceeded its maximum travel distance
+            if (travelDistance.GetLengthSq() > maxTravelDistanceSq)
+            {
+                outPath.m_result = ShotResult::ShouldTerminate;
+                break;
+            }
+
+            currSegmentStartTime = nextSegmentStartTime;
+        }
+    }
+
+    ShotResult GatherEntitiesMultisegment
+    (
+        const GatherParams& gatherParams, 
+        const NetEntityIdSet& filteredNetEntityIds, 
+        float deltaTime, 
+        ActiveShot& inOutActiveShot, 
+        IntersectResults& outResults
+    )
+    {
+        // This only works when our cast is not instantaneous (it requires some positive, non-zero travel speed)
+        AZ_Assert(gatherParams.m_travelSpeed > 0.0f, "GatherEntitiesMultiSegment called with an invalid travel speed! This will fail, use the non-segmented gather path instead.");
+
+        MultisegmentPath path;
+        ComputeMultisegmentPath(gatherParams, deltaTime, inOutActiveShot, path);
+        ShotResult result = path.m_result;
+
         const HitMultiple hitMultiple = gatherParams.m_multiHit ? HitMultiple::Yes : HitMultiple::No;
         const AzPhysics::CollisionGroup collisionGroup = AzPhysics::GetCollisionGroupById(gatherParams.m_collisionGroupId);
 
-        float currSegmentStartTime = inOutActiveShot.m_lifetimeSeconds;
-        AZ::Vector3 currSegmentPosition = inOutActiveShot.m_initialTransform.GetTranslation() + (segmentStepOffset * currSegmentStartTime) + (gravity * 0.5f * currSegmentStartTime * currSegmentStartTime);
-        for (uint32_t segment = 0; segment < bg_MultitraceNumTraceSegments; ++segment)
-        {
-            float nextSegmentStartTime = currSegmentStartTime + segmentTickSize;
-            AZ::Vector3 travelDistance = (segmentStepOffset * nextSegmentStartTime); // Total distance our shot has traveled as of this cast, ignoring arc-length due to gravity
-            AZ::Vector3 nextSegmentPosition = inOutActiveShot.m_initialTransform.GetTranslation() + travelDistance + (gravity * 0.5f * nextSegmentStartTime * nextSegmentStartTime);
+        // Segments only differ by pose and sweep, so a single filter is reused for the whole path
+        IntersectFilter filter(AZ::Transform::CreateIdentity(), AZ::Vector3::CreateZero(), AzPhysics::SceneQuery::QueryType::StaticAndDynamic,
+            hitMultiple, collisionGroup, filteredNetEntityIds, gatherParams.GetCurrentShapeConfiguration());
 
-            const AZ::Transform currSegTransform = AZ::Transform::CreateLookAt(currSegmentPosition, nextSegmentPosition);
-            const AZ::Vector3 segSweep = nextSegmentPosition - currSegmentPosition;
+        for (uint32_t segment = 0; segment + 1 < path.m_points.size(); ++segment)
+        {
+            const AZ::Vector3& currSegmentPosition = path.m_points[segment];
+            const AZ::Vector3& nextSegmentPosition = path.m_points[segment + 1];
 
-            IntersectFilter filter(currSegTransform, segSweep, AzPhysics::SceneQuery::QueryType::StaticAndDynamic,
-                hitMultiple, collisionGroup, filteredNetEntityIds, gatherParams.GetCurrentShapeConfiguration());
+            filter.m_initialPose = AZ::Transform::CreateLookAt(currSegmentPosition, nextSegmentPosition);
+            filter.m_sweep = nextSegmentPosition - currSegmentPosition;
             SceneQuery::WorldIntersect(gatherParams.m_gatherShape, filter, outResults);
 
 #if AZ_TRAIT_CLIENT
@@ -142,30 +200,171 @@ namespace MultiplayerSample
 #endif
 
             // Terminate the loop if we hit something
-            if (((outResults.size() > 0) && !gatherParams.m_multiHit) || (travelDistance.GetLengthSq() > maxTravelDistanceSq))
+            if ((outResults.size() > 0) && !gatherParams.m_multiHit)
             {
                 result = ShotResult::ShouldTerminate;
-#if AZ_TRAIT_CLIENT
-                if (bg_DrawPhysicsRaycasts && !outResults.empty())
-                {
-                    DebugDraw::DebugDrawRequestBus::Broadcast
-                    (
-                        &DebugDraw::DebugDrawRequests::DrawSphereAtLocation,
-                        outResults[0].m_position,
-                        /*radius=*/0.1f,
-                        AZ::Colors::Green,
-                        /*duration=*/10.0f
-                    );
-                }
-#endif
                 break;
             }
+        }
 
-            currSegmentStartTime = nextSegmentStartTime;
-            currSegmentPosition = nextSegmentPosition;
+#if AZ_TRAIT_CLIENT
+        if (bg_DrawPhysicsRaycasts && (result == ShotResult::ShouldTerminate) && !outResults.empty())
+        {
+            DebugDraw::DebugDrawRequestBus::Broadcast
+            (
+                &DebugDraw::DebugDrawRequests::DrawSphereAtLocation,
+                outResults[0].m_position,
+                /*radius=*/0.1f,
+                AZ::Colors::Green,
+                /*duration=*/10.0f
+            );
         }
+#endif
 
         inOutActiveShot.m_lifetimeSeconds = LifetimeSec(inOutActiveShot.m_lifetimeSeconds + deltaTime);
         return result;
     }
+
+#if MPS_DIAGNOSTICS
+    static void sv_WeaponHitPipelineBenchmark(const AZ::ConsoleCommandContainer& arguments)
+    {
+        if (SceneQuery::GetDefaultSceneHandle() == AzPhysics::InvalidSceneHandle)
+        {
+            AZLOG_WARN("sv_WeaponHitPipelineBenchmark requires a loaded level");
+            return;
+        }
+
+        const uint32_t shotCount = (arguments.size() > 0) ? aznumeric_cast<uint32_t>(AZStd::stoi(AZStd::string(arguments[0]))) : 10000;
+        constexpr float shooterRingRadius = 20.0f;
+        constexpr float shooterHeight = 1.5f;
+
+        GatherParams gatherParams;
+        gatherParams.m_gatherShape = GatherShape::Point;
+        gatherParams.m_multiHit = true;
+        const NetEntityIdSet filteredNetEntityIds;
+
+        // Both containers are fixed capacity, scene query hits go to the reused scene query hit buffer
+        IntersectResults results;
+        HitEvent hitEvent;
+        size_t totalHits = 0;
+        size_t maxHits = 0;
+
+        // Warm up so that the first use of each shape and of the hit buffer isn't counted against the steady state
+        SceneQueryShapeCache* shapeCache = GetSceneQueryShapeCache();
+        SceneQueryHitBuffer* hitBuffer = AZ::Interface<SceneQueryHitBuffer>::Get();
+        const ActivateEvent warmUpEvent{ AZ::Transform::CreateLookAt(AZ::Vector3(shooterRingRadius, 0.0f, shooterHeight), AZ::Vector3(-shooterRingRadius, 0.0f, shooterHeight)),
+            AZ::Vector3(-shooterRingRadius, 0.0f, shooterHeight), Multiplayer::InvalidNetEntityId, Multiplayer::InvalidNetEntityId };
+        GatherEntities(gatherParams, warmUpEvent, filteredNetEntityIds, results);
+        const uint32_t shapeAllocationsBefore = (shapeCache != nullptr) ? shapeCache->GetShapeAllocationCount() : 0;
+        const uint32_t hitBufferAllocationsBefore = (hitBuffer != nullptr) ? hitBuffer->GetAllocationCount() : 0;
+
+        const auto start = AZStd::chrono::steady_clock::now();
+        for (uint32_t shot = 0; shot < shotCount; ++shot)
+        {
+            const float angle = AZ::Constants::TwoPi * shot / shotCount;
+            const AZ::Vector3 source(shooterRingRadius * AZStd::cos(angle), shooterRingRadius * AZStd::sin(angle), shooterHeight);
+            const AZ::Vector3 target(-source.GetX(), -source.GetY(), shooterHeight);
+            const ActivateEvent eventData{ AZ::Transform::CreateLookAt(source, target), target, Multiplayer::InvalidNetEntityId, Multiplayer::InvalidNetEntityId };
+
+            results.clear();
+            GatherEntities(gatherParams, eventData, filteredNetEntityIds, results);
+
+            // Mirrors the conversion performed by BaseWeapon::DispatchHitEvents
+            hitEvent.m_target = eventData.m_targetPosition;
+            hitEvent.m_hitEntities.clear();
+            for (const IntersectResult& result : results)
+            {
+                hitEvent.m_hitEntities.emplace_back(HitEntity{ result.m_position, result.m_normal, result.m_netEntityId, result.m_surfaceIndex });
+            }
+
+            totalHits += hitEvent.m_hitEntities.size();
+            maxHits = AZStd::max(maxHits, hitEvent.m_hitEntities.size());
+        }
+        const auto end = AZStd::chrono::steady_clock::now();
+
+        const float elapsedUs = aznumeric_cast<float>(AZStd::chrono::duration_cast<AZStd::chrono::microseconds>(end - start).count());
+        AZLOG_INFO("Weapon hit pipeline benchmark, %u shots: %.3f us per shot, %zu total hits, %zu max hits per shot (capacity %u)",
+            shotCount, elapsedUs / AZStd::max(shotCount, 1u), totalHits, maxHits, MaxHitEntities);
+
+        if ((shapeCache == nullptr) || (hitBuffer == nullptr))
+        {
+            AZLOG_WARN("Scene query shape caching is disabled or there is no hit buffer, queries allocated their own shapes or hit buffers");
+            return;
+        }
+
+        const uint32_t shapeAllocations = shapeCache->GetShapeAllocationCount() - shapeAllocationsBefore;
+        const uint32_t hitBufferAllocations = hitBuffer->GetAllocationCount() - hitBufferAllocationsBefore;
+        if ((shapeAllocations == 0) && (hitBufferAllocations == 0))
+        {
+            AZLOG_INFO("Weapon hit pipeline check passed, no shape or hit buffer allocations after warm up");
+        }
+        else
+        {
+            AZLOG_WARN("Weapon hit pipeline check failed, %u shape and %u hit buffer allocations after warm up", shapeAllocations, hitBufferAllocations);
+        }
+    }
+    AZ_CONSOLEFREEFUNC(sv_WeaponHitPipelineBenchmark, AZ::ConsoleFunctorFlags::Null, "Fires synthetic multi-hit traces through the gather and hit event conversion path, reports the per-shot cost and checks that scene query shapes and hit buffers aren't allocated after warm up, optionally takes a shot count");
+#endif
+
+#if MPS_DIAGNOSTICS
+    static void bg_MultitraceSegmentCheck([[maybe_unused]] const AZ::ConsoleCommandContainer& arguments)
+    {
+        // 60hz and 20hz ticks plus a long hitch, against no drop, light drop and earth gravity
+        constexpr float deltaTimes[] = { 1.0f / 60.0f, 1.0f / 20.0f, 0.25f };
+        constexpr float gravities[] = { 0.0f, 2.0f, 9.81f };
+        constexpr uint32_t samplesPerSegment = 16;
+
+        const float tolerance = bg_MultitraceChordTolerance;
+        const bool wasAdaptive = bg_MultitraceAdaptiveSegments;
+        bool withinTolerance = true;
+
+        for (const float deltaTime : deltaTimes)
+        {
+            for (const float gravity : gravities)
+            {
+                const AZ::Vector3 acceleration(0.0f, 0.0f, -gravity);
+                const AZ::Vector3 velocity(100.0f, 0.0f, 0.0f);
+                auto arcPosition = [&](float time) { return (velocity * time) + (acceleration * 0.5f * time * time); };
+
+                bg_MultitraceAdaptiveSegments = false;
+                const uint32_t fixedSegments = GetMultitraceSegmentCount(deltaTime, acceleration);
+                bg_MultitraceAdaptiveSegments = true;
+                const uint32_t adaptiveSegments = GetMultitraceSegmentCount(deltaTime, acceleration);
+
+                // Measure how far the chords drift from the analytic arc by sampling the arc within each segment
+                const float segmentTime = deltaTime / adaptiveSegments;
+                float maxError = 0.0f;
+                for (uint32_t segment = 0; segment < adaptiveSegments; ++segment)
+                {
+                    const AZ::Vector3 chordStart = arcPosition(segmentTime * segment);
+                    const AZ::Vector3 chordEnd = arcPosition(segmentTime * (segment + 1));
+                    for (uint32_t sample = 1; sample < samplesPerSegment; ++sample)
+                    {
+                        const float fraction = aznumeric_cast<float>(sample) / samplesPerSegment;
+                        const AZ::Vector3 onArc = arcPosition(segmentTime * (segment + fraction));
+                        const AZ::Vector3 onChord = chordStart.Lerp(chordEnd, fraction);
+                        maxError = AZStd::max(maxError, onArc.GetDistance(onChord));
+                    }
+                }
+
+                // Segment counts are capped, so only uncapped results are expected to meet the tolerance
+                const bool passed = (maxError <= tolerance + AZ::Constants::Tolerance) || (adaptiveSegments == MaxMultitraceSegments);
+                withinTolerance = withinTolerance && passed;
+                AZLOG_INFO("Multitrace dt %.3f s, gravity %.2f m/s^2: %u adaptive casts vs %u fixed casts, max chord error %.4f m (%s)",
+                    deltaTime, gravity, adaptiveSegments, fixedSegments, maxError, passed ? "ok" : "exceeds tolerance");
+            }
+        }
+        bg_MultitraceAdaptiveSegments = wasAdaptive;
+
+        if (withinTolerance)
+        {
+            AZLOG_INFO("Multitrace segment check passed, every adaptive path is within %.3f m of its ballistic arc", tolerance);
+        }
+        else
+        {
+            AZLOG_WARN("Multitrace segment check failed, adaptive paths deviate more than %.3f m from their ballistic arc", tolerance);
+        }
+    }
+    AZ_CONSOLEFREEFUNC(bg_MultitraceSegmentCheck, AZ::ConsoleFunctorFlags::Null, "Compares adaptive multitrace paths against the analytic ballistic arc and logs the casts used per tick versus fixed segment counts");
+#endif
 }
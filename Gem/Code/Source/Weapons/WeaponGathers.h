@@ -8,6 +8,7 @@
 #pragma once
 
 #include <Source/Weapons/WeaponTypes.h>
+#include <AzCore/std/containers/fixed_vector.h>
 #include <AzCore/std/containers/unordered_set.h>
 #include <AzFramework/Physics/Collision/CollisionGroups.h>
 
@@ -15,6 +16,8 @@ namespace MultiplayerSample
 {
     typedef AZStd::unordered_set<Multiplayer::NetEntityId> NetEntityIdSet;
 
+    constexpr uint32_t MaxMultitraceSegments = 16; // Upper bound on the number of casts a single multitrace shot performs per tick
+
     enum class HitMultiple { No, Yes };
 
     enum class ShotResult
@@ -44,8 +47,8 @@ namespace MultiplayerSample
         AzPhysics::SceneQuery::QueryType m_queryType; // Intersect static, dynamic or both
 
         HitMultiple              m_intersectMultiple;
-        NetEntityIdSet           m_filteredNetEntityIds;
         AzPhysics::CollisionGroup m_collisionGroup;
+        const NetEntityIdSet&    m_filteredNetEntityIds; // Must outlive the filter, filters are only expected to live for the duration of a query
         const Physics::ShapeConfiguration* m_shapeConfiguration = nullptr; // Shape configuration for shape casts and overlaps
 
         IntersectFilter& operator=(const IntersectFilter&) = delete;
@@ -58,12 +61,41 @@ namespace MultiplayerSample
         AZ::Vector3 m_position;
         AZ::Vector3 m_normal;
         Multiplayer::NetEntityId m_netEntityId;
-        AZ::Name m_materialName;
+        SurfaceIndex m_surfaceIndex = DefaultSurfaceIndex;
     };
 
     //! @struct IntersectResult
     //! @brief Helper structure that holds all results from a world intersect query.
-    using IntersectResults = AZStd::vector<IntersectResult>;
+    //! Bounded by MaxHitEntities so that gathering hits never allocates, any hits past the limit are dropped.
+    using IntersectResults = AZStd::fixed_vector<IntersectResult, MaxHitEntities>;
+
+    //! @struct MultisegmentPath
+    //! @brief Helper structure describing the piecewise linear path an active shot travels along during a single tick.
+    struct MultisegmentPath
+    {
+        AZStd::fixed_vector<AZ::Vector3, MaxMultitraceSegments + 1> m_points; // Segment N spans m_points[N] to m_points[N + 1]
+        ShotResult m_result = ShotResult::DoNotTerminate; // ShouldTerminate if the shot exceeds its cast distance on the final segment
+    };
+
+    //! Returns the number of segments a multitrace cast is split into for a single tick.
+    //! Straight paths use a single segment, curved paths use enough segments to keep each within the chord tolerance of the true arc.
+    //! @param deltaTime    the amount of time the shot is travelling for
+    //! @param acceleration the constant acceleration acting on the shot, zero if the shot travels in a straight line
+    //! @return the number of segments, between 1 and MaxMultitraceSegments
+    uint32_t GetMultitraceSegmentCount(float deltaTime, const AZ::Vector3& acceleration);
+
+    //! Computes the path an active shot travels along over the next deltaTime seconds, including bullet drop.
+    //! @param gatherParams the gather parameters of the weapon that fired the shot
+    //! @param deltaTime    the amount of time the shot is travelling for
+    //! @param activeShot   the shot to compute the path for, the shot lifetime is not modified
+    //! @param outPath      output structure to store the segment end points in
+    void ComputeMultisegmentPath
+    (
+        const GatherParams& gatherParams,
+        float               deltaTime,
+        const ActiveShot&   activeShot,
+        MultisegmentPath&   outPath
+    );
 
     bool GatherEntities
     (
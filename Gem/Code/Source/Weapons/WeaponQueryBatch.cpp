@@ -0,0 +1,484 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project. For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+
+#include <Source/Weapons/WeaponQueryBatch.h>
+#include <Source/MultiplayerSampleTypes.h>
+#include <Source/Weapons/ProjectileStore.h>
+#include <Source/Weapons/SceneQuery.h>
+#include <AzCore/Console/IConsole.h>
+#include <AzCore/Console/ILogger.h>
+#include <AzCore/Interface/Interface.h>
+#include <AzCore/std/chrono/chrono.h>
+#include <AzCore/std/sort.h>
+#include <AzFramework/Physics/PhysicsScene.h>
+#include <Multiplayer/NetworkTime/INetworkTime.h>
+
+namespace MultiplayerSample
+{
+    AZ_CVAR(bool, sv_WeaponQueryBatching, true, nullptr, AZ::ConsoleFunctorFlags::Null, "If true, authoritative weapon gathers are deferred and executed as a single batch once per tick");
+
+    bool WeaponQueryBatch::RewindContext::operator==(const RewindContext& rhs) const
+    {
+        return m_frameId == rhs.m_frameId
+            && m_timeMs == rhs.m_timeMs
+            && m_blendFactor == rhs.m_blendFactor
+            && m_connectionId == rhs.m_connectionId;
+    }
+
+    bool WeaponQueryBatch::RewindContext::operator!=(const RewindContext& rhs) const
+    {
+        return !(*this == rhs);
+    }
+
+    bool WeaponQueryBatch::RewindContext::operator<(const RewindContext& rhs) const
+    {
+        if (m_frameId != rhs.m_frameId)
+        {
+            return m_frameId < rhs.m_frameId;
+        }
+        if (m_connectionId != rhs.m_connectionId)
+        {
+            return m_connectionId < rhs.m_connectionId;
+        }
+        if (m_timeMs != rhs.m_timeMs)
+        {
+            return m_timeMs < rhs.m_timeMs;
+        }
+        return m_blendFactor < rhs.m_blendFactor;
+    }
+
+    void WeaponQueryBatch::QueryBuffers::Clear()
+    {
+        m_gatherParams.clear();
+        m_events.clear();
+        m_rewindContexts.clear();
+        m_listeners.clear();
+        m_userData.clear();
+        m_firstSegments.clear();
+        m_segmentCounts.clear();
+        m_results.clear();
+        m_filteredNetEntityIds.clear();
+        m_segmentPoses.clear();
+        m_segmentSweeps.clear();
+        m_queryCount = 0;
+    }
+
+    WeaponQueryBatch::WeaponQueryBatch()
+    {
+        AZ::Interface<WeaponQueryBatch>::Register(this);
+        m_flushEvent.Enqueue(AZ::Time::ZeroTimeMs, true);
+    }
+
+    WeaponQueryBatch::~WeaponQueryBatch()
+    {
+        m_flushEvent.RemoveFromQueue();
+        AZ::Interface<WeaponQueryBatch>::Unregister(this);
+    }
+
+    void WeaponQueryBatch::EnqueueGather
+    (
+        const GatherParams& gatherParams,
+        const ActivateEvent& eventData,
+        const NetEntityIdSet& filteredNetEntityIds,
+        WeaponQueryListener& listener,
+        uint32_t userData
+    )
+    {
+        AddQuery(gatherParams, eventData, filteredNetEntityIds, listener, userData);
+        AddSegment(eventData.m_initialTransform, eventData.m_targetPosition - eventData.m_initialTransform.GetTranslation());
+    }
+
+    void WeaponQueryBatch::EnqueueGatherMultisegment
+    (
+        const GatherParams& gatherParams,
+        const NetEntityIdSet& filteredNetEntityIds,
+        float deltaTime,
+        ActiveShot& inOutActiveShot,
+        WeaponQueryListener& listener,
+        uint32_t userData
+    )
+    {
+        AZ_Assert(gatherParams.m_travelSpeed > 0.0f, "EnqueueGatherMultisegment called with an invalid travel speed! Use EnqueueGather instead.");
+
+        MultisegmentPath path;
+        ComputeMultisegmentPath(gatherParams, deltaTime, inOutActiveShot, path);
+
+        const ActivateEvent eventData{ inOutActiveShot.m_initialTransform, inOutActiveShot.m_targetPosition, Multiplayer::InvalidNetEntityId, Multiplayer::InvalidNetEntityId };
+        const uint32_t queryIndex = AddQuery(gatherParams, eventData, filteredNetEntityIds, listener, userData);
+        m_pendingQueries.m_results[queryIndex] = path.m_result;
+
+        for (uint32_t segment = 0; segment + 1 < path.m_points.size(); ++segment)
+        {
+            const AZ::Vector3& currSegmentPosition = path.m_points[segment];
+            const AZ::Vector3& nextSegmentPosition = path.m_points[segment + 1];
+            AddSegment(AZ::Transform::CreateLookAt(currSegmentPosition, nextSegmentPosition), nextSegmentPosition - currSegmentPosition);
+        }
+
+        inOutActiveShot.m_lifetimeSeconds = LifetimeSec(inOutActiveShot.m_lifetimeSeconds + deltaTime);
+    }
+
+    void WeaponQueryBatch::Cancel(const WeaponQueryListener& listener)
+    {
+        for (QueryBuffers* queries : { &m_pendingQueries, &m_executingQueries })
+        {
+            for (WeaponQueryListener*& queryListener : queries->m_listeners)
+            {
+                if (queryListener == &listener)
+                {
+                    queryListener = nullptr;
+                }
+            }
+        }
+    }
+
+    void WeaponQueryBatch::Flush()
+    {
+        if (m_pendingQueries.m_queryCount == 0)
+        {
+            return;
+        }
+
+        // Listeners may enqueue new queries while being notified, those go to the next flush
+        AZStd::swap(m_pendingQueries, m_executingQueries);
+        QueryBuffers& queries = m_executingQueries;
+        const uint32_t queryCount = queries.m_queryCount;
+
+        if (m_intersectResults.size() < queryCount)
+        {
+            m_intersectResults.resize(queryCount);
+        }
+
+        for (uint32_t queryIndex = 0; queryIndex < queryCount; ++queryIndex)
+        {
+            m_intersectResults[queryIndex].clear();
+        }
+
+        const AzPhysics::SceneHandle sceneHandle = SceneQuery::GetDefaultSceneHandle();
+
+        if (sceneHandle != AzPhysics::InvalidSceneHandle)
+        {
+            // Sort queries so that all queries issued under the same rewind state are adjacent, ties keep enqueue order
+            m_sortedQueryIndices.resize(queryCount);
+            for (uint32_t queryIndex = 0; queryIndex < queryCount; ++queryIndex)
+            {
+                m_sortedQueryIndices[queryIndex] = queryIndex;
+            }
+
+            AZStd::sort(m_sortedQueryIndices.begin(), m_sortedQueryIndices.end(), [&queries](uint32_t lhs, uint32_t rhs)
+            {
+                const RewindContext& lhsContext = queries.m_rewindContexts[lhs];
+                const RewindContext& rhsContext = queries.m_rewindContexts[rhs];
+                if (lhsContext != rhsContext)
+                {
+                    return lhsContext < rhsContext;
+                }
+                return lhs < rhs;
+            });
+
+            uint32_t groupStart = 0;
+            while (groupStart < queryCount)
+            {
+                const RewindContext& rewindContext = queries.m_rewindContexts[m_sortedQueryIndices[groupStart]];
+                uint32_t groupEnd = groupStart + 1;
+                while ((groupEnd < queryCount) && (queries.m_rewindContexts[m_sortedQueryIndices[groupEnd]] == rewindContext))
+                {
+                    ++groupEnd;
+                }
+
+                if (rewindContext.m_frameId != Multiplayer::InvalidHostFrameId)
+                {
+                    // Execute under the same rewound time the queries were issued under
+                    Multiplayer::ScopedAlterTime scopedTime(rewindContext.m_frameId, rewindContext.m_timeMs, rewindContext.m_blendFactor, rewindContext.m_connectionId);
+                    ExecuteGroup(sceneHandle, &m_sortedQueryIndices[groupStart], groupEnd - groupStart);
+                    Multiplayer::GetNetworkTime()->ClearRewoundEntities();
+                }
+                else
+                {
+                    ExecuteGroup(sceneHandle, &m_sortedQueryIndices[groupStart], groupEnd - groupStart);
+                }
+
+                groupStart = groupEnd;
+            }
+        }
+        else
+        {
+            AZ_Warning("WeaponQueryBatch", false, "Default Physics world must be created, dropping %u weapon queries", queryCount);
+        }
+
+        // Notify listeners in the order queries were enqueued
+        for (uint32_t queryIndex = 0; queryIndex < queryCount; ++queryIndex)
+        {
+            // Re-read the listener each iteration as a listener may cancel queries while being notified
+            if (WeaponQueryListener* listener = queries.m_listeners[queryIndex])
+            {
+                listener->OnWeaponQueryComplete(queries.m_userData[queryIndex], queries.m_events[queryIndex], queries.m_results[queryIndex], m_intersectResults[queryIndex]);
+            }
+        }
+
+        queries.Clear();
+    }
+
+    uint32_t WeaponQueryBatch::GetPendingQueryCount() const
+    {
+        return m_pendingQueries.m_queryCount;
+    }
+
+    const RewindSyncScope::Stats& WeaponQueryBatch::GetRewindSyncStats() const
+    {
+        return m_rewindSyncStats;
+    }
+
+    void WeaponQueryBatch::ResetRewindSyncStats()
+    {
+        m_rewindSyncStats = RewindSyncScope::Stats();
+    }
+
+    WeaponQueryBatch::RewindContext WeaponQueryBatch::GetCurrentRewindContext()
+    {
+        RewindContext rewindContext;
+        Multiplayer::INetworkTime* networkTime = Multiplayer::GetNetworkTime();
+        if (networkTime->IsTimeRewound())
+        {
+            rewindContext.m_frameId = networkTime->GetHostFrameId();
+            rewindContext.m_timeMs = networkTime->GetHostTimeMs();
+            rewindContext.m_blendFactor = networkTime->GetHostBlendFactor();
+            rewindContext.m_connectionId = networkTime->GetRewindingConnectionId();
+        }
+        return rewindContext;
+    }
+
+    uint32_t WeaponQueryBatch::AddQuery
+    (
+        const GatherParams& gatherParams,
+        const ActivateEvent& eventData,
+        const NetEntityIdSet& filteredNetEntityIds,
+        WeaponQueryListener& listener,
+        uint32_t userData
+    )
+    {
+        QueryBuffers& queries = m_pendingQueries;
+        const uint32_t queryIndex = queries.m_queryCount++;
+
+        queries.m_gatherParams.push_back(&gatherParams);
+        queries.m_events.push_back(eventData);
+        queries.m_rewindContexts.push_back(GetCurrentRewindContext());
+        queries.m_listeners.push_back(&listener);
+        queries.m_userData.push_back(userData);
+        queries.m_firstSegments.push_back(aznumeric_cast<uint32_t>(queries.m_segmentPoses.size()));
+        queries.m_segmentCounts.push_back(0);
+        queries.m_results.push_back(ShotResult::DoNotTerminate);
+        queries.m_filteredNetEntityIds.push_back(&filteredNetEntityIds);
+
+        return queryIndex;
+    }
+
+    void WeaponQueryBatch::AddSegment(const AZ::Transform& pose, const AZ::Vector3& sweep)
+    {
+        QueryBuffers& queries = m_pendingQueries;
+        queries.m_segmentPoses.push_back(pose);
+        queries.m_segmentSweeps.push_back(sweep);
+        ++queries.m_segmentCounts.back();
+    }
+
+    void WeaponQueryBatch::ExecuteGroup(AzPhysics::SceneHandle sceneHandle, const uint32_t* queryIndices, uint32_t queryCount)
+    {
+        QueryBuffers& queries = m_executingQueries;
+
+        // Every query in the group shares one rewind state, so each region only needs synchronizing once for the whole group
+        RewindSyncScope rewindSyncScope(m_rewindSyncStats);
+
+        for (uint32_t index = 0; index < queryCount; ++index)
+        {
+            const uint32_t queryIndex = queryIndices[index];
+            if (queries.m_listeners[queryIndex] == nullptr)
+            {
+                // Cancelled
+                continue;
+            }
+
+            const uint32_t firstSegment = queries.m_firstSegments[queryIndex];
+            AZ::Aabb rewindBounds = AZ::Aabb::CreateNull();
+            for (uint32_t segment = firstSegment; segment < firstSegment + queries.m_segmentCounts[queryIndex]; ++segment)
+            {
+                const AZ::Vector3& segmentStart = queries.m_segmentPoses[segment].GetTranslation();
+                rewindBounds.AddPoint(segmentStart);
+                rewindBounds.AddPoint(segmentStart + queries.m_segmentSweeps[segment]);
+            }
+
+            if (rewindBounds.IsValid())
+            {
+                rewindSyncScope.SyncEntitiesToRewindState(rewindBounds);
+            }
+
+            const GatherParams& gatherParams = *queries.m_gatherParams[queryIndex];
+            const HitMultiple hitMultiple = gatherParams.m_multiHit ? HitMultiple::Yes : HitMultiple::No;
+            const AzPhysics::CollisionGroup collisionGroup = AzPhysics::GetCollisionGroupById(gatherParams.m_collisionGroupId);
+            IntersectResults& results = m_intersectResults[queryIndex];
+
+            // Segments of a query only differ by pose and sweep, so a single filter is reused for all of them
+            IntersectFilter filter(queries.m_segmentPoses[firstSegment], queries.m_segmentSweeps[firstSegment], AzPhysics::SceneQuery::QueryType::StaticAndDynamic,
+                hitMultiple, collisionGroup, *queries.m_filteredNetEntityIds[queryIndex], gatherParams.GetCurrentShapeConfiguration());
+
+            for (uint32_t segment = firstSegment; segment < firstSegment + queries.m_segmentCounts[queryIndex]; ++segment)
+            {
+                filter.m_initialPose = queries.m_segmentPoses[segment];
+                filter.m_sweep = queries.m_segmentSweeps[segment];
+                SceneQuery::WorldIntersect(sceneHandle, gatherParams.m_gatherShape, filter, results);
+
+                // Terminate the query if we hit something
+                if (!results.empty() && !gatherParams.m_multiHit)
+                {
+                    queries.m_results[queryIndex] = ShotResult::ShouldTerminate;
+                    break;
+                }
+            }
+        }
+    }
+
+    WeaponQueryBatch* GetWeaponQueryBatch()
+    {
+        return sv_WeaponQueryBatching ? AZ::Interface<WeaponQueryBatch>::Get() : nullptr;
+    }
+
+#if MPS_DIAGNOSTICS
+    //! Listener used by the batch benchmark, which only measures query cost.
+    class BenchmarkQueryListener final
+        : public WeaponQueryListener
+    {
+    public:
+        void OnWeaponQueryComplete([[maybe_unused]] uint32_t userData, [[maybe_unused]] const ActivateEvent& eventData,
+            [[maybe_unused]] ShotResult result, const IntersectResults& results) override
+        {
+            m_hitCount += results.size();
+        }
+
+        size_t m_hitCount = 0;
+    };
+
+    static void sv_WeaponQueryBatchBenchmark(const AZ::ConsoleCommandContainer& arguments)
+    {
+        WeaponQueryBatch* weaponQueryBatch = AZ::Interface<WeaponQueryBatch>::Get();
+        if (weaponQueryBatch == nullptr)
+        {
+            AZLOG_WARN("sv_WeaponQueryBatchBenchmark requires the weapon query batch to be active");
+            return;
+        }
+
+        AZStd::fixed_vector<uint32_t, 8> shooterCounts;
+        for (const AZStd::string_view& argument : arguments)
+        {
+            if (shooterCounts.size() < shooterCounts.capacity())
+            {
+                shooterCounts.push_back(aznumeric_cast<uint32_t>(AZStd::stoi(AZStd::string(argument))));
+            }
+        }
+
+        if (shooterCounts.empty())
+        {
+            shooterCounts = { 10, 64, 128 };
+        }
+
+        // Make sure real pending queries don't pollute the batched timings
+        weaponQueryBatch->Flush();
+
+        constexpr uint32_t iterationCount = 100;
+        constexpr float shooterRingRadius = 20.0f;
+        constexpr float shooterHeight = 1.5f;
+
+        GatherParams gatherParams;
+        gatherParams.m_gatherShape = GatherShape::Point;
+        const NetEntityIdSet filteredNetEntityIds;
+        BenchmarkQueryListener listener;
+        IntersectResults results;
+
+        for (const uint32_t shooterCount : shooterCounts)
+        {
+            if (shooterCount == 0)
+            {
+                continue;
+            }
+
+            // Simulated shooters stand on a ring around the level origin and fire across it
+            AZStd::vector<ActivateEvent> events;
+            events.reserve(shooterCount);
+            for (uint32_t shooter = 0; shooter < shooterCount; ++shooter)
+            {
+                const float angle = AZ::Constants::TwoPi * shooter / shooterCount;
+                const AZ::Vector3 source(shooterRingRadius * AZStd::cos(angle), shooterRingRadius * AZStd::sin(angle), shooterHeight);
+                const AZ::Vector3 target(-source.GetX(), -source.GetY(), shooterHeight);
+                events.push_back(ActivateEvent{ AZ::Transform::CreateLookAt(source, target), target, Multiplayer::InvalidNetEntityId, Multiplayer::InvalidNetEntityId });
+            }
+
+            const auto immediateStart = AZStd::chrono::steady_clock::now();
+            for (uint32_t iteration = 0; iteration < iterationCount; ++iteration)
+            {
+                for (const ActivateEvent& eventData : events)
+                {
+                    results.clear();
+                    GatherEntities(gatherParams, eventData, filteredNetEntityIds, results);
+                }
+            }
+            const auto immediateEnd = AZStd::chrono::steady_clock::now();
+
+            for (uint32_t iteration = 0; iteration < iterationCount; ++iteration)
+            {
+                for (const ActivateEvent& eventData : events)
+                {
+                    weaponQueryBatch->EnqueueGather(gatherParams, eventData, filteredNetEntityIds, listener, 0);
+                }
+                weaponQueryBatch->Flush();
+            }
+            const auto batchedEnd = AZStd::chrono::steady_clock::now();
+
+            const float shotCount = aznumeric_cast<float>(iterationCount * shooterCount);
+            const float immediateUs = aznumeric_cast<float>(AZStd::chrono::duration_cast<AZStd::chrono::microseconds>(immediateEnd - immediateStart).count());
+            const float batchedUs = aznumeric_cast<float>(AZStd::chrono::duration_cast<AZStd::chrono::microseconds>(batchedEnd - immediateEnd).count());
+            AZLOG_INFO("WeaponQueryBatch benchmark, %u shooters: per-shot %.3f us, batched %.3f us per shot (%zu hits)",
+                shooterCount, immediateUs / shotCount, batchedUs / shotCount, listener.m_hitCount);
+        }
+
+        const RewindSyncScope::Stats& rewindSyncStats = weaponQueryBatch->GetRewindSyncStats();
+        AZLOG_INFO("WeaponQueryBatch rewind syncs since startup: %llu requested, %llu performed, %llu skipped",
+            aznumeric_cast<unsigned long long>(rewindSyncStats.m_requestedSyncs),
+            aznumeric_cast<unsigned long long>(rewindSyncStats.m_performedSyncs),
+            aznumeric_cast<unsigned long long>(rewindSyncStats.m_skippedSyncs));
+    }
+    AZ_CONSOLEFREEFUNC(sv_WeaponQueryBatchBenchmark, AZ::ConsoleFunctorFlags::Null, "Compares per-shot and batched weapon scene query cost against the loaded level, optionally takes a list of shooter counts");
+
+    static void LogRewindSyncStats(const char* source, const RewindSyncScope::Stats& stats)
+    {
+        const float skippedPercent = (stats.m_requestedSyncs > 0) ? 100.0f * stats.m_skippedSyncs / stats.m_requestedSyncs : 0.0f;
+        AZLOG_INFO("%s rewind syncs: %llu requested, %llu performed, %llu skipped (%.1f%%)", source,
+            aznumeric_cast<unsigned long long>(stats.m_requestedSyncs),
+            aznumeric_cast<unsigned long long>(stats.m_performedSyncs),
+            aznumeric_cast<unsigned long long>(stats.m_skippedSyncs), skippedPercent);
+    }
+
+    static void sv_RewindSyncStats(const AZ::ConsoleCommandContainer& arguments)
+    {
+        const bool reset = !arguments.empty() && (arguments.front() == "reset");
+        if (WeaponQueryBatch* weaponQueryBatch = AZ::Interface<WeaponQueryBatch>::Get())
+        {
+            LogRewindSyncStats("WeaponQueryBatch", weaponQueryBatch->GetRewindSyncStats());
+            if (reset)
+            {
+                weaponQueryBatch->ResetRewindSyncStats();
+            }
+        }
+
+        if (ProjectileStore* projectileStore = AZ::Interface<ProjectileStore>::Get())
+        {
+            LogRewindSyncStats("ProjectileStore", projectileStore->GetRewindSyncStats());
+            if (reset)
+            {
+                projectileStore->ResetRewindSyncStats();
+            }
+        }
+    }
+    AZ_CONSOLEFREEFUNC(sv_RewindSyncStats, AZ::ConsoleFunctorFlags::Null, "Logs how many weapon rewind syncs were requested, performed and skipped, pass 'reset' to reset the counters afterwards");
+#endif
+}
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project. For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+
+#pragma once
+
+#include <Source/Weapons/RewindSyncScope.h>
+#include <Source/Weapons/WeaponGathers.h>
+#include <AzCore/EBus/ScheduledEvent.h>
+#include <AzCore/RTTI/RTTI.h>
+#include <AzNetworking/ConnectionLayer/ConnectionEnums.h>
+
+namespace MultiplayerSample
+{
+    //! @class WeaponQueryListener
+    //! @brief Listener class for deferred WeaponQueryBatch results.
+    class WeaponQueryListener
+    {
+    public:
+        //! Invoked once a batched query has been executed.
+        //! @param userData  the caller provided value the query was enqueued with
+        //! @param eventData the activate event the query was enqueued with
+        //! @param result    ShouldTerminate if the query hit something or exceeded its cast distance, DoNotTerminate otherwise
+        //! @param results   the gathered hits, only valid for the duration of the callback
+        virtual void OnWeaponQueryComplete(uint32_t userData, const ActivateEvent& eventData, ShotResult result, const IntersectResults& results) = 0;
+    };
+
+    //! @class WeaponQueryBatch
+    //! @brief Server side service that defers weapon scene queries and executes all of them once per tick.
+    //! Queries enqueued by every input processed during a tick are executed by the same flush, which then notifies their listeners.
+    //! Queries are stored in structure-of-arrays buffers, grouped by the rewind state they were issued under so every group
+    //! synchronizes each rewindable region once through its own RewindSyncScope, and run against result storage that is reused from tick to tick.
+    class WeaponQueryBatch
+    {
+    public:
+        AZ_RTTI(WeaponQueryBatch, "{5C0B34A5-2C6B-4F1E-8F3C-7A0E6D41B8D2}");
+
+        WeaponQueryBatch();
+        virtual ~WeaponQueryBatch();
+
+        //! Enqueues a single swept gather from the activate event's initial transform to its target position.
+        //! @param gatherParams         the gather parameters to use, must remain valid until the query completes or is cancelled
+        //! @param eventData            details of the activation the gather is performed for
+        //! @param filteredNetEntityIds set of net entities to exclude from the gather, must remain valid and unchanged until the query completes or is cancelled
+        //! @param listener             the listener to notify once the query has executed
+        //! @param userData             caller provided value passed back to the listener
+        void EnqueueGather
+        (
+            const GatherParams&   gatherParams,
+            const ActivateEvent&  eventData,
+            const NetEntityIdSet& filteredNetEntityIds,
+            WeaponQueryListener&  listener,
+            uint32_t              userData
+        );
+
+        //! Enqueues all segment casts an active shot performs over the next deltaTime seconds, the shot lifetime is advanced immediately.
+        //! @param gatherParams         the gather parameters to use, must remain valid until the query completes or is cancelled
+        //! @param filteredNetEntityIds set of net entities to exclude from the gather, must remain valid and unchanged until the query completes or is cancelled
+        //! @param deltaTime            the amount of time the shot is travelling for
+        //! @param inOutActiveShot      the active shot to gather for
+        //! @param listener             the listener to notify once the query has executed
+        //! @param userData             caller provided value passed back to the listener
+        void EnqueueGatherMultisegment
+        (
+            const GatherParams&   gatherParams,
+            const NetEntityIdSet& filteredNetEntityIds,
+            float                 deltaTime,
+            ActiveShot&           inOutActiveShot,
+            WeaponQueryListener&  listener,
+            uint32_t              userData
+        );
+
+        //! Drops all pending queries for the provided listener, must be called before a listener is destroyed.
+        //! @param listener the listener to cancel pending queries for
+        void Cancel(const WeaponQueryListener& listener);
+
+        //! Executes all pending queries and notifies their listeners.
+        void Flush();
+
+        //! Returns the number of queries waiting for the next flush.
+        //! @return the number of pending queries
+        uint32_t GetPendingQueryCount() const;
+
+        //! Returns the rewind synchronization counters accumulated by all flushes since the batch was created.
+        //! @return the rewind synchronization counters
+        const RewindSyncScope::Stats& GetRewindSyncStats() const;
+
+        //! Resets the rewind synchronization counters.
+        void ResetRewindSyncStats();
+
+    private:
+        //! The network time state a query was issued under, rewound queries are executed under the same state.
+        struct RewindContext
+        {
+            Multiplayer::HostFrameId m_frameId = Multiplayer::InvalidHostFrameId;
+            AZ::TimeMs m_timeMs = AZ::Time::ZeroTimeMs;
+            float m_blendFactor = 1.0f;
+            AzNetworking::ConnectionId m_connectionId = AzNetworking::InvalidConnectionId;
+
+            bool operator==(const RewindContext& rhs) const;
+            bool operator!=(const RewindContext& rhs) const;
+            bool operator<(const RewindContext& rhs) const; // Orders by every field operator== compares
+        };
+
+        //! Structure-of-arrays storage for one tick worth of queries.
+        struct QueryBuffers
+        {
+            // Per query data
+            AZStd::vector<const GatherParams*> m_gatherParams;
+            AZStd::vector<ActivateEvent> m_events;
+            AZStd::vector<RewindContext> m_rewindContexts;
+            AZStd::vector<WeaponQueryListener*> m_listeners;
+            AZStd::vector<uint32_t> m_userData;
+            AZStd::vector<uint32_t> m_firstSegments;
+            AZStd::vector<uint32_t> m_segmentCounts;
+            AZStd::vector<ShotResult> m_results;
+            AZStd::vector<const NetEntityIdSet*> m_filteredNetEntityIds; // Owned by the listener, like the gather params
+
+            // Per segment data, a query casts segments [m_firstSegments[N], m_firstSegments[N] + m_segmentCounts[N])
+            AZStd::vector<AZ::Transform> m_segmentPoses;
+            AZStd::vector<AZ::Vector3> m_segmentSweeps;
+
+            uint32_t m_queryCount = 0;
+
+            void Clear();
+        };
+
+        static RewindContext GetCurrentRewindContext();
+        uint32_t AddQuery(const GatherParams& gatherParams, const ActivateEvent& eventData, const NetEntityIdSet& filteredNetEntityIds, WeaponQueryListener& listener, uint32_t userData);
+        void AddSegment(const AZ::Transform& pose, const AZ::Vector3& sweep);
+        void ExecuteGroup(AzPhysics::SceneHandle sceneHandle, const uint32_t* queryIndices, uint32_t queryCount);
+
+        QueryBuffers m_pendingQueries;   // Queries enqueued since the last flush
+        QueryBuffers m_executingQueries; // Queries being executed by the current flush, swapped with m_pendingQueries on flush
+        AZStd::vector<IntersectResults> m_intersectResults; // Per query result storage, reused across flushes
+        AZStd::vector<uint32_t> m_sortedQueryIndices;
+        RewindSyncScope::Stats m_rewindSyncStats;
+
+        AZ::ScheduledEvent m_flushEvent{ [this]()
+        {
+            Flush();
+        }, AZ::Name("WeaponQueryBatchFlush") };
+    };
+
+    //! Returns the weapon query batch if one is active and batching is enabled.
+    //! @return the weapon query batch, or nullptr if gathers should be performed immediately
+    WeaponQueryBatch* GetWeaponQueryBatch();
+}
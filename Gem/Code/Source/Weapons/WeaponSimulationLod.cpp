@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project. For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+
+#include <Source/Weapons/WeaponSimulationLod.h>
+#include <Source/MultiplayerSampleTypes.h>
+#include <Source/Weapons/SceneQuery.h>
+#include <Source/Weapons/WeaponGathers.h>
+#include <AzCore/Console/IConsole.h>
+#include <AzCore/Console/ILogger.h>
+#include <AzCore/Math/MathUtils.h>
+#include <AzCore/std/chrono/chrono.h>
+
+#if AZ_TRAIT_CLIENT
+#   include <Atom/RPI.Public/ViewportContext.h>
+#   include <Atom/RPI.Public/ViewportContextBus.h>
+#endif
+
+namespace MultiplayerSample
+{
+    AZ_CVAR(bool, cl_WeaponsSimulationLod, true, nullptr, AZ::ConsoleFunctorFlags::Null, "If true, remote weapon shots are simulated with less detail the further they are from the local camera");
+    AZ_CVAR(float, cl_WeaponsLodFullDistance, 40.0f, nullptr, AZ::ConsoleFunctorFlags::Null, "Remote weapon shots passing within this many meters of the camera are fully simulated");
+    AZ_CVAR(float, cl_WeaponsLodCullDistance, 150.0f, nullptr, AZ::ConsoleFunctorFlags::Null, "Remote weapon shots passing further than this many meters from the camera are not simulated at all");
+    AZ_CVAR(float, cl_WeaponsLodCullBehindDot, -0.25f, nullptr, AZ::ConsoleFunctorFlags::Null, "Remote weapon shots outside the full distance are culled if the camera forward dot the direction to the shot is below this");
+
+    const char* GetEnumString(WeaponSimulationLod value)
+    {
+        switch (value)
+        {
+        case WeaponSimulationLod::Full:
+            return "Full";
+        case WeaponSimulationLod::EndpointOnly:
+            return "EndpointOnly";
+        case WeaponSimulationLod::Culled:
+            return "Culled";
+        }
+        return "Unknown";
+    }
+
+    bool GetWeaponLodViewer([[maybe_unused]] WeaponLodViewer& outViewer)
+    {
+#if AZ_TRAIT_CLIENT
+        if (!cl_WeaponsSimulationLod)
+        {
+            return false;
+        }
+
+        auto* viewportContextRequests = AZ::RPI::ViewportContextRequests::Get();
+        AZ::RPI::ViewportContextPtr viewport = (viewportContextRequests != nullptr) ? viewportContextRequests->GetDefaultViewportContext() : nullptr;
+        if (viewport == nullptr)
+        {
+            return false;
+        }
+
+        const AZ::Transform cameraTransform = viewport->GetCameraTransform();
+        outViewer.m_position = cameraTransform.GetTranslation();
+        outViewer.m_forward = cameraTransform.GetBasisY();
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    WeaponSimulationLod ComputeWeaponSimulationLod(const WeaponLodViewer& viewer, const AZ::Vector3& shotStart, const AZ::Vector3& shotEnd)
+    {
+        // Shots are judged by the closest point of their path, a shot fired from far away can still pass right by the camera
+        const AZ::Vector3 shotPath = shotEnd - shotStart;
+        const float pathLengthSq = shotPath.GetLengthSq();
+        const float closestFraction = (pathLengthSq > AZ::Constants::FloatEpsilon)
+            ? AZ::GetClamp((viewer.m_position - shotStart).Dot(shotPath) / pathLengthSq, 0.0f, 1.0f)
+            : 0.0f;
+        const AZ::Vector3 toShot = (shotStart + shotPath * closestFraction) - viewer.m_position;
+        const float distanceSq = toShot.GetLengthSq();
+
+        const float fullDistance = cl_WeaponsLodFullDistance;
+        if (distanceSq <= fullDistance * fullDistance)
+        {
+            return WeaponSimulationLod::Full;
+        }
+
+        const float cullDistance = AZStd::max<float>(cl_WeaponsLodCullDistance, fullDistance);
+        if ((distanceSq > cullDistance * cullDistance) || (viewer.m_forward.Dot(toShot.GetNormalized()) < cl_WeaponsLodCullBehindDot))
+        {
+            return WeaponSimulationLod::Culled;
+        }
+
+        return WeaponSimulationLod::EndpointOnly;
+    }
+
+#if MPS_DIAGNOSTICS
+    static void cl_WeaponsSimulationLodBenchmark(const AZ::ConsoleCommandContainer& arguments)
+    {
+        if (SceneQuery::GetDefaultSceneHandle() == AzPhysics::InvalidSceneHandle)
+        {
+            AZLOG_WARN("cl_WeaponsSimulationLodBenchmark requires a loaded level");
+            return;
+        }
+
+        const uint32_t shooterCount = (arguments.size() > 0) ? aznumeric_cast<uint32_t>(AZStd::stoi(AZStd::string(arguments[0]))) : 100;
+        const uint32_t tickCount = (arguments.size() > 1) ? aznumeric_cast<uint32_t>(AZStd::stoi(AZStd::string(arguments[1]))) : 60;
+        constexpr float tickSeconds = 1.0f / 60.0f;
+        constexpr float shooterHeight = 1.5f;
+
+        GatherParams gatherParams;
+        gatherParams.m_castDistance = 2000.0f;
+        gatherParams.m_travelSpeed = 200.0f;
+        const NetEntityIdSet filteredNetEntityIds;
+
+        // Shooters spread from point blank out to twice the cull distance, all firing across the level in varying directions
+        const WeaponLodViewer viewer{ AZ::Vector3(0.0f, 0.0f, shooterHeight), AZ::Vector3::CreateAxisY() };
+        const float maxDistance = AZStd::max<float>(cl_WeaponsLodCullDistance, 1.0f) * 2.0f;
+        AZStd::vector<ActiveShot> shots;
+        AZStd::vector<WeaponSimulationLod> lods;
+        uint32_t lodCounts[3] = {};
+        for (uint32_t shooter = 0; shooter < shooterCount; ++shooter)
+        {
+            const float angle = 2.399963f * shooter; // Golden angle
+            const float distance = maxDistance * (shooter + 1) / shooterCount;
+            const AZ::Vector3 source(distance * AZStd::cos(angle), distance * AZStd::sin(angle), shooterHeight);
+            const AZ::Vector3 target = source + AZ::Vector3(AZStd::cos(angle * 3.0f), AZStd::sin(angle * 3.0f), 0.0f) * 100.0f;
+            shots.push_back(ActiveShot{ AZ::Transform::CreateLookAt(source, target), target, LifetimeSec{ 0.0f } });
+            lods.push_back(ComputeWeaponSimulationLod(viewer, source, target));
+            ++lodCounts[static_cast<uint32_t>(lods.back())];
+        }
+
+        // Time the same shots fully simulated and simulated at their level of detail
+        float elapsedUs[2] = {};
+        for (const bool useLod : { false, true })
+        {
+            const auto start = AZStd::chrono::steady_clock::now();
+            for (uint32_t shooter = 0; shooter < shooterCount; ++shooter)
+            {
+                const WeaponSimulationLod lod = useLod ? lods[shooter] : WeaponSimulationLod::Full;
+                ActiveShot shot = shots[shooter];
+                for (uint32_t tick = 0; (tick < tickCount) && (lod != WeaponSimulationLod::Culled); ++tick)
+                {
+                    if (lod == WeaponSimulationLod::Full)
+                    {
+                        IntersectResults results;
+                        if (GatherEntitiesMultisegment(gatherParams, filteredNetEntityIds, tickSeconds, shot, results) == ShotResult::ShouldTerminate)
+                        {
+                            break;
+                        }
+                    }
+                    else
+                    {
+                        shot.m_lifetimeSeconds = LifetimeSec(shot.m_lifetimeSeconds + tickSeconds);
+                    }
+                }
+            }
+            elapsedUs[useLod ? 1 : 0] = aznumeric_cast<float>(AZStd::chrono::duration_cast<AZStd::chrono::microseconds>(AZStd::chrono::steady_clock::now() - start).count());
+        }
+
+        AZLOG_INFO("Weapon simulation lod benchmark, %u shooters over %u ticks: %u full, %u endpoint only, %u culled. Full simulation %.1f us, with lod %.1f us",
+            shooterCount, tickCount, lodCounts[0], lodCounts[1], lodCounts[2], elapsedUs[0], elapsedUs[1]);
+    }
+    AZ_CONSOLEFREEFUNC(cl_WeaponsSimulationLodBenchmark, AZ::ConsoleFunctorFlags::Null, "Times remote shots from synthetic shooters with and without simulation level of detail, optionally takes a shooter count and a tick count");
+#endif
+}
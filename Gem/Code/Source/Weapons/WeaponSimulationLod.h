@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project. For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+
+#pragma once
+
+#include <AzCore/Math/Vector3.h>
+
+namespace MultiplayerSample
+{
+    //! Level of detail used when simulating the shots of a remote proxy's weapon on a client.
+    //! Only simulated proxies use these levels, authoritative and autonomous weapons always simulate fully.
+    enum class WeaponSimulationLod
+    {
+        Full,         // Shots are gathered every tick and play their hit effects
+        EndpointOnly, // Shots skip their gathers and play a single impact effect at their target once they'd have arrived
+        Culled        // Shots are dropped without effects
+    };
+    const char* GetEnumString(WeaponSimulationLod value);
+
+    //! @struct WeaponLodViewer
+    //! @brief The point of view simulated weapon levels of detail are chosen for.
+    struct WeaponLodViewer
+    {
+        AZ::Vector3 m_position = AZ::Vector3::CreateZero();
+        AZ::Vector3 m_forward = AZ::Vector3::CreateAxisY();
+    };
+
+    //! Returns the local viewer to pick simulated weapon levels of detail for.
+    //! @param outViewer the viewer position and forward direction
+    //! @return false if level of detail is disabled or there is no local viewer, in which case everything should simulate fully
+    bool GetWeaponLodViewer(WeaponLodViewer& outViewer);
+
+    //! Picks the level of detail for shots travelling from shotStart towards shotEnd.
+    //! @param viewer    the local viewer
+    //! @param shotStart the position the shots were fired from
+    //! @param shotEnd   the position the shots are travelling towards
+    //! @return the level of detail to simulate the shots with
+    WeaponSimulationLod ComputeWeaponSimulationLod(const WeaponLodViewer& viewer, const AZ::Vector3& shotStart, const AZ::Vector3& shotEnd);
+}
@@ -349,7 +349,8 @@ namespace MultiplayerSample
     {
         return serializer.Serialize(m_hitPosition, "HitPosition")
             && serializer.Serialize(m_hitNormal, "HitNormal")
-            && serializer.Serialize(m_hitNetEntityId, "HitNetEntityId");
+            && serializer.Serialize(m_hitNetEntityId, "HitNetEntityId")
+            && serializer.Serialize(m_surfaceIndex, "SurfaceIndex");
     }
 
     void HitEntity::Reflect(AZ::ReflectContext* context)
@@ -358,10 +359,11 @@ namespace MultiplayerSample
         if (serializeContext)
         {
             serializeContext->Class<HitEntity>()
-                ->Version(1)
+                ->Version(2)
                 ->Field("HitPosition", &HitEntity::m_hitPosition)
                 ->Field("HitNormal", &HitEntity::m_hitNormal)
-                ->Field("HitNetEntityId", &HitEntity::m_hitNetEntityId);
+                ->Field("HitNetEntityId", &HitEntity::m_hitNetEntityId)
+                ->Field("SurfaceIndex", &HitEntity::m_surfaceIndex);
         }
 
         AZ::BehaviorContext* behaviorContext = azrtti_cast<AZ::BehaviorContext*>(context);
@@ -375,10 +377,24 @@ namespace MultiplayerSample
                 ->Property("HitPosition", BehaviorValueProperty(&HitEntity::m_hitPosition))
                 ->Property("HitNormal", BehaviorValueProperty(&HitEntity::m_hitNormal))
                 ->Property("HitNetEntityId", BehaviorValueProperty(&HitEntity::m_hitNetEntityId))
+                ->Property("SurfaceIndex", BehaviorValueProperty(&HitEntity::m_surfaceIndex))
                 ;
         }
     }
 
+    AZStd::vector<HitEntity> HitEvent::GetHitEntities() const
+    {
+        return AZStd::vector<HitEntity>(m_hitEntities.begin(), m_hitEntities.end());
+    }
+
+    void HitEvent::SetHitEntities(const AZStd::vector<HitEntity>& hitEntities)
+    {
+        AZ_Warning("HitEvent", hitEntities.size() <= m_hitEntities.capacity(), "Hit event limited to %u hit entities, dropping %zu",
+            MaxHitEntities, hitEntities.size() - AZStd::min<size_t>(hitEntities.size(), m_hitEntities.capacity()));
+        const size_t hitCount = AZStd::min<size_t>(hitEntities.size(), m_hitEntities.capacity());
+        m_hitEntities.assign(hitEntities.begin(), hitEntities.begin() + hitCount);
+    }
+
     bool HitEvent::operator!=(const HitEvent& rhs) const
     {
         if ((m_target != rhs.m_target) ||
@@ -393,6 +409,7 @@ namespace MultiplayerSample
         for (size_t index = 0; index < m_hitEntities.size(); index++)
         {
             if ((m_hitEntities[index].m_hitNetEntityId != rhs.m_hitEntities[index].m_hitNetEntityId) ||
+                (m_hitEntities[index].m_surfaceIndex != rhs.m_hitEntities[index].m_surfaceIndex) ||
                 (!m_hitEntities[index].m_hitPosition.IsClose(rhs.m_hitEntities[index].m_hitPosition)) ||
                 (!m_hitEntities[index].m_hitNormal.IsClose(rhs.m_hitEntities[index].m_hitNormal)))
             {
@@ -435,7 +452,7 @@ namespace MultiplayerSample
                 ->Property("Target", BehaviorValueProperty(&HitEvent::m_target))
                 ->Property("ShooterNetEntityId", BehaviorValueProperty(&HitEvent::m_shooterNetEntityId))
                 ->Property("ProjectileNetEntityId", BehaviorValueProperty(&HitEvent::m_projectileNetEntityId))
-                ->Property("HitEntities", BehaviorValueProperty(&HitEvent::m_hitEntities))
+                ->Property("HitEntities", &HitEvent::GetHitEntities, &HitEvent::SetHitEntities)
                 ;
         }
     }
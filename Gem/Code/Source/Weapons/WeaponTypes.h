@@ -11,6 +11,9 @@
 #include <Source/Effects/GameEffect.h>
 #include <Multiplayer/MultiplayerTypes.h>
 #include <AzCore/RTTI/TypeSafeIntegral.h>
+#include <AzCore/std/containers/fixed_vector.h>
+#include <AzCore/std/containers/vector.h>
+#include <AzCore/std/limits.h>
 #include <AzFramework/Physics/ShapeConfiguration.h>
 
 namespace MultiplayerSample
@@ -21,6 +24,13 @@ namespace MultiplayerSample
     constexpr uint32_t MaxActiveShots = 32; // Maximum number of concurrently shots active for a single weapon
     constexpr uint32_t MaxHitEntities = 48; // Maximum number of entities that can be hit by a single shot
 
+    using SurfaceIndex = uint8_t; // Compact index of the surface type that was hit, see SurfaceTypeRegistry
+    constexpr SurfaceIndex DefaultSurfaceIndex = 0; // Surface index used for any material that doesn't map to a listed surface type
+    constexpr SurfaceIndex MaxSurfaceIndex = AZStd::numeric_limits<SurfaceIndex>::max();
+
+    using WeaponDefinitionIndex = uint8_t; // Compact index of a shared weapon definition, see WeaponDefinitionLibrary
+    constexpr WeaponDefinitionIndex InvalidWeaponDefinitionIndex = AZStd::numeric_limits<WeaponDefinitionIndex>::max();
+
     // WeaponActivationBitset
     // Bitset used to represent which weapons have been activated for a specific input frame
     using WeaponActivationBitset = AzNetworking::FixedSizeBitset<MaxWeaponsPerComponent, uint8_t>;
@@ -175,11 +185,12 @@ namespace MultiplayerSample
         AZ::Vector3 m_hitPosition = AZ::Vector3::CreateZero(); // Location where the entity was hit, NOT the location of the projectile or weapon in the case of area damage
         AZ::Vector3 m_hitNormal = AZ::Vector3::CreateZero();
         Multiplayer::NetEntityId m_hitNetEntityId = Multiplayer::InvalidNetEntityId; // Entity Id of the entity which was hit
+        SurfaceIndex m_surfaceIndex = DefaultSurfaceIndex; // Surface type that was hit, used to select impact effects
 
         bool Serialize(AzNetworking::ISerializer& serializer);
         static void Reflect(AZ::ReflectContext* context);
     };
-    using HitEntities = AZStd::vector<HitEntity>;
+    using HitEntities = AZStd::fixed_vector<HitEntity, MaxHitEntities>; // Fixed capacity so that building hit events never allocates
 
     //! Structure containing details for a single weapon hit event.
     struct HitEvent
@@ -191,6 +202,13 @@ namespace MultiplayerSample
         Multiplayer::NetEntityId m_projectileNetEntityId = Multiplayer::InvalidNetEntityId; // Entity Id of the projectile, InvalidNetEntityId if this was a trace weapon hit
         HitEntities m_hitEntities; // Information about the entities that were hit
 
+        //! Script accessors, script can't use the fixed capacity container directly so hit entities are copied in and out.
+        //! Only script access copies, weapons and the network layer use m_hitEntities directly.
+        //! @{
+        AZStd::vector<HitEntity> GetHitEntities() const;
+        void SetHitEntities(const AZStd::vector<HitEntity>& hitEntities); // Hits beyond MaxHitEntities are dropped
+        //! @}
+
         bool operator!=(const HitEvent& rhs) const;
         bool Serialize(AzNetworking::ISerializer& serializer);
         static void Reflect(AZ::ReflectContext* context);
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project. For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+
+#include <AzCore/UnitTest/TestTypes.h>
+#include <AzCore/std/containers/array.h>
+#include <AzNetworking/Serialization/NetworkInputSerializer.h>
+#include <AzNetworking/Serialization/NetworkOutputSerializer.h>
+#include <Source/Weapons/HitConfirmBatch.h>
+
+namespace UnitTest
+{
+    using namespace MultiplayerSample;
+
+    class HitConfirmBatchTests
+        : public LeakDetectionFixture
+    {
+    };
+
+    TEST_F(HitConfirmBatchTests, OctahedralNormal_RoundTripsWithinADegree)
+    {
+        // An 8 bit per axis octahedral normal stays within about a degree of the source normal
+        constexpr float MinNormalDot = 0.999f;
+        const AZ::Vector3 normals[] =
+        {
+            AZ::Vector3::CreateAxisX(), AZ::Vector3::CreateAxisY(), AZ::Vector3::CreateAxisZ(),
+            -AZ::Vector3::CreateAxisX(), -AZ::Vector3::CreateAxisY(), -AZ::Vector3::CreateAxisZ(),
+            AZ::Vector3(1.0f, 1.0f, 1.0f).GetNormalized(), AZ::Vector3(-1.0f, 1.0f, -1.0f).GetNormalized(),
+            AZ::Vector3(0.3f, -0.8f, -0.2f).GetNormalized(), AZ::Vector3(-0.6f, -0.1f, 0.7f).GetNormalized()
+        };
+
+        for (const AZ::Vector3& normal : normals)
+        {
+            const AZ::Vector3 decoded = DecodeOctahedralNormal(EncodeOctahedralNormal(normal));
+            EXPECT_TRUE(decoded.IsNormalized());
+            EXPECT_GE(decoded.Dot(normal), MinNormalDot);
+        }
+    }
+
+    TEST_F(HitConfirmBatchTests, OctahedralNormal_ZeroNormalDecodesToUp)
+    {
+        EXPECT_TRUE(DecodeOctahedralNormal(EncodeOctahedralNormal(AZ::Vector3::CreateZero())).IsClose(AZ::Vector3::CreateAxisZ(), 0.01f));
+    }
+
+    TEST_F(HitConfirmBatchTests, Serialize_RoundTripsHitEvents)
+    {
+        const AZ::Vector3 shotOrigin(812.5f, -371.25f, 42.0f);
+
+        HitEvent hitEvent;
+        hitEvent.m_target = shotOrigin + AZ::Vector3(150.0f, -20.0f, 3.0f);
+        hitEvent.m_projectileNetEntityId = Multiplayer::NetEntityId{ 7 };
+        hitEvent.m_hitEntities.emplace_back(HitEntity{ shotOrigin + AZ::Vector3(15.25f, -2.0f, 0.5f),
+            AZ::Vector3(0.3f, -0.8f, 0.2f).GetNormalized(), Multiplayer::NetEntityId{ 100 }, SurfaceIndex{ 1 } });
+        hitEvent.m_hitEntities.emplace_back(HitEntity{ shotOrigin + AZ::Vector3(-40.0f, 8.75f, -1.5f),
+            -AZ::Vector3::CreateAxisZ(), Multiplayer::NetEntityId{ 101 }, SurfaceIndex{ 2 } });
+
+        HitConfirmBatch batch;
+        ASSERT_TRUE(batch.TryAddHitEvent(WeaponIndex{ 1 }, shotOrigin, hitEvent));
+
+        AZStd::array<uint8_t, 1024> buffer;
+        AzNetworking::NetworkInputSerializer writer(buffer.data(), aznumeric_cast<uint32_t>(buffer.size()));
+        ASSERT_TRUE(batch.Serialize(writer));
+
+        HitConfirmBatch receivedBatch;
+        AzNetworking::NetworkOutputSerializer reader(buffer.data(), writer.GetSize());
+        ASSERT_TRUE(receivedBatch.Serialize(reader));
+        EXPECT_TRUE(receivedBatch.m_batchOrigin.IsClose(shotOrigin));
+
+        // One quantum of the offset range per axis
+        constexpr float MaxPositionError = 2.0f * HitOffsetRange / (1 << 16) * 2.0f;
+        uint32_t visitCount = 0;
+        receivedBatch.VisitHitEvents(Multiplayer::NetEntityId{ 1 }, [&](WeaponIndex weaponIndex, const HitEvent& receivedHitEvent)
+        {
+            ++visitCount;
+            EXPECT_EQ(weaponIndex, WeaponIndex{ 1 });
+            EXPECT_EQ(receivedHitEvent.m_shooterNetEntityId, Multiplayer::NetEntityId{ 1 });
+            EXPECT_EQ(receivedHitEvent.m_projectileNetEntityId, hitEvent.m_projectileNetEntityId);
+            EXPECT_LE(receivedHitEvent.m_target.GetDistance(hitEvent.m_target), MaxPositionError);
+            ASSERT_EQ(receivedHitEvent.m_hitEntities.size(), hitEvent.m_hitEntities.size());
+            for (size_t hit = 0; hit < hitEvent.m_hitEntities.size(); ++hit)
+            {
+                const HitEntity& sent = hitEvent.m_hitEntities[hit];
+                const HitEntity& received = receivedHitEvent.m_hitEntities[hit];
+                EXPECT_LE(received.m_hitPosition.GetDistance(sent.m_hitPosition), MaxPositionError);
+                EXPECT_GE(received.m_hitNormal.Dot(sent.m_hitNormal), 0.999f);
+                EXPECT_EQ(received.m_hitNetEntityId, sent.m_hitNetEntityId);
+                EXPECT_EQ(received.m_surfaceIndex, sent.m_surfaceIndex);
+            }
+        });
+        EXPECT_EQ(visitCount, 1u);
+    }
+
+    TEST_F(HitConfirmBatchTests, TryAddHitEvent_RejectsHitsOutOfRangeOfTheBatchOrigin)
+    {
+        const AZ::Vector3 shotOrigin = AZ::Vector3::CreateZero();
+        HitEvent nearHitEvent;
+        nearHitEvent.m_target = AZ::Vector3(10.0f, 0.0f, 0.0f);
+        HitEvent farHitEvent;
+        farHitEvent.m_target = AZ::Vector3(4.0f * HitOffsetRange, 0.0f, 0.0f);
+
+        // The first event of a batch is always accepted, the batch is centered on it when it is out of range of the shot
+        HitConfirmBatch batch;
+        EXPECT_TRUE(batch.TryAddHitEvent(WeaponIndex{ 0 }, shotOrigin, farHitEvent));
+        EXPECT_TRUE(batch.m_batchOrigin.IsClose(farHitEvent.m_target));
+        EXPECT_FALSE(batch.TryAddHitEvent(WeaponIndex{ 0 }, shotOrigin, nearHitEvent));
+        EXPECT_EQ(batch.m_hitEvents.size(), 1u);
+
+        batch.Clear();
+        EXPECT_TRUE(batch.IsEmpty());
+        EXPECT_TRUE(batch.TryAddHitEvent(WeaponIndex{ 0 }, shotOrigin, nearHitEvent));
+        EXPECT_FALSE(batch.TryAddHitEvent(WeaponIndex{ 0 }, shotOrigin, farHitEvent));
+    }
+
+    TEST_F(HitConfirmBatchTests, TryAddHitEvent_RejectsEventsOnceTheBatchIsFull)
+    {
+        HitEvent hitEvent;
+        HitConfirmBatch batch;
+        for (uint32_t eventIndex = 0; eventIndex < MaxBatchedHitEvents; ++eventIndex)
+        {
+            EXPECT_TRUE(batch.TryAddHitEvent(WeaponIndex{ 0 }, AZ::Vector3::CreateZero(), hitEvent));
+        }
+        EXPECT_FALSE(batch.TryAddHitEvent(WeaponIndex{ 0 }, AZ::Vector3::CreateZero(), hitEvent));
+    }
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project. For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+
+#include <AzCore/UnitTest/TestTypes.h>
+#include <Source/Components/InputActionMap.h>
+
+namespace UnitTest
+{
+    using namespace MultiplayerSample;
+
+    enum class TestInputAction : uint8_t
+    {
+        MoveFwd,
+        MoveBack,
+        Jump,
+        Fire
+    };
+
+    class InputActionMapTests
+        : public LeakDetectionFixture
+    {
+    protected:
+        const StartingPointInput::InputEventNotificationId m_moveFwdEventId{ "move_fwd" };
+        const StartingPointInput::InputEventNotificationId m_moveBackEventId{ "move_back" };
+        const StartingPointInput::InputEventNotificationId m_jumpEventId{ "jump" };
+        const StartingPointInput::InputEventNotificationId m_fireEventId{ "firePrimaryWeapon" };
+    };
+
+    TEST_F(InputActionMapTests, TryGetAction_RoutesEveryBindingToItsAction)
+    {
+        const InputActionMap<TestInputAction> inputActions
+        {
+            { m_moveFwdEventId, TestInputAction::MoveFwd },
+            { m_moveBackEventId, TestInputAction::MoveBack },
+            { m_jumpEventId, TestInputAction::Jump },
+            { m_fireEventId, TestInputAction::Fire },
+        };
+
+        EXPECT_GT(inputActions.GetSlotCount(), 0u);
+        ASSERT_EQ(inputActions.GetBindings().size(), 4u);
+        for (const InputActionBinding<TestInputAction>& binding : inputActions.GetBindings())
+        {
+            TestInputAction action = TestInputAction::MoveFwd;
+            EXPECT_TRUE(inputActions.TryGetAction(&binding.m_eventId, action));
+            EXPECT_EQ(action, binding.m_action);
+        }
+    }
+
+    TEST_F(InputActionMapTests, TryGetAction_IgnoresUnboundEvents)
+    {
+        const InputActionMap<TestInputAction> inputActions
+        {
+            { m_moveFwdEventId, TestInputAction::MoveFwd },
+            { m_jumpEventId, TestInputAction::Jump },
+        };
+
+        const StartingPointInput::InputEventNotificationId unboundEventId("unboundInputEvent");
+        TestInputAction action = TestInputAction::Fire;
+        EXPECT_FALSE(inputActions.TryGetAction(&m_moveBackEventId, action));
+        EXPECT_FALSE(inputActions.TryGetAction(&m_fireEventId, action));
+        EXPECT_FALSE(inputActions.TryGetAction(&unboundEventId, action));
+        EXPECT_FALSE(inputActions.TryGetAction(nullptr, action));
+        EXPECT_EQ(action, TestInputAction::Fire);
+    }
+}
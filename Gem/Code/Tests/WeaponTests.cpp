@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project. For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+
+#include <AzCore/Name/NameDictionary.h>
+#include <AzCore/UnitTest/TestTypes.h>
+#include <Source/Weapons/WeaponDefinitionLibrary.h>
+#include <Source/Weapons/WeaponGathers.h>
+
+namespace UnitTest
+{
+    using namespace MultiplayerSample;
+
+    class WeaponTests
+        : public LeakDetectionFixture
+    {
+    protected:
+        void SetUp() override
+        {
+            LeakDetectionFixture::SetUp();
+            AZ::NameDictionary::Create();
+        }
+
+        void TearDown() override
+        {
+            AZ::NameDictionary::Destroy();
+            LeakDetectionFixture::TearDown();
+        }
+
+        static WeaponParams MakeTraceParams()
+        {
+            WeaponParams weaponParams;
+            weaponParams.m_weaponType = WeaponType::Trace;
+            weaponParams.m_gatherParams.m_castDistance = 100.0f;
+            weaponParams.m_gatherParams.m_travelSpeed = 0.0f;
+            return weaponParams;
+        }
+    };
+
+    TEST_F(WeaponTests, ValidateDefinition_AcceptsUsableParams)
+    {
+        const AZ::Name definitionName("TestWeapon");
+        EXPECT_TRUE(WeaponDefinitionLibrary::ValidateDefinition(definitionName, MakeTraceParams()));
+
+        WeaponParams projectileParams = MakeTraceParams();
+        projectileParams.m_weaponType = WeaponType::Projectile;
+        projectileParams.m_gatherParams.m_travelSpeed = 50.0f;
+        EXPECT_TRUE(WeaponDefinitionLibrary::ValidateDefinition(definitionName, projectileParams));
+
+        // Definitions without a weapon type are kept for their parameters
+        WeaponParams untypedParams = MakeTraceParams();
+        untypedParams.m_weaponType = WeaponType::None;
+        EXPECT_TRUE(WeaponDefinitionLibrary::ValidateDefinition(definitionName, untypedParams));
+    }
+
+    TEST_F(WeaponTests, ValidateDefinition_RejectsUnusableParams)
+    {
+        const AZ::Name definitionName("TestWeapon");
+
+        WeaponParams noCastDistance = MakeTraceParams();
+        noCastDistance.m_gatherParams.m_castDistance = 0.0f;
+        EXPECT_FALSE(WeaponDefinitionLibrary::ValidateDefinition(definitionName, noCastDistance));
+
+        WeaponParams negativeTravelSpeed = MakeTraceParams();
+        negativeTravelSpeed.m_gatherParams.m_travelSpeed = -1.0f;
+        EXPECT_FALSE(WeaponDefinitionLibrary::ValidateDefinition(definitionName, negativeTravelSpeed));
+
+        WeaponParams stationaryProjectile = MakeTraceParams();
+        stationaryProjectile.m_weaponType = WeaponType::Projectile;
+        EXPECT_FALSE(WeaponDefinitionLibrary::ValidateDefinition(definitionName, stationaryProjectile));
+    }
+
+    TEST_F(WeaponTests, GetMultitraceSegmentCount_UsesOneSegmentForStraightShots)
+    {
+        EXPECT_EQ(GetMultitraceSegmentCount(1.0f / 30.0f, AZ::Vector3::CreateZero()), 1u);
+        EXPECT_EQ(GetMultitraceSegmentCount(1.0f, AZ::Vector3::CreateZero()), 1u);
+
+        // Gravity barely bends the arc over a single tick
+        EXPECT_EQ(GetMultitraceSegmentCount(1.0f / 30.0f, AZ::Vector3(0.0f, 0.0f, -9.81f)), 1u);
+    }
+
+    TEST_F(WeaponTests, GetMultitraceSegmentCount_SplitsCurvedShotsWithinTheSegmentLimit)
+    {
+        const AZ::Vector3 gravity(0.0f, 0.0f, -9.81f);
+        const uint32_t shortSegments = GetMultitraceSegmentCount(0.5f, gravity);
+        const uint32_t longSegments = GetMultitraceSegmentCount(1.0f, gravity);
+        EXPECT_GT(longSegments, 1u);
+        EXPECT_GE(longSegments, shortSegments);
+        EXPECT_EQ(GetMultitraceSegmentCount(1000.0f, gravity), MaxMultitraceSegments);
+    }
+}
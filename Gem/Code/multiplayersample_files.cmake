@@ -19,8 +19,14 @@ set(FILES
 
     Source/Components/AttachPlayerWeaponComponent.h
     Source/Components/AttachPlayerWeaponComponent.cpp
+    Source/Components/BoneIndexCache.cpp
+    Source/Components/BoneIndexCache.h
+    Source/Components/BotMovementBatch.cpp
+    Source/Components/BotMovementBatch.h
     Source/Components/ExampleFilteredEntityComponent.h
     Source/Components/ExampleFilteredEntityComponent.cpp
+    Source/Components/InputActionMap.cpp
+    Source/Components/InputActionMap.h
     Source/Components/NetworkAiComponent.cpp
     Source/Components/NetworkAiComponent.h
     Source/Components/NetworkAnimationComponent.cpp
@@ -41,6 +47,10 @@ set(FILES
     Source/Components/NetworkSimplePlayerCameraComponent.h
     Source/Components/OcclusionFilteredEntityComponent.h
     Source/Components/OcclusionFilteredEntityComponent.cpp
+    Source/Components/PredictionStats.cpp
+    Source/Components/PredictionStats.h
+    Source/Components/SpatialInterestFilterComponent.cpp
+    Source/Components/SpatialInterestFilterComponent.h
     Source/Components/PerfTest/NetworkPrefabSpawnerComponent.cpp
     Source/Components/PerfTest/NetworkPrefabSpawnerComponent.h
     Source/Components/PerfTest/NetworkRandomImpulseComponent.cpp
@@ -64,6 +74,8 @@ set(FILES
     Source/Components/Multiplayer/GemSpawnerComponent.h
     Source/Components/Multiplayer/MatchPlayerCoinsComponent.cpp
     Source/Components/Multiplayer/MatchPlayerCoinsComponent.h
+    Source/Components/Multiplayer/NetworkEntityPool.cpp
+    Source/Components/Multiplayer/NetworkEntityPool.h
     Source/Components/Multiplayer/PlayerArmorComponent.cpp
     Source/Components/Multiplayer/PlayerArmorComponent.h
     Source/Components/Multiplayer/PlayerCoinCollectorComponent.cpp
@@ -86,17 +98,39 @@ set(FILES
 
     Source/Weapons/BaseWeapon.cpp
     Source/Weapons/BaseWeapon.h
+    Source/Weapons/HitConfirmBatch.cpp
+    Source/Weapons/HitConfirmBatch.h
     Source/Weapons/IWeapon.h
+    Source/Weapons/ProjectileStore.cpp
+    Source/Weapons/ProjectileStore.h
     Source/Weapons/ProjectileWeapon.cpp
     Source/Weapons/ProjectileWeapon.h
+    Source/Weapons/RewindSyncScope.cpp
+    Source/Weapons/RewindSyncScope.h
     Source/Weapons/TraceWeapon.cpp
     Source/Weapons/TraceWeapon.h
+    Source/Weapons/WeaponDefinitionLibrary.cpp
+    Source/Weapons/WeaponDefinitionLibrary.h
+    Source/Weapons/WeaponFireRecorder.cpp
+    Source/Weapons/WeaponFireRecorder.h
     Source/Weapons/WeaponGathers.cpp
     Source/Weapons/WeaponGathers.h
+    Source/Weapons/WeaponQueryBatch.cpp
+    Source/Weapons/WeaponQueryBatch.h
+    Source/Weapons/WeaponSimulationLod.cpp
+    Source/Weapons/WeaponSimulationLod.h
     Source/Weapons/WeaponTypes.cpp
     Source/Weapons/WeaponTypes.h
     Source/Weapons/SceneQuery.cpp
     Source/Weapons/SceneQuery.h
+    Source/Weapons/SceneQueryHitBuffer.cpp
+    Source/Weapons/SceneQueryHitBuffer.h
+    Source/Weapons/SceneQueryShapeCache.cpp
+    Source/Weapons/SceneQueryShapeCache.h
+    Source/Weapons/SimulatedBodyNetData.cpp
+    Source/Weapons/SimulatedBodyNetData.h
+    Source/Weapons/SurfaceTypeRegistry.cpp
+    Source/Weapons/SurfaceTypeRegistry.h
     Source/Effects/GameEffect.cpp
     Source/Effects/GameEffect.h
     Source/MultiplayerSampleSystemComponent.cpp
@@ -0,0 +1,13 @@
+#
+# Copyright (c) Contributors to the Open 3D Engine Project
+#
+# SPDX-License-Identifier: Apache-2.0 OR MIT
+#
+#
+
+set(FILES
+    Tests/MultiplayerSampleTest.cpp
+    Tests/HitConfirmBatchTests.cpp
+    Tests/InputActionMapTests.cpp
+    Tests/WeaponTests.cpp
+)